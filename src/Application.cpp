@@ -41,6 +41,7 @@
 #include "KonsoleSettings.h"
 #include "ViewManager.h"
 #include "SessionController.h"
+#include "StartupTrace.h"
 #include "WindowSystemInfo.h"
 
 using namespace Konsole;
@@ -165,7 +166,9 @@ MainWindow *Application::newMainWindow()
 {
     WindowSystemInfo::HAVE_TRANSPARENCY = !m_parser->isSet(QStringLiteral("notransparency"));
 
+    StartupTrace::beginPhase("MainWindow");
     auto window = new MainWindow();
+    StartupTrace::endPhase("MainWindow");
 
     connect(window, &Konsole::MainWindow::newWindowRequest, this,
             &Konsole::Application::createWindow);
@@ -222,14 +225,18 @@ int Application::newInstance()
     }
 
     // select profile to use
+    StartupTrace::beginPhase("ProfileManager");
     Profile::Ptr baseProfile = processProfileSelectArgs();
+    StartupTrace::endPhase("ProfileManager");
 
     // process various command-line options which cause a property of the
     // selected profile to be changed
     Profile::Ptr newProfile = processProfileChangeArgs(baseProfile);
 
     // create new session
+    StartupTrace::beginPhase("MainWindow::createSession");
     Session *session = window->createSession(newProfile, QString());
+    StartupTrace::endPhase("MainWindow::createSession");
 
     if (m_parser->isSet(QStringLiteral("noclose"))) {
         session->setAutoClose(false);
@@ -604,5 +611,8 @@ void Application::finalizeNewMainWindow(MainWindow *window)
     if (!KonsoleSettings::saveGeometryOnExit()) {
         window->resize(window->sizeHint());
     }
+
+    StartupTrace::beginPhase("MainWindow::show");
     window->show();
+    StartupTrace::endPhase("MainWindow::show");
 }
@@ -0,0 +1,103 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "BlinkTicker.h"
+
+// Qt
+#include <QApplication>
+#include <QTimer>
+#include <QWidget>
+
+using namespace Konsole;
+
+BlinkTicker *BlinkTicker::forWidget(QWidget *widget)
+{
+    QWidget *window = widget->window();
+    BlinkTicker *ticker = window->findChild<BlinkTicker *>(QString(), Qt::FindDirectChildrenOnly);
+    if (ticker == nullptr) {
+        ticker = new BlinkTicker(window);
+    }
+    return ticker;
+}
+
+BlinkTicker::BlinkTicker(QWidget *window) :
+    QObject(window),
+    _textTimer(new QTimer(this)),
+    _cursorTimer(new QTimer(this))
+{
+    _textTimer->setInterval(TEXT_BLINK_DELAY);
+    connect(_textTimer, &QTimer::timeout, this, &Konsole::BlinkTicker::textTick);
+
+    _cursorTimer->setInterval(QApplication::cursorFlashTime() / 2);
+    connect(_cursorTimer, &QTimer::timeout, this, &Konsole::BlinkTicker::cursorTick);
+}
+
+void BlinkTicker::subscribeText(QObject *subscriber, bool subscribe)
+{
+    if (subscribe) {
+        connect(subscriber, &QObject::destroyed, this, &Konsole::BlinkTicker::subscriberDestroyed, Qt::UniqueConnection);
+        _textSubscribers.insert(subscriber);
+    } else {
+        _textSubscribers.remove(subscriber);
+    }
+    updateTimers();
+}
+
+void BlinkTicker::subscribeCursor(QObject *subscriber, bool subscribe)
+{
+    if (subscribe) {
+        connect(subscriber, &QObject::destroyed, this, &Konsole::BlinkTicker::subscriberDestroyed, Qt::UniqueConnection);
+        _cursorSubscribers.insert(subscriber);
+    } else {
+        _cursorSubscribers.remove(subscriber);
+    }
+    updateTimers();
+}
+
+void BlinkTicker::restartCursorPhase()
+{
+    if (_cursorTimer->isActive()) {
+        _cursorTimer->start();
+    }
+}
+
+void BlinkTicker::subscriberDestroyed(QObject *subscriber)
+{
+    _textSubscribers.remove(subscriber);
+    _cursorSubscribers.remove(subscriber);
+    updateTimers();
+}
+
+void BlinkTicker::updateTimers()
+{
+    // only keep a timer running while somebody is interested in it, so that
+    // windows without anything to blink never wake up
+    if (_textSubscribers.isEmpty()) {
+        _textTimer->stop();
+    } else if (!_textTimer->isActive()) {
+        _textTimer->start();
+    }
+
+    if (_cursorSubscribers.isEmpty()) {
+        _cursorTimer->stop();
+    } else if (!_cursorTimer->isActive()) {
+        _cursorTimer->start();
+    }
+}
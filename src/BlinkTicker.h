@@ -0,0 +1,88 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+#ifndef BLINKTICKER_H
+#define BLINKTICKER_H
+
+// Qt
+#include <QObject>
+#include <QSet>
+
+class QTimer;
+
+namespace Konsole {
+/**
+ * Drives text and cursor blinking for all terminal displays inside
+ * one top-level window.
+ *
+ * Instead of each TerminalDisplay running its own pair of timers, displays
+ * subscribe to the ticker of their window with subscribeText() and
+ * subscribeCursor() while they actually need to blink (i.e. they are visible,
+ * focused and have something to blink) and unsubscribe otherwise.  The
+ * underlying timers only run while there is at least one subscriber, so an
+ * idle window generates no timer wakeups at all.
+ */
+class BlinkTicker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Returns the ticker shared by all displays in the top-level window
+     * of @p widget, creating it if necessary.  The ticker is owned by
+     * that window.
+     */
+    static BlinkTicker *forWidget(QWidget *widget);
+
+    /** Adds or removes @p subscriber from the text blink subscribers. */
+    void subscribeText(QObject *subscriber, bool subscribe);
+    /** Adds or removes @p subscriber from the cursor blink subscribers. */
+    void subscribeCursor(QObject *subscriber, bool subscribe);
+
+    /**
+     * Restarts the cursor blink phase, so that the next cursorTick() is a
+     * full interval away.  Used to keep the cursor visible while typing.
+     */
+    void restartCursorPhase();
+
+    /** The delay in milliseconds between text blink ticks */
+    static const int TEXT_BLINK_DELAY = 500;
+
+Q_SIGNALS:
+    /** Emitted every TEXT_BLINK_DELAY milliseconds while there are text subscribers */
+    void textTick();
+    /** Emitted every half cursor flash time while there are cursor subscribers */
+    void cursorTick();
+
+private Q_SLOTS:
+    void subscriberDestroyed(QObject *subscriber);
+
+private:
+    explicit BlinkTicker(QWidget *window);
+
+    void updateTimers();
+
+    QTimer *_textTimer;
+    QTimer *_cursorTimer;
+    QSet<QObject *> _textSubscribers;
+    QSet<QObject *> _cursorSubscribers;
+};
+}
+
+#endif // BLINKTICKER_H
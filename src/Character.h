@@ -56,9 +56,19 @@ const RenditionFlags RE_OVERLINE       = (1 << 10);
  * Unfortunately, the triple and quadruple dash lines (┄┅┆┇┈┉┊┋) are too
  * detailed too be drawn cleanly at normal font scales without anti
  * -aliasing, so those are drawn as regular characters.
+ *
+ * The block elements ( U+2580 ~ U+259F, including the quadrants ) and the
+ * braille patterns ( U+2800 ~ U+28FF ) are drawn by konsole as well, so that
+ * they fill their cells exactly. See LineCharRenderer.
  */
 inline bool isSupportedLineChar(quint16 codePoint)
 {
+    if ((codePoint & 0xFF00) == 0x2800) { // Unicode block: Braille Patterns
+        return true;
+    }
+    if (0x2580 <= codePoint && codePoint <= 0x259F) { // Unicode block: Block Elements
+        return true;
+    }
     return (codePoint & 0xFF80) == 0x2500 // Unicode block: Mathematical Symbols - Box Drawing
            && !(0x2504 <= codePoint && codePoint <= 0x250B); // Triple and quadruple dash range
 }
@@ -23,6 +23,7 @@
 #include "ColorScheme.h"
 
 // Qt
+#include <QDataStream>
 #include <QPainter>
 
 // KDE
@@ -423,6 +424,50 @@ void ColorScheme::write(KConfig &config) const
     }
 }
 
+bool ColorScheme::read(QDataStream &stream)
+{
+    QString description;
+    QString wallpaper;
+    double opacity = 1.0;
+    bool blur = false;
+    stream >> description >> opacity >> blur >> wallpaper;
+
+    ColorEntry table[TABLE_COLORS];
+    RandomizationRange randomTable[TABLE_COLORS];
+    for (int i = 0; i < TABLE_COLORS; i++) {
+        stream >> table[i] >> randomTable[i].hue >> randomTable[i].saturation >> randomTable[i].value;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    _description = description;
+    _opacity = opacity;
+    _blur = blur;
+    setWallpaper(wallpaper);
+
+    for (int i = 0; i < TABLE_COLORS; i++) {
+        setColorTableEntry(i, table[i]);
+        if (!randomTable[i].isNull()) {
+            setRandomizationRange(i, randomTable[i].hue, randomTable[i].saturation, randomTable[i].value);
+        }
+    }
+
+    return true;
+}
+
+void ColorScheme::write(QDataStream &stream) const
+{
+    stream << _description << static_cast<double>(_opacity) << _blur << _wallpaper->path();
+
+    const RandomizationRange none;
+    for (int i = 0; i < TABLE_COLORS; i++) {
+        const RandomizationRange &range = _randomTable != nullptr ? _randomTable[i] : none;
+        stream << colorTable()[i] << range.hue << range.saturation << range.value;
+    }
+}
+
 void ColorScheme::writeColorEntry(KConfig &config, int index) const
 {
     KConfigGroup configGroup = config.group(colorNameForIndex(index));
@@ -30,6 +30,7 @@
 #include "CharacterColor.h"
 
 class KConfig;
+class QDataStream;
 class QPixmap;
 class QPainter;
 
@@ -95,6 +96,14 @@ public:
     /** Writes the color scheme to the specified configuration source */
     void write(KConfig &config) const;
 
+    /**
+     * Reads the color scheme from a binary @p stream written by
+     * write(QDataStream &).  Returns false if the stream ended early.
+     */
+    bool read(QDataStream &stream);
+    /** Writes the color scheme to a binary @p stream, as used for caching */
+    void write(QDataStream &stream) const;
+
     /** Sets a single entry within the color palette. */
     void setColorTableEntry(int index, const ColorEntry &entry);
 
@@ -23,8 +23,10 @@
 #include "ColorSchemeManager.h"
 
 #include "konsoledebug.h"
+#include "StartupCache.h"
 
 // Qt
+#include <QDataStream>
 #include <QIODevice>
 #include <QFileInfo>
 #include <QFile>
@@ -91,10 +93,25 @@ bool ColorSchemeManager::loadColorScheme(const QString &filePath)
 
     QFileInfo info(filePath);
 
-    KConfig config(filePath, KConfig::NoGlobals);
     auto scheme = new ColorScheme();
     scheme->setName(info.completeBaseName());
-    scheme->read(config);
+
+    // use the scheme read before, unless the file changed since
+    StartupCache *cache = StartupCache::instance();
+    QDataStream cached(cache->data(filePath));
+    cached.setVersion(QDataStream::Qt_5_6);
+    if (cached.atEnd() || !scheme->read(cached)) {
+        {
+            KConfig config(filePath, KConfig::NoGlobals);
+            scheme->read(config);
+        }
+
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_6);
+        scheme->write(stream);
+        cache->setData(filePath, data);
+    }
 
     if (scheme->name().isEmpty()) {
         qCDebug(KonsoleDebug) << "Color scheme in" << filePath
@@ -123,7 +140,7 @@ QStringList ColorSchemeManager::listColorSchemes()
     colorschemes.reserve(dirs.size());
 
     Q_FOREACH (const QString &dir, dirs) {
-        const QStringList fileNames = QDir(dir).entryList(QStringList() << QStringLiteral("*.colorscheme"));
+        const QStringList fileNames = StartupCache::instance()->entryList(dir, QStringLiteral("*.colorscheme"));
         Q_FOREACH (const QString &file, fileNames) {
             colorschemes.append(dir + QLatin1Char('/') + file);
         }
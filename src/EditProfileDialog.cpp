@@ -37,6 +37,7 @@
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QDialog>
+#include <QStandardPaths>
 // KDE
 #include <KCodecAction>
 
@@ -55,6 +56,7 @@
 #include "KeyboardTranslator.h"
 #include "KeyboardTranslatorManager.h"
 #include "ProfileManager.h"
+#include "SessionLogger.h"
 #include "ShellCommand.h"
 #include "WindowSystemInfo.h"
 #include "Shortcut_p.h"
@@ -1341,6 +1343,10 @@ void EditProfileDialog::setupAdvancedPage(const Profile::Ptr profile)
             _ui->enableBidiRenderingButton, Profile::BidiRenderingEnabled,
             SLOT(togglebidiRendering(bool))
         },
+        {
+            _ui->outputLogCompressedButton, Profile::OutputLogCompressed,
+            SLOT(toggleOutputLogCompressed(bool))
+        },
         { nullptr, Profile::Property(0), nullptr }
     };
     setupCheckBoxes(options, profile);
@@ -1387,6 +1393,50 @@ void EditProfileDialog::setupAdvancedPage(const Profile::Ptr profile)
     connect(codecAction, static_cast<void (KCodecAction::*)(QTextCodec *)>(&KCodecAction::triggered), this, &Konsole::EditProfileDialog::setDefaultCodec);
 
     _ui->characterEncodingLabel->setText(profile->defaultEncoding());
+
+    // output log options
+    _ui->outputLogModeCombo->setCurrentIndex(profile->outputLogMode());
+    _ui->outputLogDirectoryEdit->setText(profile->outputLogDirectory());
+    _ui->outputLogDirectoryEdit->setPlaceholderText(
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/logs"));
+    _ui->outputLogDirectoryEdit->setClearButtonEnabled(true);
+    _ui->outputLogMaxSizeSpinner->setValue(profile->property<int>(Profile::OutputLogMaxSize));
+    _ui->outputLogMaxSizeSpinner->setSuffix(ki18ncp("Unit of data size", " MiB", " MiB"));
+    _ui->outputLogMaxSizeSpinner->setSpecialValueText(i18nc("Output log file size", "No limit"));
+    _ui->outputLogRotationIntervalSpinner->setValue(profile->property<int>(Profile::OutputLogRotationInterval));
+    _ui->outputLogRotationIntervalSpinner->setSuffix(ki18ncp("Unit of time", " minute", " minutes"));
+    _ui->outputLogRotationIntervalSpinner->setSpecialValueText(i18nc("Output log file age", "Never"));
+    _ui->outputLogCompressedButton->setVisible(SessionLogger::compressionSupported());
+
+    connect(_ui->outputLogModeCombo, static_cast<void (KComboBox::*)(int)>(&KComboBox::activated), this, &Konsole::EditProfileDialog::setOutputLogMode);
+    connect(_ui->outputLogDirectoryEdit, &QLineEdit::textChanged, this, &Konsole::EditProfileDialog::outputLogDirectoryChanged);
+    connect(_ui->outputLogMaxSizeSpinner, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &Konsole::EditProfileDialog::outputLogMaxSizeChanged);
+    connect(_ui->outputLogRotationIntervalSpinner, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &Konsole::EditProfileDialog::outputLogRotationIntervalChanged);
+}
+
+void EditProfileDialog::setOutputLogMode(int mode)
+{
+    updateTempProfileProperty(Profile::OutputLogMode, mode);
+}
+
+void EditProfileDialog::outputLogDirectoryChanged(const QString &directory)
+{
+    updateTempProfileProperty(Profile::OutputLogDirectory, directory);
+}
+
+void EditProfileDialog::outputLogMaxSizeChanged(int size)
+{
+    updateTempProfileProperty(Profile::OutputLogMaxSize, size);
+}
+
+void EditProfileDialog::outputLogRotationIntervalChanged(int minutes)
+{
+    updateTempProfileProperty(Profile::OutputLogRotationInterval, minutes);
+}
+
+void EditProfileDialog::toggleOutputLogCompressed(bool compressed)
+{
+    updateTempProfileProperty(Profile::OutputLogCompressed, compressed);
 }
 
 void EditProfileDialog::setDefaultCodec(QTextCodec *codec)
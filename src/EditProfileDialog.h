@@ -192,6 +192,11 @@ private Q_SLOTS:
     void customCursorColor();
     void customCursorColorChanged(const QColor &);
     void setDefaultCodec(QTextCodec *);
+    void setOutputLogMode(int);
+    void outputLogDirectoryChanged(const QString &);
+    void outputLogMaxSizeChanged(int);
+    void outputLogRotationIntervalChanged(int);
+    void toggleOutputLogCompressed(bool);
 
     // apply the first previewed changes stored up by delayedPreview()
     void delayedPreviewActivate();
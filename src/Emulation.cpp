@@ -43,7 +43,12 @@ Emulation::Emulation() :
     _bracketedPasteMode(false),
     _bulkTimer1(new QTimer(this)),
     _bulkTimer2(new QTimer(this)),
-    _imageSizeInitialized(false)
+    _imageSizeInitialized(false),
+    _statistics(),
+    _utf8Code(0),
+    _utf8Minimum(0),
+    _utf8Remaining(0),
+    _utf8HeaderDone(false)
 {
     // create screens with a default size
     _screen[0] = new Screen(40, 80);
@@ -83,6 +88,7 @@ void Emulation::bracketedPasteModeChanged(bool bracketedPasteMode)
 ScreenWindow *Emulation::createWindow()
 {
     auto window = new ScreenWindow(_currentScreen);
+    window->setStatistics(&_statistics);
     _windows << window;
 
     connect(window, &Konsole::ScreenWindow::selectionChanged, this,
@@ -158,6 +164,9 @@ void Emulation::setCodec(const QTextCodec *codec)
         delete _decoder;
         _decoder = _codec->makeDecoder();
 
+        _utf8Remaining = 0;
+        _utf8HeaderDone = false;
+
         emit useUtf8Request(utf8());
     } else {
         setCodec(LocaleCodec);
@@ -236,15 +245,23 @@ void Emulation::sendMouseEvent(int /*buttons*/, int /*column*/, int /*row*/, int
 
 void Emulation::receiveData(const char *text, int length)
 {
+    PipelineStatistics::StageTimer timer(&_statistics, PipelineStatistics::Parse);
+
     emit stateSet(NOTIFYACTIVITY);
 
     bufferedUpdate();
 
-    QString unicodeText = _decoder->toUnicode(text, length);
-
     //send characters to terminal emulator
-    for (auto &&i : unicodeText) {
-        receiveChar(i.unicode());
+    if (utf8()) {
+        // the common case, which is decoded without copying the data
+        _statistics.add(PipelineStatistics::CharsParsed, receiveUtf8(text, length));
+    } else {
+        QString unicodeText = _decoder->toUnicode(text, length);
+        _statistics.add(PipelineStatistics::CharsParsed, unicodeText.length());
+
+        for (auto &&i : unicodeText) {
+            receiveChar(i.unicode());
+        }
     }
 
     //look for z-modem indicator
@@ -259,6 +276,78 @@ void Emulation::receiveData(const char *text, int length)
     }
 }
 
+void Emulation::receiveUtf8Error()
+{
+    // like QTextDecoder, an invalid sequence is replaced by one replacement character
+    _utf8Remaining = 0;
+    _utf8HeaderDone = true;
+    receiveChar(QChar::ReplacementCharacter);
+}
+
+int Emulation::receiveUtf8(const char *text, int length)
+{
+    int units = 0;
+
+    for (int i = 0; i < length; i++) {
+        const uchar byte = static_cast<uchar>(text[i]);
+
+        if (_utf8Remaining > 0) {
+            if ((byte & 0xC0) == 0x80) {
+                _utf8Code = (_utf8Code << 6) | (byte & 0x3F);
+                if (--_utf8Remaining > 0) {
+                    continue;
+                }
+
+                if (_utf8Code < _utf8Minimum || _utf8Code > 0x10FFFF
+                        || QChar::isSurrogate(_utf8Code)) {
+                    // overlong encodings, surrogates and characters out of range
+                    receiveUtf8Error();
+                    units++;
+                } else if (_utf8Code == 0xFEFF && !_utf8HeaderDone) {
+                    // skip the byte order mark
+                    _utf8HeaderDone = true;
+                } else if (QChar::requiresSurrogates(_utf8Code)) {
+                    receiveChar(QChar::highSurrogate(_utf8Code));
+                    receiveChar(QChar::lowSurrogate(_utf8Code));
+                    units += 2;
+                } else {
+                    receiveChar(_utf8Code);
+                    units++;
+                }
+                _utf8HeaderDone = true;
+                continue;
+            }
+
+            // the sequence was cut short, the byte is decoded on its own
+            receiveUtf8Error();
+            units++;
+        }
+
+        if (byte < 0x80) {
+            _utf8HeaderDone = true;
+            receiveChar(byte);
+            units++;
+        } else if ((byte & 0xE0) == 0xC0) {
+            _utf8Code = byte & 0x1F;
+            _utf8Minimum = 0x80;
+            _utf8Remaining = 1;
+        } else if ((byte & 0xF0) == 0xE0) {
+            _utf8Code = byte & 0x0F;
+            _utf8Minimum = 0x800;
+            _utf8Remaining = 2;
+        } else if ((byte & 0xF8) == 0xF0) {
+            _utf8Code = byte & 0x07;
+            _utf8Minimum = 0x10000;
+            _utf8Remaining = 3;
+        } else {
+            receiveUtf8Error();
+            units++;
+        }
+    }
+
+    return units;
+}
+
 void Emulation::writeToStream(TerminalCharacterDecoder *decoder, int startLine, int endLine)
 {
     _currentScreen->writeLinesToStream(decoder, startLine, endLine);
@@ -270,11 +359,42 @@ int Emulation::lineCount() const
     return _currentScreen->getLines() + _currentScreen->getHistLines();
 }
 
+qint64 Emulation::outputLine() const
+{
+    return _screen[0]->scrolledOffLines() + _screen[0]->getCursorY();
+}
+
+void Emulation::writeOutputToStream(TerminalCharacterDecoder *decoder, qint64 startLine, qint64 endLine)
+{
+    const Screen *screen = _screen[0];
+
+    // the number of the oldest line in the history, which is line 0 of the screen
+    const qint64 firstLine = screen->scrolledOffLines() - screen->getHistLines();
+    const qint64 lastLine = screen->scrolledOffLines() + screen->getLines() - 1;
+
+    startLine = qMax(startLine, firstLine);
+    endLine = qMin(endLine, lastLine);
+    if (startLine > endLine) {
+        return;
+    }
+
+    screen->writeLinesToStream(decoder, static_cast<int>(startLine - firstLine),
+                               static_cast<int>(endLine - firstLine));
+}
+
+PipelineStatistics *Emulation::statistics()
+{
+    return &_statistics;
+}
+
 void Emulation::showBulk()
 {
     _bulkTimer1.stop();
     _bulkTimer2.stop();
 
+    _statistics.add(PipelineStatistics::Frames, 1);
+    _statistics.add(PipelineStatistics::LinesScrolled, _currentScreen->scrolledLines());
+
     emit outputChanged();
 
     _currentScreen->resetScrolledLines();
@@ -286,6 +406,10 @@ void Emulation::bufferedUpdate()
     static const int BULK_TIMEOUT1 = 10;
     static const int BULK_TIMEOUT2 = 40;
 
+    if (_bulkTimer1.isActive()) {
+        _statistics.add(PipelineStatistics::FramesCoalesced, 1);
+    }
+
     _bulkTimer1.setSingleShot(true);
     _bulkTimer1.start(BULK_TIMEOUT1);
     if (!_bulkTimer2.isActive()) {
@@ -30,6 +30,7 @@
 
 // Konsole
 #include "konsoleprivate_export.h"
+#include "PipelineStatistics.h"
 
 class QKeyEvent;
 
@@ -137,6 +138,13 @@ public:
      */
     int lineCount() const;
 
+    /**
+     * Returns the statistics collected for the output of this emulation.
+     * They are shared with the pty feeding the emulation and with the views
+     * displaying it.
+     */
+    PipelineStatistics *statistics();
+
     /**
      * Sets the history store used by this emulation.  When new lines
      * are added to the output, older lines at the top of the screen are transferred to a history
@@ -164,6 +172,23 @@ public:
      */
     virtual void writeToStream(TerminalCharacterDecoder *decoder, int startLine, int endLine);
 
+    /**
+     * Returns the number of the line of output which the cursor is on.
+     *
+     * Lines of output are numbered from 0 in the order they were written
+     * to the primary screen, counting those which the history did not keep,
+     * so the number of a line never changes.  The alternate screen used by
+     * full screen programs is not numbered.
+     */
+    qint64 outputLine() const;
+
+    /**
+     * Copies the lines of output from @p startLine to @p endLine, numbered
+     * as for outputLine(), into @p decoder.  Lines which are no longer in
+     * the history are skipped.
+     */
+    void writeOutputToStream(TerminalCharacterDecoder *decoder, qint64 startLine, qint64 endLine);
+
     /** Returns the codec used to decode incoming characters.  See setCodec() */
     const QTextCodec *codec() const
     {
@@ -251,7 +276,8 @@ public Q_SLOTS:
     /**
      * Processes an incoming stream of characters.  receiveData() decodes the incoming
      * character buffer using the current codec(), and then calls receiveChar() for
-     * each unicode character in the resulting buffer.
+     * each unicode character in the resulting buffer.  UTF-8 is decoded in place,
+     * without copying @p text, so that it can be reused as soon as this returns.
      *
      * receiveData() also starts a timer which causes the outputChanged() signal
      * to be emitted when it expires.  The timer allows multiple updates in quick
@@ -494,11 +520,23 @@ private Q_SLOTS:
 private:
     Q_DISABLE_COPY(Emulation)
 
+    // decodes UTF-8 straight into receiveChar(), returns the number of
+    // UTF-16 code units passed on
+    int receiveUtf8(const char *text, int length);
+    void receiveUtf8Error();
+
     bool _usesMouse;
     bool _bracketedPasteMode;
     QTimer _bulkTimer1;
     QTimer _bulkTimer2;
     bool _imageSizeInitialized;
+    PipelineStatistics _statistics;
+
+    // the state of receiveUtf8() between blocks of data
+    uint _utf8Code;          // the bits of the character decoded so far
+    uint _utf8Minimum;       // the smallest character which needs this many bytes
+    int _utf8Remaining;      // the number of continuation bytes still expected
+    bool _utf8HeaderDone;    // a byte order mark is only skipped at the start
 };
 }
 
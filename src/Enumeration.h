@@ -119,6 +119,18 @@ public:
         NoBell = 3
     };
 
+    /**
+     * This enum describes what is written to the output log of a session.
+     */
+    enum OutputLogModeEnum {
+        /** Nothing is logged. */
+        NoOutputLog = 0,
+        /** The data received from the terminal is logged as it is. */
+        RawOutputLog = 1,
+        /** The received text is logged without escape sequences. */
+        TextOutputLog = 2
+    };
+
     /**
      * This enum describes the strategies available for searching
      * through the session's output.
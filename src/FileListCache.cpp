@@ -0,0 +1,217 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "FileListCache.h"
+
+// Qt
+#include <QDir>
+#include <QRunnable>
+
+// KDE
+#include <KDirWatch>
+
+using namespace Konsole;
+
+namespace {
+// lists a directory in a thread of the cache's thread pool
+class ListDirectoryJob : public QRunnable
+{
+public:
+    ListDirectoryJob(FileListCache *cache, const QString &path, int changeCount) :
+        _cache(cache),
+        _path(path),
+        _changeCount(changeCount)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        const QDir dir(_path);
+        const QString canonicalPath = dir.canonicalPath();
+
+        QSet<QString> files;
+        if (!canonicalPath.isEmpty()) {
+            files = dir.entryList(QDir::Files).toSet();
+        }
+
+        QMetaObject::invokeMethod(_cache, "listingFinished", Qt::QueuedConnection,
+                                  Q_ARG(QString, _path), Q_ARG(QString, canonicalPath),
+                                  Q_ARG(QSet<QString>, files), Q_ARG(int, _changeCount));
+    }
+
+private:
+    FileListCache *_cache;
+    QString _path;
+    int _changeCount;
+};
+}
+
+Q_GLOBAL_STATIC(FileListCache, theFileListCache)
+FileListCache *FileListCache::instance()
+{
+    return theFileListCache;
+}
+
+FileListCache::FileListCache() :
+    _canonicalPaths(QHash<QString, QString>()),
+    _entries(QHash<QString, Entry>()),
+    _pendingPaths(QSet<QString>()),
+    _watch(new KDirWatch(this)),
+    _lastRevision(0),
+    _useCounter(0)
+{
+    qRegisterMetaType<QSet<QString> >("QSet<QString>");
+
+    // a single thread is enough, and keeps a slow file system from
+    // occupying more than one
+    _threadPool.setMaxThreadCount(1);
+
+    connect(_watch, &KDirWatch::dirty, this, &Konsole::FileListCache::directoryChanged);
+    connect(_watch, &KDirWatch::deleted, this, &Konsole::FileListCache::directoryChanged);
+}
+
+FileListCache::~FileListCache()
+{
+    // the jobs refer to the cache
+    _threadPool.clear();
+    _threadPool.waitForDone();
+}
+
+FileListCache::Listing FileListCache::listing(const QString &path)
+{
+    Listing result;
+    result.revision = 0;
+
+    if (path.isEmpty()) {
+        return result;
+    }
+
+    const QString canonicalPath = _canonicalPaths.value(path);
+    auto iter = canonicalPath.isEmpty() ? _entries.end() : _entries.find(canonicalPath);
+    if (iter == _entries.end()) {
+        startListing(path);
+        return result;
+    }
+
+    iter->lastUsed = ++_useCounter;
+    if (!iter->upToDate) {
+        startListing(path);
+    }
+
+    return iter->listing;
+}
+
+QString FileListCache::canonicalPath(const QString &path) const
+{
+    return _canonicalPaths.value(path);
+}
+
+void FileListCache::startListing(const QString &path)
+{
+    if (_pendingPaths.contains(path)) {
+        return;
+    }
+    _pendingPaths.insert(path);
+
+    const QString canonicalPath = _canonicalPaths.value(path);
+    const int changeCount = _entries.contains(canonicalPath) ? _entries.value(canonicalPath).changeCount : 0;
+
+    _threadPool.start(new ListDirectoryJob(this, path, changeCount));
+}
+
+void FileListCache::listingFinished(const QString &path, const QString &canonicalPath,
+                                    const QSet<QString> &files, int changeCount)
+{
+    _pendingPaths.remove(path);
+
+    if (canonicalPath.isEmpty()) {
+        // the directory does not exist (any more)
+        _canonicalPaths.remove(path);
+        return;
+    }
+    _canonicalPaths.insert(path, canonicalPath);
+
+    auto iter = _entries.find(canonicalPath);
+    if (iter == _entries.end()) {
+        if (_entries.count() >= MAX_DIRECTORIES) {
+            evictLeastRecentlyUsed();
+        }
+
+        Entry entry;
+        entry.listing.canonicalPath = canonicalPath;
+        entry.listing.files = files;
+        entry.listing.revision = ++_lastRevision;
+        entry.upToDate = true;
+        entry.changeCount = 0;
+        entry.lastUsed = ++_useCounter;
+        _entries.insert(canonicalPath, entry);
+        _watch->addDir(canonicalPath);
+
+        emit listingChanged(canonicalPath);
+        return;
+    }
+
+    // if the directory changed again while it was being listed,
+    // the listing may already be out of date
+    iter->upToDate = (iter->changeCount == changeCount);
+
+    if (iter->listing.files != files) {
+        iter->listing.files = files;
+        iter->listing.revision = ++_lastRevision;
+        emit listingChanged(canonicalPath);
+    }
+}
+
+void FileListCache::directoryChanged(const QString &path)
+{
+    auto iter = _entries.find(path);
+    if (iter == _entries.end()) {
+        return;
+    }
+
+    // the directory is listed again when somebody asks for it
+    iter->upToDate = false;
+    iter->changeCount++;
+}
+
+void FileListCache::evictLeastRecentlyUsed()
+{
+    auto oldest = _entries.end();
+    for (auto iter = _entries.begin(); iter != _entries.end(); ++iter) {
+        if (oldest == _entries.end() || iter->lastUsed < oldest->lastUsed) {
+            oldest = iter;
+        }
+    }
+    if (oldest == _entries.end()) {
+        return;
+    }
+
+    const QString canonicalPath = oldest.key();
+    _watch->removeDir(canonicalPath);
+    _entries.erase(oldest);
+
+    for (auto iter = _canonicalPaths.begin(); iter != _canonicalPaths.end();) {
+        if (iter.value() == canonicalPath) {
+            iter = _canonicalPaths.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+#ifndef FILELISTCACHE_H
+#define FILELISTCACHE_H
+
+// Qt
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class KDirWatch;
+
+namespace Konsole {
+/**
+ * Caches the names of the files in directories, for use by FileFilter.
+ *
+ * Directories are listed in a background thread, so that slow or huge
+ * directories never block the GUI.  Listings are shared by everybody asking
+ * for the same directory, keyed by its canonical path, and are watched for
+ * changes.  A listing which changed is read again the next time it is asked
+ * for, and listingChanged() is emitted once the new listing is available.
+ */
+class KONSOLEPRIVATE_EXPORT FileListCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    FileListCache();
+    ~FileListCache() Q_DECL_OVERRIDE;
+
+    /** Returns the global cache. */
+    static FileListCache *instance();
+
+    /** The known files of a directory */
+    struct Listing {
+        /** The canonical path of the directory, or empty if it has not been listed yet */
+        QString canonicalPath;
+        /** The names of the files in the directory */
+        QSet<QString> files;
+        /**
+         * A number which is different for every listing the cache has made.
+         * Two listings with the same revision are the same.
+         */
+        int revision;
+    };
+
+    /**
+     * Returns the last known listing of the directory @p path without blocking.
+     *
+     * If the directory has not been listed yet or changed since it was last
+     * listed, it is listed in the background and listingChanged() is emitted
+     * when that is done.  Until then the previous, possibly empty, listing
+     * is returned.
+     */
+    Listing listing(const QString &path);
+
+    /**
+     * Returns the canonical path of the directory @p path as found when it was
+     * last listed, or an empty string if it has not been listed yet.
+     */
+    QString canonicalPath(const QString &path) const;
+
+    /** The maximum number of directories whose listing is kept */
+    static const int MAX_DIRECTORIES = 64;
+
+Q_SIGNALS:
+    /** Emitted when a new listing of @p canonicalPath is available. */
+    void listingChanged(const QString &canonicalPath);
+
+private Q_SLOTS:
+    void directoryChanged(const QString &path);
+    void listingFinished(const QString &path, const QString &canonicalPath,
+                         const QSet<QString> &files, int changeCount);
+
+private:
+    Q_DISABLE_COPY(FileListCache)
+
+    struct Entry {
+        Listing listing;
+        bool upToDate;
+        int changeCount; // number of change notifications received
+        qint64 lastUsed;
+    };
+
+    void startListing(const QString &path);
+    void evictLeastRecentlyUsed();
+
+    QHash<QString, QString> _canonicalPaths; // requested path -> canonical path
+    QHash<QString, Entry> _entries;          // canonical path -> entry
+    QSet<QString> _pendingPaths;             // requested paths being listed
+    KDirWatch *_watch;
+    QThreadPool _threadPool;
+    int _lastRevision;
+    qint64 _useCounter;
+};
+}
+
+#endif // FILELISTCACHE_H
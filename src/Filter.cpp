@@ -22,11 +22,14 @@
 
 #include "konsoledebug.h"
 
+// Standard
+#include <algorithm>
+#include <climits>
+
 // Qt
 #include <QAction>
 #include <QApplication>
 #include <QClipboard>
-#include <QDir>
 #include <QFile>
 #include <QMimeDatabase>
 #include <QString>
@@ -38,6 +41,7 @@
 #include <KRun>
 
 // Konsole
+#include "FileListCache.h"
 #include "Session.h"
 #include "TerminalCharacterDecoder.h"
 #include "konsole_wcwidth.h"
@@ -85,7 +89,9 @@ void FilterChain::process()
 {
     QListIterator<Filter *> iter(*this);
     while (iter.hasNext()) {
-        iter.next()->process();
+        Filter *filter = iter.next();
+        filter->prepareToProcess();
+        filter->process();
     }
 }
 
@@ -120,8 +126,16 @@ QList<Filter::HotSpot *> FilterChain::hotSpots() const
 }
 
 TerminalImageFilterChain::TerminalImageFilterChain() :
-    _buffer(nullptr),
-    _linePositions(nullptr)
+    _buffer(new QString()),
+    _linePositions(new QList<int>()),
+    _image(QVector<Character>()),
+    _lineProperties(QVector<LineProperty>()),
+    _lines(0),
+    _columns(0),
+    _processedImage(QVector<Character>()),
+    _processedColumns(0),
+    _segments(QVector<Segment>()),
+    _processedFilters(QList<Filter *>())
 {
 }
 
@@ -131,6 +145,23 @@ TerminalImageFilterChain::~TerminalImageFilterChain()
     delete _linePositions;
 }
 
+void TerminalImageFilterChain::removeFilter(Filter *filter)
+{
+    FilterChain::removeFilter(filter);
+
+    // a filter created later at the same address must not inherit the hotspots
+    const int index = _processedFilters.indexOf(filter);
+    if (index != -1) {
+        _processedFilters[index] = nullptr;
+    }
+}
+
+void TerminalImageFilterChain::clear()
+{
+    FilterChain::clear();
+    _processedFilters.clear();
+}
+
 void TerminalImageFilterChain::setImage(const Character * const image, int lines, int columns,
                                         const QVector<LineProperty> &lineProperties)
 {
@@ -138,55 +169,234 @@ void TerminalImageFilterChain::setImage(const Character * const image, int lines
         return;
     }
 
-    // reset all filters and hotspots
-    reset();
+    // keep a copy of the image, process() compares it with the image
+    // of the previous pass to find out which lines changed
+    _image.resize(lines * columns);
+    std::copy(image, image + lines * columns, _image.begin());
+    _lineProperties = lineProperties;
+    _lines = lines;
+    _columns = columns;
+}
+
+// the part of a character which determines the text it is decoded to
+static inline uint characterCode(const Character &character)
+{
+    return character.character | ((character.rendition & RE_EXTENDED_CHAR) != 0 ? 0x10000u : 0u);
+}
+
+QVector<TerminalImageFilterChain::Segment> TerminalImageFilterChain::findSegments() const
+{
+    QVector<Segment> segments;
+
+    int firstLine = 0;
+    uint hash = 0;
+    for (int line = 0; line < _lines; line++) {
+        const Character *characters = _image.constData() + line * _columns;
+        for (int column = 0; column < _columns; column++) {
+            hash = 31 * hash + characterCode(characters[column]);
+        }
+
+        const bool wrapped = (_lineProperties.value(line, LINE_DEFAULT) & LINE_WRAPPED) != 0;
+        if (!wrapped || line == _lines - 1) {
+            Segment segment;
+            segment.firstLine = firstLine;
+            segment.lineCount = line - firstLine + 1;
+            segment.endsWithNewline = !wrapped;
+            segment.hash = hash;
+            segments.append(segment);
+
+            firstLine = line + 1;
+            hash = 0;
+        }
+    }
+
+    return segments;
+}
+
+bool TerminalImageFilterChain::sameText(const Segment &segment, const Segment &processedSegment) const
+{
+    if (segment.hash != processedSegment.hash
+            || segment.lineCount != processedSegment.lineCount
+            || segment.endsWithNewline != processedSegment.endsWithNewline
+            || _columns != _processedColumns) {
+        return false;
+    }
+
+    const Character *characters = _image.constData() + segment.firstLine * _columns;
+    const Character *processedCharacters = _processedImage.constData() + processedSegment.firstLine * _columns;
+    const int count = segment.lineCount * _columns;
+    for (int i = 0; i < count; i++) {
+        if (characterCode(characters[i]) != characterCode(processedCharacters[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void TerminalImageFilterChain::decode(const QVector<Segment> &segments, const QVector<bool> &include)
+{
+    _buffer->clear();
+    _linePositions->clear();
 
     PlainTextDecoder decoder;
     decoder.setLeadingWhitespace(true);
     decoder.setTrailingWhitespace(true);
 
-    // setup new shared buffers for the filters to process on
-    auto newBuffer = new QString();
-    auto newLinePositions = new QList<int>();
-    setBuffer(newBuffer, newLinePositions);
+    QTextStream lineStream(_buffer);
+    decoder.begin(&lineStream);
 
-    // free the old buffers
-    delete _buffer;
-    delete _linePositions;
+    for (int i = 0; i < segments.count(); i++) {
+        const Segment &segment = segments.at(i);
+        const bool decodeSegment = include.isEmpty() || include.at(i);
 
-    _buffer = newBuffer;
-    _linePositions = newLinePositions;
+        for (int line = segment.firstLine; line < segment.firstLine + segment.lineCount; line++) {
+            // lines which are not decoded are left empty, so that positions in the
+            // buffer still map to the right lines
+            _linePositions->append(_buffer->length());
+            if (!decodeSegment) {
+                continue;
+            }
 
-    QTextStream lineStream(_buffer);
-    decoder.begin(&lineStream);
+            decoder.decodeLine(_image.constData() + line * _columns, _columns, LINE_DEFAULT);
 
-    for (int i = 0; i < lines; i++) {
-        _linePositions->append(_buffer->length());
-        decoder.decodeLine(image + i * columns, columns, LINE_DEFAULT);
-
-        // pretend that each line ends with a newline character.
-        // this prevents a link that occurs at the end of one line
-        // being treated as part of a link that occurs at the start of the next line
-        //
-        // the downside is that links which are spread over more than one line are not
-        // highlighted.
-        //
-        // TODO - Use the "line wrapped" attribute associated with lines in a
-        // terminal image to avoid adding this imaginary character for wrapped
-        // lines
-        if ((lineProperties.value(i, LINE_DEFAULT) & LINE_WRAPPED) == 0) {
-            lineStream << QLatin1Char('\n');
+            // pretend that each line ends with a newline character.
+            // this prevents a link that occurs at the end of one line
+            // being treated as part of a link that occurs at the start of the next line
+            //
+            // the downside is that links which are spread over more than one line are not
+            // highlighted.
+            if ((_lineProperties.value(line, LINE_DEFAULT) & LINE_WRAPPED) == 0) {
+                lineStream << QLatin1Char('\n');
+            }
         }
     }
     decoder.end();
 }
 
+static bool hotSpotLessThan(const Filter::HotSpot *a, const Filter::HotSpot *b)
+{
+    if (a->startLine() != b->startLine()) {
+        return a->startLine() < b->startLine();
+    }
+    return a->startColumn() < b->startColumn();
+}
+
+void TerminalImageFilterChain::process()
+{
+    if (empty()) {
+        return;
+    }
+
+    QVector<Segment> segments = findSegments();
+    QVector<int> segmentOfLine(_lines, 0);
+    for (int i = 0; i < segments.count(); i++) {
+        segments[i].hotSpots.resize(count());
+        for (int line = 0; line < segments.at(i).lineCount; line++) {
+            segmentOfLine[segments.at(i).firstLine + line] = i;
+        }
+    }
+
+    // find the segments whose text was already processed in the last pass,
+    // possibly at a different position because the view scrolled
+    QMultiHash<uint, int> processedSegments;
+    for (int i = 0; i < _segments.count(); i++) {
+        processedSegments.insert(_segments.at(i).hash, i);
+    }
+
+    QVector<int> processedIndex(segments.count(), -1);
+    QVector<bool> changed(segments.count(), true);
+    QVector<bool> claimed(_segments.count(), false);
+    for (int i = 0; i < segments.count(); i++) {
+        foreach (int candidate, processedSegments.values(segments.at(i).hash)) {
+            if (!claimed.at(candidate) && sameText(segments.at(i), _segments.at(candidate))) {
+                claimed[candidate] = true;
+                processedIndex[i] = candidate;
+                changed[i] = false;
+                break;
+            }
+        }
+    }
+
+    bool decodedChanged = false;
+    bool decodedAll = false;
+
+    for (int f = 0; f < count(); f++) {
+        Filter *filter = at(f);
+        const int processedFilter = _processedFilters.indexOf(filter);
+        const bool incremental = filter->prepareToProcess() && processedFilter != -1;
+
+        const QList<Filter::HotSpot *> previousHotSpots = filter->hotSpots();
+        QList<Filter::HotSpot *> hotSpots;
+
+        if (incremental) {
+            // move the hotspots of unchanged text along with it
+            for (int i = 0; i < segments.count(); i++) {
+                if (processedIndex.at(i) == -1) {
+                    continue;
+                }
+                const Segment &processed = _segments.at(processedIndex.at(i));
+                const int offset = segments.at(i).firstLine - processed.firstLine;
+                foreach (Filter::HotSpot *spot, processed.hotSpots.at(processedFilter)) {
+                    spot->translateLines(offset);
+                    hotSpots << spot;
+                }
+            }
+
+            if (!decodedChanged) {
+                decode(segments, changed);
+                decodedChanged = true;
+                decodedAll = false;
+            }
+        } else if (!decodedAll) {
+            decode(segments, QVector<bool>());
+            decodedAll = true;
+            decodedChanged = false;
+        }
+
+        // delete the hotspots of text which changed or moved out of view
+        const QSet<Filter::HotSpot *> keptHotSpots = hotSpots.toSet();
+        foreach (Filter::HotSpot *spot, previousHotSpots) {
+            if (!keptHotSpots.contains(spot)) {
+                delete spot;
+            }
+        }
+
+        filter->reset();
+        filter->setBuffer(_buffer, _linePositions);
+        filter->process();
+
+        hotSpots << filter->hotSpots();
+        std::sort(hotSpots.begin(), hotSpots.end(), hotSpotLessThan);
+
+        filter->reset();
+        foreach (Filter::HotSpot *spot, hotSpots) {
+            filter->addHotSpot(spot);
+            segments[segmentOfLine.value(spot->startLine())].hotSpots[f] << spot;
+        }
+    }
+
+    _segments = segments;
+    _processedImage = _image;
+    _processedColumns = _columns;
+    _processedFilters = *this;
+}
+
 Filter::Filter() :
     _hotspots(QMultiHash<int, HotSpot *>()),
     _hotspotList(QList<HotSpot *>()),
+    _intervals(QVector<QVector<Interval> >()),
+    _intervalsValid(false),
     _linePositions(nullptr),
-    _buffer(nullptr)
+    _buffer(nullptr),
+    _columnWidths(QVector<int>()),
+    _columnWidthsValid(false)
+{
+}
+
+bool Filter::prepareToProcess()
 {
+    return true;
 }
 
 Filter::~Filter()
@@ -201,12 +411,32 @@ void Filter::reset()
 {
     _hotspots.clear();
     _hotspotList.clear();
+    _intervalsValid = false;
 }
 
 void Filter::setBuffer(const QString *buffer, const QList<int> *linePositions)
 {
     _buffer = buffer;
     _linePositions = linePositions;
+
+    // the buffer may be the same object with new contents
+    _columnWidthsValid = false;
+}
+
+void Filter::updateColumnWidths()
+{
+    const int length = _buffer->length();
+    const QChar *characters = _buffer->constData();
+
+    _columnWidths.resize(length + 1);
+    int width = 0;
+    for (int i = 0; i < length; i++) {
+        _columnWidths[i] = width;
+        width += konsole_wcwidth(characters[i].unicode());
+    }
+    _columnWidths[length] = width;
+
+    _columnWidthsValid = true;
 }
 
 void Filter::getLineColumn(int position, int &startLine, int &startColumn)
@@ -214,22 +444,23 @@ void Filter::getLineColumn(int position, int &startLine, int &startColumn)
     Q_ASSERT(_linePositions);
     Q_ASSERT(_buffer);
 
-    for (int i = 0; i < _linePositions->count(); i++) {
-        int nextLine = 0;
-
-        if (i == _linePositions->count() - 1) {
-            nextLine = _buffer->length() + 1;
-        } else {
-            nextLine = _linePositions->value(i + 1);
-        }
+    if (_linePositions->isEmpty() || position < _linePositions->first() || position > _buffer->length()) {
+        return;
+    }
 
-        if (_linePositions->value(i) <= position && position < nextLine) {
-            startLine = i;
-            startColumn = string_width(buffer()->mid(_linePositions->value(i),
-                                                     position - _linePositions->value(i)));
-            return;
-        }
+    if (!_columnWidthsValid) {
+        updateColumnWidths();
     }
+
+    // the line containing the position is the last one starting at or before it.
+    // lines left empty in the buffer start at the same position as the next line,
+    // and are skipped like this as well
+    const QList<int>::const_iterator line = std::upper_bound(_linePositions->constBegin(),
+                                                             _linePositions->constEnd(),
+                                                             position) - 1;
+
+    startLine = line - _linePositions->constBegin();
+    startColumn = _columnWidths.at(position) - _columnWidths.at(*line);
 }
 
 const QString *Filter::buffer()
@@ -242,6 +473,7 @@ Filter::HotSpot::~HotSpot() = default;
 void Filter::addHotSpot(HotSpot *spot)
 {
     _hotspotList << spot;
+    _intervalsValid = false;
 
     for (int line = spot->startLine(); line <= spot->endLine(); line++) {
         _hotspots.insert(line, spot);
@@ -258,22 +490,61 @@ QList<Filter::HotSpot *> Filter::hotSpotsAtLine(int line) const
     return _hotspots.values(line);
 }
 
-Filter::HotSpot *Filter::hotSpotAt(int line, int column) const
+void Filter::updateIntervals() const
 {
-    QList<HotSpot *> hotspots = _hotspots.values(line);
+    for (auto &intervals : _intervals) {
+        intervals.clear();
+    }
 
-    foreach (HotSpot *spot, hotspots) {
-        if (spot->startLine() == line && spot->startColumn() > column) {
+    foreach (HotSpot *spot, _hotspotList) {
+        if (spot->startLine() < 0) {
             continue;
         }
-        if (spot->endLine() == line && spot->endColumn() < column) {
-            continue;
+        if (spot->endLine() >= _intervals.count()) {
+            _intervals.resize(spot->endLine() + 1);
         }
 
-        return spot;
+        for (int line = spot->startLine(); line <= spot->endLine(); line++) {
+            Interval interval;
+            interval.startColumn = (line == spot->startLine()) ? spot->startColumn() : 0;
+            interval.endColumn = (line == spot->endLine()) ? spot->endColumn() : INT_MAX;
+            interval.spot = spot;
+            _intervals[line] << interval;
+        }
     }
 
-    return nullptr;
+    for (auto &intervals : _intervals) {
+        std::sort(intervals.begin(), intervals.end(), [](const Interval &a, const Interval &b) {
+            return a.startColumn < b.startColumn;
+        });
+    }
+
+    _intervalsValid = true;
+}
+
+Filter::HotSpot *Filter::hotSpotAt(int line, int column) const
+{
+    if (!_intervalsValid) {
+        updateIntervals();
+    }
+
+    if (line < 0 || line >= _intervals.count()) {
+        return nullptr;
+    }
+
+    // the last interval starting at or before the column is the only
+    // one which can contain it
+    const QVector<Interval> &intervals = _intervals.at(line);
+    auto iter = std::upper_bound(intervals.constBegin(), intervals.constEnd(), column,
+                                 [](int value, const Interval &interval) {
+        return value < interval.startColumn;
+    });
+    if (iter == intervals.constBegin()) {
+        return nullptr;
+    }
+    --iter;
+
+    return iter->endColumn >= column ? iter->spot : nullptr;
 }
 
 Filter::HotSpot::HotSpot(int startLine, int startColumn, int endLine, int endColumn) :
@@ -320,8 +591,19 @@ void Filter::HotSpot::setType(Type type)
     _type = type;
 }
 
+void Filter::HotSpot::translateLines(int lines)
+{
+    _startLine += lines;
+    _endLine += lines;
+}
+
 RegExpFilter::RegExpFilter() :
-    _searchText(QRegularExpression())
+    _searchText(QRegularExpression()),
+    _regExpChanged(false),
+    _requiredLiterals(QStringList()),
+    _literalFirstCharacters(QBitArray()),
+    _singleCharacterLiterals(QBitArray()),
+    _literalsByPrefix(QHash<uint, QStringList>())
 {
 }
 
@@ -344,8 +626,20 @@ QStringList RegExpFilter::HotSpot::capturedTexts() const
 
 void RegExpFilter::setRegExp(const QRegularExpression &regExp)
 {
+    if (regExp == _searchText) {
+        return;
+    }
+
     _searchText = regExp;
     _searchText.optimize();
+    _regExpChanged = true;
+}
+
+bool RegExpFilter::prepareToProcess()
+{
+    const bool unchanged = !_regExpChanged;
+    _regExpChanged = false;
+    return unchanged;
 }
 
 QRegularExpression RegExpFilter::regExp() const
@@ -353,6 +647,71 @@ QRegularExpression RegExpFilter::regExp() const
     return _searchText;
 }
 
+void RegExpFilter::setRequiredLiterals(const QStringList &literals)
+{
+    _requiredLiterals.clear();
+    _literalFirstCharacters.clear();
+    _singleCharacterLiterals.clear();
+    _literalsByPrefix.clear();
+
+    foreach (const QString &literal, literals) {
+        if (literal.isEmpty()) {
+            // every position is a candidate
+            return;
+        }
+    }
+    if (literals.isEmpty()) {
+        return;
+    }
+
+    _requiredLiterals = literals;
+    _requiredLiterals.removeDuplicates();
+    _literalFirstCharacters.resize(0x10000);
+    _singleCharacterLiterals.resize(0x10000);
+
+    foreach (const QString &literal, _requiredLiterals) {
+        const ushort first = literal.at(0).unicode();
+        _literalFirstCharacters.setBit(first);
+        if (literal.length() == 1) {
+            _singleCharacterLiterals.setBit(first);
+        } else {
+            _literalsByPrefix[(uint(first) << 16) | literal.at(1).unicode()] << literal;
+        }
+    }
+}
+
+int RegExpFilter::findRequiredLiteral(const QString &text, int from) const
+{
+    const int length = text.length();
+    const ushort *characters = text.utf16();
+
+    for (int i = from; i < length; i++) {
+        const ushort character = characters[i];
+        if (!_literalFirstCharacters.testBit(character)) {
+            continue;
+        }
+        if (_singleCharacterLiterals.testBit(character)) {
+            return i;
+        }
+        if (i + 1 == length) {
+            break;
+        }
+
+        const auto iter = _literalsByPrefix.constFind((uint(character) << 16) | characters[i + 1]);
+        if (iter == _literalsByPrefix.constEnd()) {
+            continue;
+        }
+        foreach (const QString &literal, *iter) {
+            if (literal.length() <= length - i
+                && QStringRef(&text, i, literal.length()) == literal) {
+                return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
 void RegExpFilter::process()
 {
     const QString *text = buffer();
@@ -363,7 +722,34 @@ void RegExpFilter::process()
         return;
     }
 
-    QRegularExpressionMatchIterator iterator(_searchText.globalMatch(*text));
+    if (_requiredLiterals.isEmpty()) {
+        processMatches(*text, 0);
+        return;
+    }
+
+    // matches do not span lines, so only the lines containing a required
+    // literal need to be searched with the regular expression
+    int position = 0;
+    while (position < text->length()) {
+        const int literal = findRequiredLiteral(*text, position);
+        if (literal == -1) {
+            break;
+        }
+
+        const int start = text->lastIndexOf(QLatin1Char('\n'), literal) + 1;
+        int end = text->indexOf(QLatin1Char('\n'), literal);
+        if (end == -1) {
+            end = text->length();
+        }
+
+        processMatches(text->mid(start, end - start), start);
+        position = end + 1;
+    }
+}
+
+void RegExpFilter::processMatches(const QString &text, int offset)
+{
+    QRegularExpressionMatchIterator iterator(_searchText.globalMatch(text));
     while (iterator.hasNext()) {
         QRegularExpressionMatch match(iterator.next());
 
@@ -372,8 +758,8 @@ void RegExpFilter::process()
         int startColumn = 0;
         int endColumn = 0;
 
-        getLineColumn(match.capturedStart(), startLine, startColumn);
-        getLineColumn(match.capturedEnd(), endLine, endColumn);
+        getLineColumn(offset + match.capturedStart(), startLine, startColumn);
+        getLineColumn(offset + match.capturedEnd(), endLine, endColumn);
 
         RegExpFilter::HotSpot *spot = newHotSpot(startLine, startColumn,
                                                  endLine, endColumn, match.capturedTexts());
@@ -471,6 +857,10 @@ const QRegularExpression UrlFilter::CompleteUrlRegExp(QLatin1Char('(') + FullUrl
 UrlFilter::UrlFilter()
 {
     setRegExp(CompleteUrlRegExp);
+    // every url contains one of these, see FullUrlRegExp and EmailAddressRegExp
+    setRequiredLiterals(QStringList() << QStringLiteral("://")
+                                      << QStringLiteral("www.")
+                                      << QStringLiteral("@"));
 }
 
 UrlFilter::HotSpot::~HotSpot()
@@ -545,13 +935,37 @@ RegExpFilter::HotSpot *FileFilter::newHotSpot(int startLine, int startColumn, in
     return new FileFilter::HotSpot(startLine, startColumn, endLine, endColumn, capturedTexts, _dirPath + filename);
 }
 
-void FileFilter::process()
+bool FileFilter::prepareToProcess()
+{
+    const bool regExpUnchanged = RegExpFilter::prepareToProcess();
+
+    if (_session == nullptr) {
+        return regExpUnchanged;
+    }
+
+    // the directory is listed in the background, until that is done
+    // there are no files and so no hotspots
+    const FileListCache::Listing listing = FileListCache::instance()->listing(_session->currentWorkingDirectory());
+
+    // hotspots found earlier may point to files which no longer exist,
+    // and text which did not match before may now name a file
+    const bool unchanged = (listing.revision == _revision);
+
+    _dirPath = listing.canonicalPath + QLatin1Char('/');
+    _currentFiles = listing.files;
+    _revision = listing.revision;
+
+    return regExpUnchanged && unchanged;
+}
+
+bool FileFilter::isCurrentDirectory(const QString &canonicalPath) const
 {
-    const QDir dir(_session->currentWorkingDirectory());
-    _dirPath = dir.canonicalPath() + QLatin1Char('/');
-    _currentFiles = dir.entryList(QDir::Files).toSet();
+    if (_session == nullptr) {
+        return false;
+    }
 
-    RegExpFilter::process();
+    // the cache knows the canonical path once the directory was listed
+    return FileListCache::instance()->canonicalPath(_session->currentWorkingDirectory()) == canonicalPath;
 }
 
 FileFilter::HotSpot::HotSpot(int startLine, int startColumn, int endLine, int endColumn,
@@ -568,12 +982,34 @@ void FileFilter::HotSpot::activate(QObject *)
     new KRun(QUrl::fromLocalFile(_filePath), QApplication::activeWindow());
 }
 
-static QString createFileRegex(const QStringList &patterns, const QString &filePattern, const QString pathPattern)
+static QString createFileRegex(const QStringList &patterns, const QString &filePattern, const QString pathPattern,
+                               QStringList *literals = nullptr)
 {
     QStringList suffixes = patterns.filter(QRegularExpression(QStringLiteral("^\\*") + filePattern + QStringLiteral("$")));
     QStringList prefixes = patterns.filter(QRegularExpression(QStringLiteral("^") + filePattern + QStringLiteral("+\\*$")));
     QStringList fullNames = patterns.filter(QRegularExpression(QStringLiteral("^") + filePattern + QStringLiteral("$")));
 
+    // each match contains a suffix, a prefix or a full name.  dots are not escaped
+    // in full names, so only the longest part between them is matched literally.
+    // an empty group would match any file name, which leaves nothing to require
+    if (literals != nullptr && !suffixes.isEmpty() && !prefixes.isEmpty() && !fullNames.isEmpty()) {
+        foreach (const QString &suffix, suffixes) {
+            *literals << suffix.mid(1);
+        }
+        foreach (const QString &prefix, prefixes) {
+            *literals << prefix.left(prefix.length() - 1);
+        }
+        foreach (const QString &fullName, fullNames) {
+            QString longestPart;
+            foreach (const QString &part, fullName.split(QLatin1Char('.'))) {
+                if (part.length() > longestPart.length()) {
+                    longestPart = part;
+                }
+            }
+            *literals << longestPart;
+        }
+    }
+
     suffixes.replaceInStrings(QStringLiteral("*"), QStringLiteral(""));
     suffixes.replaceInStrings(QStringLiteral("."), QStringLiteral("\\."));
     prefixes.replaceInStrings(QStringLiteral("*"), QStringLiteral(""));
@@ -605,6 +1041,7 @@ FileFilter::FileFilter(Session *session) :
     _session(session)
     , _dirPath(QString())
     , _currentFiles(QSet<QString>())
+    , _revision(0)
 {
     QStringList patterns;
     QMimeDatabase mimeDatabase;
@@ -617,13 +1054,15 @@ FileFilter::FileFilter(Session *session) :
 
     QString validFilename(QStringLiteral("[A-Za-z0-9\\._\\-]+"));
     QString pathRegex(QStringLiteral("([A-Za-z0-9\\._\\-/]+/)"));
-    QString noSpaceRegex = QLatin1String("\\b") + createFileRegex(patterns, validFilename, pathRegex) + QLatin1String("\\b");
+    QStringList literals;
+    QString noSpaceRegex = QLatin1String("\\b") + createFileRegex(patterns, validFilename, pathRegex, &literals) + QLatin1String("\\b");
 
     QString spaceRegex = QLatin1String("'") + createFileRegex(patterns, validFilename, pathRegex) + QLatin1String("'");
 
     QString regex = QLatin1String("(") + noSpaceRegex + QLatin1String(")|(") + spaceRegex + QLatin1String(")");
 
     setRegExp(QRegularExpression(regex, QRegularExpression::DontCaptureOption));
+    setRequiredLiterals(literals);
 }
 
 FileFilter::HotSpot::~HotSpot()
@@ -21,6 +21,8 @@
 #define FILTER_H
 
 // Qt
+#include <QBitArray>
+#include <QHash>
 #include <QList>
 #include <QSet>
 #include <QObject>
@@ -28,6 +30,7 @@
 #include <QStringList>
 #include <QRegularExpression>
 #include <QMultiHash>
+#include <QVector>
 
 // Konsole
 #include "Character.h"
@@ -117,6 +120,12 @@ public:
          */
         virtual QList<QAction *> actions();
 
+        /**
+         * Moves the hotspot down by @p lines lines, or up if @p lines is negative.
+         * This is used when the text which the hotspot was found in has moved.
+         */
+        void translateLines(int lines);
+
     protected:
         /** Sets the type of a hotspot.  This should only be set once */
         void setType(Type type);
@@ -136,6 +145,17 @@ public:
     /** Causes the filter to process the block of text currently in its internal buffer */
     virtual void process() = 0;
 
+    /**
+     * Called by filter chains before each call to process().
+     *
+     * Returns true if the hotspots which the filter found in earlier passes are still
+     * valid for text which has not changed since, in which case only changed text needs
+     * to be processed again.  Filters whose matches depend on anything other than the
+     * text, such as the contents of a directory, should reimplement this to return false
+     * when that changed.  The default implementation returns true.
+     */
+    virtual bool prepareToProcess();
+
     /**
      * Empties the filters internal buffer and resets the line count back to 0.
      * All hotspots are deleted.
@@ -161,17 +181,45 @@ protected:
     void addHotSpot(HotSpot *);
     /** Returns the internal buffer */
     const QString *buffer();
-    /** Converts a character position within buffer() to a line and column */
+    /**
+     * Converts a character position within buffer() to a line and column.
+     * This takes logarithmic time in the number of lines.
+     */
     void getLineColumn(int position, int &startLine, int &startColumn);
 
 private:
     Q_DISABLE_COPY(Filter)
 
+    // the part of a line covered by a hotspot, see hotSpotAt()
+    struct Interval {
+        int startColumn;
+        int endColumn;
+        HotSpot *spot;
+    };
+
+    void updateColumnWidths();
+    void updateIntervals() const;
+
+    // re-adds hotspots which were found in earlier passes
+    friend class TerminalImageFilterChain;
+
     QMultiHash<int, HotSpot *> _hotspots;
     QList<HotSpot *> _hotspotList;
 
+    // for every line, the parts covered by hotspots sorted by start column.
+    // built on demand, as hotspots do not overlap one binary search finds
+    // the hotspot at a position
+    mutable QVector<QVector<Interval> > _intervals;
+    mutable bool _intervalsValid;
+
     const QList<int> *_linePositions;
     const QString *_buffer;
+
+    // _columnWidths[i] is the display width of the first i characters of
+    // the buffer, so the column of a position is the difference between
+    // its entry and that of the start of its line
+    QVector<int> _columnWidths;
+    bool _columnWidthsValid;
 };
 
 /**
@@ -208,12 +256,24 @@ public:
      * Sets the regular expression which the filter searches for in blocks of text.
      *
      * Regular expressions which match the empty string are treated as not matching
-     * anything.
+     * anything.  The hotspots found with the previous expression are discarded in
+     * the next pass.
      */
     void setRegExp(const QRegularExpression &regExp);
     /** Returns the regular expression which the filter searches for in blocks of text */
     QRegularExpression regExp() const;
 
+    /**
+     * Sets strings of which every match of regExp() contains at least one.
+     *
+     * process() then looks for these literals first and only runs the regular
+     * expression on the lines containing one of them, so that text without any
+     * of them is cheap to filter.  This requires that matches of regExp() never
+     * span more than one line.  An empty list, or one containing an empty
+     * string, runs the regular expression on the whole text.
+     */
+    void setRequiredLiterals(const QStringList &literals);
+
     /**
      * Reimplemented to search the filter's text buffer for text matching regExp()
      *
@@ -222,6 +282,12 @@ public:
      */
     void process() Q_DECL_OVERRIDE;
 
+    /**
+     * Reimplemented to return false once after setRegExp() changed the regular
+     * expression, the hotspots of unchanged text are then no longer valid.
+     */
+    bool prepareToProcess() Q_DECL_OVERRIDE;
+
 protected:
     /**
      * Called when a match for the regular expression is encountered.  Subclasses should reimplement this
@@ -231,7 +297,19 @@ protected:
                                               int endColumn, const QStringList &capturedTexts);
 
 private:
+    // returns the position of the first required literal at or after from, or -1
+    int findRequiredLiteral(const QString &text, int from) const;
+    // adds hotspots for the matches in text, which starts at offset in the buffer
+    void processMatches(const QString &text, int offset);
+
     QRegularExpression _searchText;
+    bool _regExpChanged; // since the last pass
+
+    QStringList _requiredLiterals;
+    QBitArray _literalFirstCharacters;
+    QBitArray _singleCharacterLiterals;
+    // literals of two or more characters, by their first two characters
+    QHash<uint, QStringList> _literalsByPrefix;
 };
 
 class FilterObject;
@@ -314,7 +392,18 @@ public:
 
     explicit FileFilter(Session *session);
 
-    void process() Q_DECL_OVERRIDE;
+    /**
+     * Reimplemented to look up the files in the session's current directory in
+     * FileListCache.  Returns false if the directory or the files in it changed
+     * since the last pass.
+     */
+    bool prepareToProcess() Q_DECL_OVERRIDE;
+
+    /**
+     * Returns true if @p canonicalPath is the session's current directory, so
+     * that a new FileListCache listing of it changes the files found.
+     */
+    bool isCurrentDirectory(const QString &canonicalPath) const;
 
 protected:
     RegExpFilter::HotSpot *newHotSpot(int, int, int, int, const QStringList &) Q_DECL_OVERRIDE;
@@ -323,6 +412,7 @@ private:
     QPointer<Session> _session;
     QString _dirPath;
     QSet<QString> _currentFiles;
+    int _revision; // of the FileListCache listing of _dirPath
 };
 
 class FilterObject : public QObject
@@ -366,16 +456,16 @@ public:
     /** Adds a new filter to the chain.  The chain will delete this filter when it is destroyed */
     void addFilter(Filter *filter);
     /** Removes a filter from the chain.  The chain will no longer delete the filter when destroyed */
-    void removeFilter(Filter *filter);
+    virtual void removeFilter(Filter *filter);
     /** Removes all filters from the chain */
-    void clear();
+    virtual void clear();
 
     /** Resets each filter in the chain */
     void reset();
     /**
      * Processes each filter in the chain
      */
-    void process();
+    virtual void process();
 
     /** Sets the buffer for each filter in the chain to process. */
     void setBuffer(const QString *buffer, const QList<int> *linePositions);
@@ -388,7 +478,16 @@ public:
     QList<Filter::HotSpot> hotSpotsAtLine(int line) const;
 };
 
-/** A filter chain which processes character images from terminal displays */
+/**
+ * A filter chain which processes character images from terminal displays.
+ *
+ * The chain processes images incrementally.  The image is split into runs of
+ * lines joined by line wrapping, and the hotspots found in each run are
+ * remembered.  On the next pass, runs whose text is unchanged - including runs
+ * which have only moved because the view scrolled - keep their hotspots, which
+ * are moved to the run's new position.  Only the text of the remaining runs is
+ * decoded and given to the filters.
+ */
 class TerminalImageFilterChain : public FilterChain
 {
 public:
@@ -406,11 +505,55 @@ public:
     void setImage(const Character * const image, int lines, int columns,
                   const QVector<LineProperty> &lineProperties);
 
+    /**
+     * Reimplemented to process only the lines of the image which changed
+     * since the last pass.
+     */
+    void process() Q_DECL_OVERRIDE;
+
+    /**
+     * Reimplemented to forget the hotspots remembered for @p filter, which
+     * are owned by the filter and may be deleted along with it.
+     */
+    void removeFilter(Filter *filter) Q_DECL_OVERRIDE;
+    /** Reimplemented to forget the hotspots remembered for all filters */
+    void clear() Q_DECL_OVERRIDE;
+
 private:
     Q_DISABLE_COPY(TerminalImageFilterChain)
 
+    // a run of lines in the image joined by line wrapping
+    struct Segment {
+        int firstLine;
+        int lineCount;
+        bool endsWithNewline;
+        uint hash;
+        // the hotspots found in the segment, one list per filter of the
+        // chain in the order of _processedFilters
+        QVector<QList<Filter::HotSpot *> > hotSpots;
+    };
+
+    QVector<Segment> findSegments() const;
+    bool sameText(const Segment &segment, const Segment &processedSegment) const;
+    // decodes the lines of the current image into _buffer and _linePositions,
+    // only those in segments for which @p include is true if it is not empty
+    void decode(const QVector<Segment> &segments, const QVector<bool> &include);
+
     QString *_buffer;
     QList<int> *_linePositions;
+
+    // the image set by setImage()
+    QVector<Character> _image;
+    QVector<LineProperty> _lineProperties;
+    int _lines;
+    int _columns;
+
+    // the image as of the last call to process(), its segments, and the
+    // filters which processed it
+    QVector<Character> _processedImage;
+    int _processedColumns;
+    QVector<Segment> _segments;
+    QList<Filter *> _processedFilters;
 };
 }
 #endif //FILTER_H
@@ -30,6 +30,7 @@
 
 // Qt
 #include <QBuffer>
+#include <QtAlgorithms>
 #include <QTextStream>
 #include <QRegularExpression>
 #include <QKeySequence>
@@ -465,23 +466,31 @@ bool KeyboardTranslator::Entry::matches(int testKeyCode,
         return false;
     }
 
-    if ((testKeyboardModifiers & _modifierMask) != (_modifiers & _modifierMask)) {
-        return false;
-    }
-
     // if testKeyboardModifiers is non-zero, the 'any modifier' state is implicit
     if (testKeyboardModifiers != 0) {
         testState |= AnyModifierState;
     }
 
+    // In the context of the 'Any Modifier' state, the 'keypad' modifier does not count.
+    const bool anyModifiersSet = (testKeyboardModifiers != 0)
+                                 && (testKeyboardModifiers != Qt::KeypadModifier);
+
+    return matchesCondition(testKeyboardModifiers, testState, anyModifiersSet);
+}
+
+bool KeyboardTranslator::Entry::matchesCondition(Qt::KeyboardModifiers testKeyboardModifiers,
+                                                 States testState, bool anyModifiersSet) const
+{
+    if ((testKeyboardModifiers & _modifierMask) != (_modifiers & _modifierMask)) {
+        return false;
+    }
+
     if ((testState & _stateMask) != (_state & _stateMask)) {
         return false;
     }
 
     // special handling for the 'Any Modifier' state, which checks for the presence of
-    // any or no modifiers.  In this context, the 'keypad' modifier does not count.
-    bool anyModifiersSet = (testKeyboardModifiers != 0)
-                           && (testKeyboardModifiers != Qt::KeypadModifier);
+    // any or no modifiers.
     bool wantAnyModifier = (_state &KeyboardTranslator::AnyModifierState) != 0;
     if ((_stateMask &KeyboardTranslator::AnyModifierState) != 0) {
         if (wantAnyModifier != anyModifiersSet) {
@@ -702,6 +711,10 @@ QString KeyboardTranslator::Entry::conditionToString() const
 
 KeyboardTranslator::KeyboardTranslator(const QString &name) :
     _entries(QMultiHash<int, Entry>()),
+    _compiledKeys(QVector<CompiledKey>()),
+    _otherCompiledKeys(QHash<int, CompiledKey>()),
+    _compiledSlots(QVector<int>()),
+    _compiledEntries(QVector<Entry>()),
     _name(name),
     _description(QString())
 {
@@ -748,6 +761,7 @@ void KeyboardTranslator::addEntry(const Entry &entry)
 {
     const int keyCode = entry.keyCode();
     _entries.insert(keyCode, entry);
+    _compiledKeys.clear();
 }
 
 void KeyboardTranslator::replaceEntry(const Entry &existing, const Entry &replacement)
@@ -757,24 +771,157 @@ void KeyboardTranslator::replaceEntry(const Entry &existing, const Entry &replac
     }
 
     _entries.insert(replacement.keyCode(), replacement);
+    _compiledKeys.clear();
 }
 
 void KeyboardTranslator::removeEntry(const Entry &entry)
 {
     _entries.remove(entry.keyCode(), entry);
+    _compiledKeys.clear();
+}
+
+// The compiled table has a slot for every combination of the condition
+// bits which the entries of a key code test, holding the entry which
+// matches that combination.  The condition bits of a key press are:
+//
+// - the Shift, Ctrl, Alt, Meta and KeyPad modifiers
+// - the state flags, with AnyModifierState set if any modifier is pressed
+// - whether a modifier other than KeyPad is pressed, see Entry::matches()
+//
+// The bits of a key press which its key code's entries test are packed
+// into the index of its slot.
+
+// the number of places Qt::ShiftModifier, the first modifier tested, is shifted by
+static const int MODIFIER_SHIFT = 25;
+static const uint MODIFIER_BITS = 0x1f;
+static const int STATE_SHIFT = 5;
+static const uint STATE_BITS = 0x3f;
+static const uint NON_KEYPAD_MODIFIER_BIT = 1u << 11;
+
+// Latin-1 key codes and the special keys from Qt::Key_Escape on have a
+// place in _compiledKeys, other key codes are looked up in _otherCompiledKeys
+static const int COMPILED_KEY_COUNT = 0x300;
+
+static int compiledKeyIndex(int keyCode)
+{
+    if (keyCode >= 0 && keyCode < 0x100) {
+        return keyCode;
+    }
+    if (keyCode >= Qt::Key_Escape && keyCode < Qt::Key_Escape + COMPILED_KEY_COUNT - 0x100) {
+        return 0x100 + keyCode - Qt::Key_Escape;
+    }
+    return -1;
+}
+
+static uint conditionBits(Qt::KeyboardModifiers modifiers, KeyboardTranslator::States states)
+{
+    if (modifiers != 0) {
+        states |= KeyboardTranslator::AnyModifierState;
+    }
+
+    uint bits = (static_cast<uint>(modifiers) >> MODIFIER_SHIFT) & MODIFIER_BITS;
+    bits |= (static_cast<uint>(states) & STATE_BITS) << STATE_SHIFT;
+    if (modifiers != 0 && modifiers != Qt::KeypadModifier) {
+        bits |= NON_KEYPAD_MODIFIER_BIT;
+    }
+    return bits;
+}
+
+// packs the bits of value which are set in mask into the lowest bits
+static int packBits(uint value, uint mask)
+{
+    int packed = 0;
+    for (int bit = 1; mask != 0; bit <<= 1) {
+        const uint lowest = mask & (~mask + 1);
+        if ((value & lowest) != 0) {
+            packed |= bit;
+        }
+        mask &= ~lowest;
+    }
+    return packed;
+}
+
+// the reverse of packBits()
+static uint unpackBits(int packed, uint mask)
+{
+    uint value = 0;
+    for (int bit = 1; mask != 0; bit <<= 1) {
+        const uint lowest = mask & (~mask + 1);
+        if ((packed & bit) != 0) {
+            value |= lowest;
+        }
+        mask &= ~lowest;
+    }
+    return value;
+}
+
+void KeyboardTranslator::compile() const
+{
+    _compiledKeys.fill(CompiledKey{0, -1}, COMPILED_KEY_COUNT);
+    _otherCompiledKeys.clear();
+    _compiledSlots.clear();
+    _compiledEntries.clear();
+
+    foreach (int keyCode, _entries.uniqueKeys()) {
+        // the entries are tested in the order of the hash, latest first
+        const int firstEntry = _compiledEntries.count();
+        uint conditionMask = 0;
+        QHash<int, Entry>::const_iterator i = _entries.constFind(keyCode);
+        while (i != _entries.constEnd() && i.key() == keyCode) {
+            const Entry &entry = i.value();
+            conditionMask |= (static_cast<uint>(entry.modifierMask()) >> MODIFIER_SHIFT) & MODIFIER_BITS;
+            conditionMask |= (static_cast<uint>(entry.stateMask()) & STATE_BITS) << STATE_SHIFT;
+            if ((entry.stateMask() & AnyModifierState) != 0) {
+                conditionMask |= NON_KEYPAD_MODIFIER_BIT;
+            }
+            _compiledEntries.append(entry);
+            ++i;
+        }
+        const int endEntry = _compiledEntries.count();
+
+        const CompiledKey key = { conditionMask, _compiledSlots.count() };
+        const int slotCount = 1 << qPopulationCount(conditionMask);
+        for (int slot = 0; slot < slotCount; slot++) {
+            const uint bits = unpackBits(slot, conditionMask);
+            const auto modifiers = Qt::KeyboardModifiers(static_cast<int>((bits & MODIFIER_BITS) << MODIFIER_SHIFT));
+            const auto states = States(static_cast<int>((bits >> STATE_SHIFT) & STATE_BITS));
+            const bool anyModifiersSet = (bits & NON_KEYPAD_MODIFIER_BIT) != 0;
+
+            int match = -1;
+            for (int entry = firstEntry; entry < endEntry; entry++) {
+                if (_compiledEntries.at(entry).matchesCondition(modifiers, states, anyModifiersSet)) {
+                    match = entry;
+                    break;
+                }
+            }
+            _compiledSlots.append(match);
+        }
+
+        const int index = compiledKeyIndex(keyCode);
+        if (index >= 0) {
+            _compiledKeys[index] = key;
+        } else {
+            _otherCompiledKeys.insert(keyCode, key);
+        }
+    }
 }
 
 KeyboardTranslator::Entry KeyboardTranslator::findEntry(int keyCode,
                                                         Qt::KeyboardModifiers modifiers,
                                                         States state) const
 {
-    QHash<int, KeyboardTranslator::Entry>::const_iterator i = _entries.find(keyCode);
-    while (i != _entries.constEnd() && i.key() == keyCode) {
-        if (i.value().matches(keyCode, modifiers, state)) {
-            return i.value();
-        }
-        ++i;
+    if (_compiledKeys.isEmpty()) {
+        compile();
+    }
+
+    const int index = compiledKeyIndex(keyCode);
+    const CompiledKey key = index >= 0 ? _compiledKeys.at(index)
+                            : _otherCompiledKeys.value(keyCode, CompiledKey{0, -1});
+    if (key.firstSlot < 0) {
+        return Entry(); // No matching entry
     }
 
-    return Entry(); // No matching entry
+    const int match = _compiledSlots.at(key.firstSlot + packBits(conditionBits(modifiers, state),
+                                                                 key.conditionMask));
+    return match >= 0 ? _compiledEntries.at(match) : Entry();
 }
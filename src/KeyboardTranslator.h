@@ -27,6 +27,7 @@
 #include <QList>
 #include <QString>
 #include <QMetaType>
+#include <QVector>
 
 // Konsole
 #include "konsoleprivate_export.h"
@@ -238,6 +239,13 @@ public:
         bool operator==(const Entry &rhs) const;
 
     private:
+        friend class KeyboardTranslator;
+
+        // the part of matches() which does not depend on the key code, with
+        // AnyModifierState already added to testState for any modifier
+        bool matchesCondition(Qt::KeyboardModifiers testKeyboardModifiers, States testState,
+                              bool anyModifiersSet) const;
+
         void insertModifier(QString &item, int modifier) const;
         void insertState(QString &item, int state) const;
         QByteArray unescape(const QByteArray &text) const;
@@ -282,6 +290,14 @@ public:
      */
     Entry findEntry(int keyCode, Qt::KeyboardModifiers modifiers, States state = NoState) const;
 
+    /**
+     * Builds the table which findEntry() looks entries up in, instead of
+     * testing each entry of the key code.  The table is built by the first
+     * findEntry() after the entries changed, building it beforehand keeps
+     * this out of the way of the first key press.
+     */
+    void compile() const;
+
     /**
      * Adds an entry to this keyboard translator's table.  Entries can be looked up according
      * to their key sequence using findEntry()
@@ -303,9 +319,24 @@ public:
     QList<Entry> entries() const;
 
 private:
+    // the entries of a key code in the compiled table
+    struct CompiledKey {
+        // the condition bits which the entries of the key test, the key
+        // has a slot for each combination of them
+        uint conditionMask;
+        // the first slot in _compiledSlots, or -1 if there are no entries
+        int firstSlot;
+    };
+
     // All entries in this translator, indexed by their keycode
     QMultiHash<int, Entry> _entries;
 
+    // built by compile(), empty if the entries changed since
+    mutable QVector<CompiledKey> _compiledKeys;         // Latin-1 and special keys
+    mutable QHash<int, CompiledKey> _otherCompiledKeys; // the other keys
+    mutable QVector<int> _compiledSlots;                // indexes into _compiledEntries, or -1
+    mutable QVector<Entry> _compiledEntries;
+
     QString _name;
     QString _description;
 };
@@ -346,7 +377,7 @@ public:
  *  }
  * @endcode
  */
-class KeyboardTranslatorReader
+class KONSOLEPRIVATE_EXPORT KeyboardTranslatorReader
 {
 public:
     /** Constructs a new reader which parses the given @p source */
@@ -23,8 +23,10 @@
 #include "KeyboardTranslatorManager.h"
 
 #include "konsoledebug.h"
+#include "StartupCache.h"
 
 // Qt
+#include <QDataStream>
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
@@ -90,7 +92,7 @@ void KeyboardTranslatorManager::findTranslators()
     list.reserve(dirs.size());
 
     Q_FOREACH (const QString &dir, dirs) {
-        const QStringList fileNames = QDir(dir).entryList(QStringList() << QStringLiteral("*.keytab"));
+        const QStringList fileNames = StartupCache::instance()->entryList(dir, QStringLiteral("*.keytab"));
         Q_FOREACH (const QString &file, fileNames) {
             list.append(dir + QLatin1Char('/') + file);
         }
@@ -161,16 +163,98 @@ bool KeyboardTranslatorManager::saveTranslator(const KeyboardTranslator *transla
     return true;
 }
 
+// the translator read from a .keytab file, as kept in the startup cache
+static QByteArray cachedTranslator(const KeyboardTranslator *translator)
+{
+    const QList<KeyboardTranslator::Entry> entries = translator->entries();
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    stream << translator->description() << static_cast<quint32>(entries.size());
+    foreach (const KeyboardTranslator::Entry &entry, entries) {
+        stream << static_cast<qint32>(entry.keyCode())
+               << static_cast<qint32>(entry.modifiers())
+               << static_cast<qint32>(entry.modifierMask())
+               << static_cast<qint32>(entry.state())
+               << static_cast<qint32>(entry.stateMask())
+               << static_cast<qint32>(entry.command())
+               << entry.text();
+    }
+
+    return data;
+}
+
+static KeyboardTranslator *readCachedTranslator(const QByteArray &data, const QString &name)
+{
+    if (data.isEmpty()) {
+        return nullptr;
+    }
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    QString description;
+    quint32 count = 0;
+    stream >> description >> count;
+
+    auto translator = new KeyboardTranslator(name);
+    translator->setDescription(description);
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        qint32 keyCode = 0;
+        qint32 modifiers = 0;
+        qint32 modifierMask = 0;
+        qint32 state = 0;
+        qint32 stateMask = 0;
+        qint32 command = 0;
+        QByteArray text;
+        stream >> keyCode >> modifiers >> modifierMask >> state >> stateMask >> command >> text;
+
+        KeyboardTranslator::Entry entry;
+        entry.setKeyCode(keyCode);
+        entry.setModifiers(Qt::KeyboardModifiers(modifiers));
+        entry.setModifierMask(Qt::KeyboardModifiers(modifierMask));
+        entry.setState(KeyboardTranslator::States(state));
+        entry.setStateMask(KeyboardTranslator::States(stateMask));
+        entry.setCommand(static_cast<KeyboardTranslator::Command>(command));
+        entry.setText(text);
+        translator->addEntry(entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        delete translator;
+        return nullptr;
+    }
+
+    return translator;
+}
+
 KeyboardTranslator *KeyboardTranslatorManager::loadTranslator(const QString &name)
 {
     const QString &path = findTranslatorPath(name);
 
+    // use the translator read before, unless the file changed since
+    StartupCache *cache = StartupCache::instance();
+    KeyboardTranslator *translator = readCachedTranslator(cache->data(path), name);
+    if (translator != nullptr) {
+        translator->compile();
+        return translator;
+    }
+
     QFile source(path);
     if (name.isEmpty() || !source.open(QIODevice::ReadOnly | QIODevice::Text)) {
         return nullptr;
     }
 
-    return loadTranslator(&source, name);
+    translator = loadTranslator(&source, name);
+    if (translator != nullptr) {
+        cache->setData(path, cachedTranslator(translator));
+        translator->compile();
+    }
+
+    return translator;
 }
 
 KeyboardTranslator *KeyboardTranslatorManager::loadTranslator(QIODevice *source,
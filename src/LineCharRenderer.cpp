@@ -0,0 +1,487 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "LineCharRenderer.h"
+
+// Qt
+#include <QCache>
+#include <QCoreApplication>
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
+#include <QString>
+
+// Konsole
+#include "LineFont.h"
+
+using namespace Konsole;
+
+/**
+ A table for emulating the simple (single width) unicode drawing chars.
+ It represents the 250x - 257x glyphs. If it's zero, we can't use it.
+ if it's not, it's encoded as follows: imagine a 5x5 grid where the points are numbered
+ 0 to 24 left to top, top to bottom. Each point is represented by the corresponding bit.
+
+ Then, the pixels basically have the following interpretation:
+ _|||_
+ -...-
+ -...-
+ -...-
+ _|||_
+
+where _ = none
+      | = vertical line.
+      - = horizontal line.
+ */
+
+enum LineEncode {
+    TopL  = (1 << 1),
+    TopC  = (1 << 2),
+    TopR  = (1 << 3),
+
+    LeftT = (1 << 5),
+    Int11 = (1 << 6),
+    Int12 = (1 << 7),
+    Int13 = (1 << 8),
+    RightT = (1 << 9),
+
+    LeftC = (1 << 10),
+    Int21 = (1 << 11),
+    Int22 = (1 << 12),
+    Int23 = (1 << 13),
+    RightC = (1 << 14),
+
+    LeftB = (1 << 15),
+    Int31 = (1 << 16),
+    Int32 = (1 << 17),
+    Int33 = (1 << 18),
+    RightB = (1 << 19),
+
+    BotL  = (1 << 21),
+    BotC  = (1 << 22),
+    BotR  = (1 << 23)
+};
+
+static void drawLineChar(QPainter& paint, int x, int y, int w, int h, uchar code)
+{
+    //Calculate cell midpoints, end points.
+    const int cx = x + w / 2;
+    const int cy = y + h / 2;
+    const int ex = x + w - 1;
+    const int ey = y + h - 1;
+
+    const quint32 toDraw = LineChars[code];
+
+    //Top _lines:
+    if ((toDraw & TopL) != 0u) {
+        paint.drawLine(cx - 1, y, cx - 1, cy - 2);
+    }
+    if ((toDraw & TopC) != 0u) {
+        paint.drawLine(cx, y, cx, cy - 2);
+    }
+    if ((toDraw & TopR) != 0u) {
+        paint.drawLine(cx + 1, y, cx + 1, cy - 2);
+    }
+
+    //Bot _lines:
+    if ((toDraw & BotL) != 0u) {
+        paint.drawLine(cx - 1, cy + 2, cx - 1, ey);
+    }
+    if ((toDraw & BotC) != 0u) {
+        paint.drawLine(cx, cy + 2, cx, ey);
+    }
+    if ((toDraw & BotR) != 0u) {
+        paint.drawLine(cx + 1, cy + 2, cx + 1, ey);
+    }
+
+    //Left _lines:
+    if ((toDraw & LeftT) != 0u) {
+        paint.drawLine(x, cy - 1, cx - 2, cy - 1);
+    }
+    if ((toDraw & LeftC) != 0u) {
+        paint.drawLine(x, cy, cx - 2, cy);
+    }
+    if ((toDraw & LeftB) != 0u) {
+        paint.drawLine(x, cy + 1, cx - 2, cy + 1);
+    }
+
+    //Right _lines:
+    if ((toDraw & RightT) != 0u) {
+        paint.drawLine(cx + 2, cy - 1, ex, cy - 1);
+    }
+    if ((toDraw & RightC) != 0u) {
+        paint.drawLine(cx + 2, cy, ex, cy);
+    }
+    if ((toDraw & RightB) != 0u) {
+        paint.drawLine(cx + 2, cy + 1, ex, cy + 1);
+    }
+
+    //Intersection points.
+    if ((toDraw & Int11) != 0u) {
+        paint.drawPoint(cx - 1, cy - 1);
+    }
+    if ((toDraw & Int12) != 0u) {
+        paint.drawPoint(cx, cy - 1);
+    }
+    if ((toDraw & Int13) != 0u) {
+        paint.drawPoint(cx + 1, cy - 1);
+    }
+
+    if ((toDraw & Int21) != 0u) {
+        paint.drawPoint(cx - 1, cy);
+    }
+    if ((toDraw & Int22) != 0u) {
+        paint.drawPoint(cx, cy);
+    }
+    if ((toDraw & Int23) != 0u) {
+        paint.drawPoint(cx + 1, cy);
+    }
+
+    if ((toDraw & Int31) != 0u) {
+        paint.drawPoint(cx - 1, cy + 1);
+    }
+    if ((toDraw & Int32) != 0u) {
+        paint.drawPoint(cx, cy + 1);
+    }
+    if ((toDraw & Int33) != 0u) {
+        paint.drawPoint(cx + 1, cy + 1);
+    }
+}
+
+static void drawOtherChar(QPainter& paint, int x, int y, int w, int h, uchar code)
+{
+    //Calculate cell midpoints, end points.
+    const int cx = x + w / 2;
+    const int cy = y + h / 2;
+    const int ex = x + w - 1;
+    const int ey = y + h - 1;
+
+    // Double dashes
+    if (0x4C <= code && code <= 0x4F) {
+        const int xHalfGap = qMax(w / 15, 1);
+        const int yHalfGap = qMax(h / 15, 1);
+        switch (code) {
+        case 0x4D: // BOX DRAWINGS HEAVY DOUBLE DASH HORIZONTAL
+            paint.drawLine(x, cy - 1, cx - xHalfGap - 1, cy - 1);
+            paint.drawLine(x, cy + 1, cx - xHalfGap - 1, cy + 1);
+            paint.drawLine(cx + xHalfGap, cy - 1, ex, cy - 1);
+            paint.drawLine(cx + xHalfGap, cy + 1, ex, cy + 1);
+            // No break!
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 8, 0))
+            Q_FALLTHROUGH();
+#endif
+        case 0x4C: // BOX DRAWINGS LIGHT DOUBLE DASH HORIZONTAL
+            paint.drawLine(x, cy, cx - xHalfGap - 1, cy);
+            paint.drawLine(cx + xHalfGap, cy, ex, cy);
+            break;
+        case 0x4F: // BOX DRAWINGS HEAVY DOUBLE DASH VERTICAL
+            paint.drawLine(cx - 1, y, cx - 1, cy - yHalfGap - 1);
+            paint.drawLine(cx + 1, y, cx + 1, cy - yHalfGap - 1);
+            paint.drawLine(cx - 1, cy + yHalfGap, cx - 1, ey);
+            paint.drawLine(cx + 1, cy + yHalfGap, cx + 1, ey);
+            // No break!
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 8, 0))
+            Q_FALLTHROUGH();
+#endif
+        case 0x4E: // BOX DRAWINGS LIGHT DOUBLE DASH VERTICAL
+            paint.drawLine(cx, y, cx, cy - yHalfGap - 1);
+            paint.drawLine(cx, cy + yHalfGap, cx, ey);
+            break;
+        }
+    }
+
+    // Rounded corner characters
+    else if (0x6D <= code && code <= 0x70) {
+        const int r = w * 3 / 8;
+        const int d = 2 * r;
+        switch (code) {
+        case 0x6D: // BOX DRAWINGS LIGHT ARC DOWN AND RIGHT
+            paint.drawLine(cx, cy + r, cx, ey);
+            paint.drawLine(cx + r, cy, ex, cy);
+            paint.drawArc(cx, cy, d, d, 90 * 16, 90 * 16);
+            break;
+        case 0x6E: // BOX DRAWINGS LIGHT ARC DOWN AND LEFT
+            paint.drawLine(cx, cy + r, cx, ey);
+            paint.drawLine(x, cy, cx - r, cy);
+            paint.drawArc(cx - d, cy, d, d, 0 * 16, 90 * 16);
+            break;
+        case 0x6F: // BOX DRAWINGS LIGHT ARC UP AND LEFT
+            paint.drawLine(cx, y, cx, cy - r);
+            paint.drawLine(x, cy, cx - r, cy);
+            paint.drawArc(cx - d, cy - d, d, d, 270 * 16, 90 * 16);
+            break;
+        case 0x70: // BOX DRAWINGS LIGHT ARC UP AND RIGHT
+            paint.drawLine(cx, y, cx, cy - r);
+            paint.drawLine(cx + r, cy, ex, cy);
+            paint.drawArc(cx, cy - d, d, d, 180 * 16, 90 * 16);
+            break;
+        }
+    }
+
+    // Diagonals
+    else if (0x71 <= code && code <= 0x73) {
+        switch (code) {
+        case 0x71: // BOX DRAWINGS LIGHT DIAGONAL UPPER RIGHT TO LOWER LEFT
+            paint.drawLine(ex, y, x, ey);
+            break;
+        case 0x72: // BOX DRAWINGS LIGHT DIAGONAL UPPER LEFT TO LOWER RIGHT
+            paint.drawLine(x, y, ex, ey);
+            break;
+        case 0x73: // BOX DRAWINGS LIGHT DIAGONAL CROSS
+            paint.drawLine(ex, y, x, ey);
+            paint.drawLine(x, y, ex, ey);
+            break;
+        }
+    }
+}
+
+
+// Block elements ( U+2580 - U+259F ).  Boundaries are computed in whole
+// pixels so that adjacent cells join up without gaps or overlaps.
+static void drawBlockChar(QPainter& paint, int x, int y, int w, int h, uchar code)
+{
+    const QColor color = paint.pen().color();
+
+    // returns the offset of the n-th eighth of 'size'
+    auto eighth = [](int size, int n) {
+        return (size * n + 4) / 8;
+    };
+
+    if (code == 0x80) { // UPPER HALF BLOCK
+        paint.fillRect(x, y, w, eighth(h, 4), color);
+    } else if (0x81 <= code && code <= 0x88) { // LOWER ONE EIGHTH BLOCK ... FULL BLOCK
+        const int blockHeight = eighth(h, code - 0x80);
+        paint.fillRect(x, y + h - blockHeight, w, blockHeight, color);
+    } else if (0x89 <= code && code <= 0x8F) { // LEFT SEVEN EIGHTHS BLOCK ... LEFT ONE EIGHTH BLOCK
+        paint.fillRect(x, y, eighth(w, 0x90 - code), h, color);
+    } else if (code == 0x90) { // RIGHT HALF BLOCK
+        const int left = eighth(w, 4);
+        paint.fillRect(x + left, y, w - left, h, color);
+    } else if (0x91 <= code && code <= 0x93) { // LIGHT, MEDIUM and DARK SHADE
+        QColor shade(color);
+        shade.setAlpha((code - 0x90) * 64);
+        paint.fillRect(x, y, w, h, shade);
+    } else if (code == 0x94) { // UPPER ONE EIGHTH BLOCK
+        paint.fillRect(x, y, w, eighth(h, 1), color);
+    } else if (code == 0x95) { // RIGHT ONE EIGHTH BLOCK
+        const int left = eighth(w, 7);
+        paint.fillRect(x + left, y, w - left, h, color);
+    } else if (0x96 <= code && code <= 0x9F) { // QUADRANTS
+        enum {
+            UpperLeft = 1,
+            UpperRight = 2,
+            LowerLeft = 4,
+            LowerRight = 8
+        };
+        static const uchar quadrants[] = {
+            LowerLeft,                              // 2596
+            LowerRight,                             // 2597
+            UpperLeft,                              // 2598
+            UpperLeft | LowerLeft | LowerRight,     // 2599
+            UpperLeft | LowerRight,                 // 259A
+            UpperLeft | UpperRight | LowerLeft,     // 259B
+            UpperLeft | UpperRight | LowerRight,    // 259C
+            UpperRight,                             // 259D
+            UpperRight | LowerLeft,                 // 259E
+            UpperRight | LowerLeft | LowerRight     // 259F
+        };
+        const uchar mask = quadrants[code - 0x96];
+        const int cw = eighth(w, 4);
+        const int ch = eighth(h, 4);
+        if ((mask & UpperLeft) != 0) {
+            paint.fillRect(x, y, cw, ch, color);
+        }
+        if ((mask & UpperRight) != 0) {
+            paint.fillRect(x + cw, y, w - cw, ch, color);
+        }
+        if ((mask & LowerLeft) != 0) {
+            paint.fillRect(x, y + ch, cw, h - ch, color);
+        }
+        if ((mask & LowerRight) != 0) {
+            paint.fillRect(x + cw, y + ch, w - cw, h - ch, color);
+        }
+    }
+}
+
+// Braille patterns ( U+2800 - U+28FF ).  The low byte of the code point
+// is a bit mask of the eight dots, numbered as follows:
+//
+//   0 3
+//   1 4
+//   2 5
+//   6 7
+static void drawBrailleChar(QPainter& paint, int x, int y, int w, int h, uchar code)
+{
+    static const int dotColumn[] = { 0, 0, 0, 1, 1, 1, 0, 1 };
+    static const int dotRow[]    = { 0, 1, 2, 0, 1, 2, 3, 3 };
+
+    const QColor color = paint.pen().color();
+
+    // each dot is centered in a 2x4 grid of sub-cells and covers roughly
+    // half the width of its sub-cell
+    const int dotSize = qMax(1, qMin(w / 4, h / 8));
+    for (int dot = 0; dot < 8; dot++) {
+        if ((code & (1 << dot)) == 0) {
+            continue;
+        }
+        const int left = x + (w * dotColumn[dot]) / 2;
+        const int right = x + (w * (dotColumn[dot] + 1)) / 2;
+        const int top = y + (h * dotRow[dot]) / 4;
+        const int bottom = y + (h * (dotRow[dot] + 1)) / 4;
+
+        paint.fillRect(left + (right - left - dotSize) / 2,
+                       top + (bottom - top - dotSize) / 2,
+                       dotSize, dotSize, color);
+    }
+}
+
+void LineCharRenderer::drawChar(QPainter& painter, const QRect& cell, quint16 code)
+{
+    const int x = cell.x();
+    const int y = cell.y();
+    const int w = cell.width();
+    const int h = cell.height();
+    const uchar cellCode = code & 0xFF;
+
+    if ((code & 0xFF00) == 0x2800) {
+        drawBrailleChar(painter, x, y, w, h, cellCode);
+    } else if (cellCode >= 0x80) {
+        drawBlockChar(painter, x, y, w, h, cellCode);
+    } else if (LineChars[cellCode] != 0u) {
+        drawLineChar(painter, x, y, w, h, cellCode);
+    } else {
+        drawOtherChar(painter, x, y, w, h, cellCode);
+    }
+}
+
+namespace {
+struct GlyphKey {
+    quint16 code;
+    bool bold;
+    QRgb color;
+    QSize cellSize;
+    qreal devicePixelRatio;
+
+    bool operator==(const GlyphKey &other) const
+    {
+        return code == other.code && bold == other.bold && color == other.color
+               && cellSize == other.cellSize && qFuzzyCompare(devicePixelRatio, other.devicePixelRatio);
+    }
+};
+
+inline uint qHash(const GlyphKey &key)
+{
+    return ::qHash(key.code) ^ ::qHash(key.color) ^ (uint(key.cellSize.width()) << 17)
+           ^ (uint(key.cellSize.height()) << 24) ^ (key.bold ? 0x10000u : 0u);
+}
+
+// Number of glyphs kept in the cache.  This is enough for all the box drawing,
+// block and braille characters in several colors and sizes.
+const int GLYPH_CACHE_SIZE = 4096;
+
+QCache<GlyphKey, QPixmap> &glyphCache()
+{
+    static QCache<GlyphKey, QPixmap> cache(GLYPH_CACHE_SIZE);
+    // release the pixmaps while the application object still exists
+    static const bool cleanupRegistered = (qAddPostRoutine(LineCharRenderer::clearCache), true);
+    Q_UNUSED(cleanupRegistered)
+    return cache;
+}
+
+const QPixmap *cachedGlyph(const GlyphKey &key)
+{
+    QCache<GlyphKey, QPixmap> &cache = glyphCache();
+
+    QPixmap *pixmap = cache.object(key);
+    if (pixmap != nullptr) {
+        return pixmap;
+    }
+
+    QImage image(key.cellSize * key.devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(key.devicePixelRatio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    QPen pen(QColor::fromRgba(key.color));
+    if (key.bold) {
+        pen.setWidth(3);
+    }
+    painter.setPen(pen);
+    LineCharRenderer::drawChar(painter, QRect(QPoint(0, 0), key.cellSize), key.code);
+    painter.end();
+
+    pixmap = new QPixmap(QPixmap::fromImage(image));
+    cache.insert(key, pixmap);
+    return pixmap;
+}
+}
+
+void LineCharRenderer::drawString(QPainter& painter, int x, int y, const QSize& cellSize,
+                                  const QString& str, const QColor& color, bool bold,
+                                  qreal devicePixelRatio)
+{
+    GlyphKey key;
+    key.bold = bold;
+    key.color = color.rgba();
+    key.cellSize = cellSize;
+    key.devicePixelRatio = devicePixelRatio;
+
+    const int length = str.length();
+    for (int i = 0; i < length;) {
+        key.code = str[i].unicode();
+
+        // draw runs of the same glyph, such as the horizontal lines of a
+        // border or a bar in a graph, with a single blit
+        int run = 1;
+        while (i + run < length && str[i + run].unicode() == key.code) {
+            run++;
+        }
+
+        const QPixmap *glyph = cachedGlyph(key);
+        const QRect target(x + cellSize.width() * i, y, cellSize.width() * run, cellSize.height());
+        if (run == 1) {
+            painter.drawPixmap(target.topLeft(), *glyph);
+        } else {
+            painter.drawTiledPixmap(target, *glyph);
+        }
+
+        i += run;
+    }
+}
+
+QPixmap LineCharRenderer::glyph(quint16 code, const QSize &cellSize, const QColor &color,
+                                bool bold, qreal devicePixelRatio)
+{
+    GlyphKey key;
+    key.code = code;
+    key.bold = bold;
+    key.color = color.rgba();
+    key.cellSize = cellSize;
+    key.devicePixelRatio = devicePixelRatio;
+
+    return *cachedGlyph(key);
+}
+
+void LineCharRenderer::clearCache()
+{
+    glyphCache().clear();
+}
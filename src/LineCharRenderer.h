@@ -0,0 +1,82 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+#ifndef LINECHARRENDERER_H
+#define LINECHARRENDERER_H
+
+// Qt
+#include <QtGlobal>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QColor;
+class QPainter;
+class QPixmap;
+class QRect;
+class QSize;
+class QString;
+
+namespace Konsole {
+/**
+ * Draws the characters for which isSupportedLineChar() returns true
+ * (box drawing, block elements, quadrants and braille patterns) without
+ * using the font, so that they line up exactly with the character cells.
+ *
+ * Glyphs are rendered once into cell-sized pixmaps which are cached per
+ * glyph, cell size, color and weight, and then blitted onto the display.
+ * Runs of the same glyph, which are common in borders and bar graphs, are
+ * drawn with a single tiled blit.
+ */
+class KONSOLEPRIVATE_EXPORT LineCharRenderer
+{
+public:
+    /**
+     * Draws @p str, a string of line characters, starting at ( @p x, @p y ),
+     * one character per cell of size @p cellSize.
+     *
+     * @param color The color used to draw the characters.
+     * @param bold Whether box drawing lines are drawn with a heavier pen.
+     * @param devicePixelRatio The device pixel ratio of the widget that is painted on.
+     */
+    static void drawString(QPainter &painter, int x, int y, const QSize &cellSize,
+                           const QString &str, const QColor &color, bool bold,
+                           qreal devicePixelRatio);
+
+    /**
+     * Draws the single line character @p code into @p cell using the painter's
+     * current pen, without any caching.  This is used for devices such as printers
+     * where vector output is preferable to blitting pixmaps.
+     */
+    static void drawChar(QPainter &painter, const QRect &cell, quint16 code);
+
+    /**
+     * Returns the cached pixmap of the line character @p code, as drawn by
+     * drawString(), rendering it first if it is not cached yet.  The pixmap
+     * is @p cellSize scaled by @p devicePixelRatio.
+     */
+    static QPixmap glyph(quint16 code, const QSize &cellSize, const QColor &color, bool bold,
+                         qreal devicePixelRatio);
+
+    /** Discards all cached glyphs. */
+    static void clearCache();
+};
+}
+
+#endif // LINECHARRENDERER_H
@@ -51,8 +51,10 @@
 #include "Session.h"
 #include "ViewManager.h"
 #include "SessionManager.h"
+#include "SessionPool.h"
 #include "ProfileManager.h"
 #include "KonsoleSettings.h"
+#include "StartupTrace.h"
 #include "WindowSystemInfo.h"
 #include "settings/FileLocationSettings.h"
 #include "settings/GeneralSettings.h"
@@ -88,10 +90,14 @@ MainWindow::MainWindow() :
     updateUseTransparency();
 
     // create actions for menus
+    StartupTrace::beginPhase("MainWindow::setupActions");
     setupActions();
+    StartupTrace::endPhase("MainWindow::setupActions");
 
     // create view manager
+    StartupTrace::beginPhase("ViewManager");
     _viewManager = new ViewManager(this, actionCollection());
+    StartupTrace::endPhase("ViewManager");
     connect(_viewManager, &Konsole::ViewManager::empty, this, &Konsole::MainWindow::close);
     connect(_viewManager, &Konsole::ViewManager::activeViewChanged, this,
             &Konsole::MainWindow::activeViewChanged);
@@ -123,7 +129,9 @@ MainWindow::MainWindow() :
     KAcceleratorManager::setNoAccel(menuBar());
 
     // create menus
+    StartupTrace::beginPhase("MainWindow::createGUI");
     createGUI();
+    StartupTrace::endPhase("MainWindow::createGUI");
 
     // remember the original menu accelerators for later use
     rememberMenuAccelerators();
@@ -495,13 +503,8 @@ Session *MainWindow::createSession(Profile::Ptr profile, const QString &director
         profile = ProfileManager::instance()->defaultProfile();
     }
 
-    Session *session = SessionManager::instance()->createSession(profile);
-
-    if (!directory.isEmpty() && profile->startInCurrentSessionDir()) {
-        session->setInitialWorkingDirectory(directory);
-    }
-
-    session->addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_WINDOW=/Windows/%1").arg(_viewManager->managerId()));
+    const QString initialDirectory = profile->startInCurrentSessionDir() ? directory : QString();
+    Session *session = _viewManager->createSession(profile, initialDirectory);
 
     // create view before starting the session process so that the session
     // doesn't suffer a change in terminal size right after the session
@@ -786,6 +789,9 @@ void MainWindow::applyKonsoleSettings()
 
     setAutoSaveSettings(QStringLiteral("MainWindow"), KonsoleSettings::saveGeometryOnExit());
 
+    SessionManager::instance()->sessionPool()->setEnabled(KonsoleSettings::preStartSessions());
+    _viewManager->setWarmUpRestoredSessions(KonsoleSettings::preStartRestoredSessions());
+
     updateWindowCaption();
 }
 
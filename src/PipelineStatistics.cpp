@@ -0,0 +1,206 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "PipelineStatistics.h"
+
+// Standard
+#include <algorithm>
+
+using namespace Konsole;
+
+static const char *const stageNames[PipelineStatistics::StageCount] = {
+    "pty read", "parse", "get image", "update image", "filters", "paint", "input write"
+};
+
+static const char *const counterNames[PipelineStatistics::CounterCount] = {
+    "bytes in", "chars parsed", "lines scrolled", "dirty lines", "frames", "frames coalesced",
+    "process info reads"
+};
+
+// upper bounds, in microseconds, of the histogram buckets in report()
+static const qint64 histogramBounds[] = { 16, 64, 256, 1000, 4000, 16000, 64000 };
+static const int histogramBucketCount = sizeof(histogramBounds) / sizeof(histogramBounds[0]) + 1;
+
+static QString formatMsecs(qint64 nsecs)
+{
+    return QString::number(nsecs / 1000000.0, 'f', 2);
+}
+
+PipelineStatistics::PipelineStatistics() :
+    _enabled(false),
+    _overlayVisible(false)
+{
+    reset();
+
+    const QByteArray mode = qgetenv("KONSOLE_PIPELINE_STATISTICS");
+    if (!mode.isEmpty() && mode != "0") {
+        setEnabled(true);
+        setOverlayVisible(mode == "overlay");
+    }
+}
+
+void PipelineStatistics::setEnabled(bool enabled)
+{
+    if (enabled == _enabled) {
+        return;
+    }
+
+    _enabled = enabled;
+    if (_enabled) {
+        reset();
+    } else {
+        // give the memory used by the samples back
+        for (auto &samples : _samples) {
+            samples.clear();
+            samples.squeeze();
+        }
+    }
+}
+
+void PipelineStatistics::setOverlayVisible(bool visible)
+{
+    _overlayVisible = visible;
+}
+
+void PipelineStatistics::addSample(Stage stage, qint64 nsecs)
+{
+    if (!_enabled) {
+        return;
+    }
+
+    QVector<qint64> &samples = _samples[stage];
+    if (samples.size() < SAMPLE_COUNT) {
+        samples.append(nsecs);
+    } else {
+        samples[_nextSample[stage]] = nsecs;
+        _nextSample[stage] = (_nextSample[stage] + 1) % SAMPLE_COUNT;
+    }
+}
+
+void PipelineStatistics::reset()
+{
+    std::fill(_counters, _counters + CounterCount, 0);
+    std::fill(_nextSample, _nextSample + StageCount, 0);
+    for (auto &samples : _samples) {
+        samples.clear();
+        if (_enabled) {
+            samples.reserve(SAMPLE_COUNT);
+        }
+    }
+    _sinceReset.start();
+}
+
+PipelineStatistics::Summary PipelineStatistics::summary(Stage stage) const
+{
+    Summary result = { 0, 0, 0, 0, 0 };
+
+    QVector<qint64> sorted = _samples[stage];
+    if (sorted.isEmpty()) {
+        return result;
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    qint64 total = 0;
+    for (qint64 sample : sorted) {
+        total += sample;
+    }
+
+    result.count = sorted.size();
+    result.median = sorted.at(sorted.size() / 2);
+    result.p95 = sorted.at(qMin(sorted.size() - 1, sorted.size() * 95 / 100));
+    result.max = sorted.last();
+    result.mean = total / sorted.size();
+    return result;
+}
+
+QString PipelineStatistics::report() const
+{
+    if (!_enabled) {
+        return QStringLiteral("Pipeline statistics are disabled.\n");
+    }
+
+    QString text;
+    const double seconds = qMax(qint64(1), _sinceReset.elapsed()) / 1000.0;
+
+    text += QStringLiteral("Counters over %1 s:\n").arg(seconds, 0, 'f', 1);
+    for (int i = 0; i < CounterCount; i++) {
+        text += QStringLiteral("  %1: %2 (%3/s)\n")
+                .arg(QLatin1String(counterNames[i]))
+                .arg(_counters[i])
+                .arg(_counters[i] / seconds, 0, 'f', 1);
+    }
+
+    text += QStringLiteral("Stages over the last %1 runs, in ms:\n").arg(SAMPLE_COUNT);
+    for (int stage = 0; stage < StageCount; stage++) {
+        const Summary s = summary(static_cast<Stage>(stage));
+        text += QStringLiteral("  %1: n=%2 mean=%3 p50=%4 p95=%5 max=%6\n")
+                .arg(QLatin1String(stageNames[stage]))
+                .arg(s.count)
+                .arg(formatMsecs(s.mean), formatMsecs(s.median),
+                     formatMsecs(s.p95), formatMsecs(s.max));
+
+        int buckets[histogramBucketCount] = {};
+        for (qint64 sample : _samples[stage]) {
+            const qint64 usecs = sample / 1000;
+            int bucket = 0;
+            while (bucket < histogramBucketCount - 1 && usecs >= histogramBounds[bucket]) {
+                bucket++;
+            }
+            buckets[bucket]++;
+        }
+        text += QStringLiteral("    histogram (us):");
+        for (int bucket = 0; bucket < histogramBucketCount; bucket++) {
+            if (bucket < histogramBucketCount - 1) {
+                text += QStringLiteral(" <%1:%2").arg(histogramBounds[bucket]).arg(buckets[bucket]);
+            } else {
+                text += QStringLiteral(" >=%1:%2").arg(histogramBounds[bucket - 1]).arg(buckets[bucket]);
+            }
+        }
+        text += QLatin1Char('\n');
+    }
+
+    return text;
+}
+
+QStringList PipelineStatistics::overlayText() const
+{
+    QStringList lines;
+    if (!_enabled) {
+        return lines;
+    }
+
+    for (int stage = 0; stage < StageCount; stage++) {
+        const Summary s = summary(static_cast<Stage>(stage));
+        lines << QStringLiteral("%1 p50 %2 p95 %3 ms")
+              .arg(QLatin1String(stageNames[stage]), -12)
+              .arg(formatMsecs(s.median), 6)
+              .arg(formatMsecs(s.p95), 6);
+    }
+
+    const double seconds = qMax(qint64(1), _sinceReset.elapsed()) / 1000.0;
+    lines << QStringLiteral("%1 KiB/s in, %2 frames/s")
+          .arg(_counters[BytesIn] / 1024.0 / seconds, 0, 'f', 1)
+          .arg(_counters[Frames] / seconds, 0, 'f', 1);
+    lines << QStringLiteral("%1 coalesced, %2 dirty lines")
+          .arg(_counters[FramesCoalesced])
+          .arg(_counters[DirtyLines]);
+
+    return lines;
+}
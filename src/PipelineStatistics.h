@@ -0,0 +1,196 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+#ifndef PIPELINESTATISTICS_H
+#define PIPELINESTATISTICS_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole {
+/**
+ * Collects timings and counters for the stages which terminal output
+ * passes through, from reading the pty to painting the display.
+ *
+ * Each session's Emulation owns one instance, which is shared with the
+ * session's Pty and with the views showing the session.  Collection is
+ * off by default; while it is disabled every hook reduces to a single
+ * test of a boolean.  It can be switched on for a session over D-Bus, or
+ * for all sessions by setting the KONSOLE_PIPELINE_STATISTICS environment
+ * variable ( to "overlay" to also show the on-screen overlay ).
+ *
+ * For every stage the durations of the most recent SAMPLE_COUNT runs are
+ * kept, from which report() derives a rolling histogram and percentiles.
+ */
+class KONSOLEPRIVATE_EXPORT PipelineStatistics
+{
+public:
+    /** The timed stages of the output pipeline */
+    enum Stage {
+        /** Reading available data from the pty (Pty::dataReceived) */
+        PtyRead = 0,
+        /** Decoding and interpreting received data (Emulation::receiveData) */
+        Parse,
+        /** Copying the visible screen image (ScreenWindow::getImage) */
+        GetImage,
+        /** Comparing the new image with the displayed one (TerminalDisplay::updateImage) */
+        UpdateImage,
+        /** Finding hotspots in the visible image (TerminalDisplay::processFilters) */
+        Filters,
+        /** Painting the display (TerminalDisplay::paintEvent) */
+        Paint,
+        /** Writing input to the pty, from sending it until all of it was written (Pty::sendData) */
+        InputWrite,
+        StageCount
+    };
+
+    /** The counters which are accumulated while collection is enabled */
+    enum Counter {
+        /** Bytes read from the pty */
+        BytesIn = 0,
+        /** Unicode characters passed to the emulation */
+        CharsParsed,
+        /** Lines scrolled on the current screen */
+        LinesScrolled,
+        /** Lines found to have changed and repainted by views */
+        DirtyLines,
+        /** Screen updates sent to the views */
+        Frames,
+        /** Blocks of output merged into an already pending screen update */
+        FramesCoalesced,
+        /** Reads of the session's process information from the system (Session) */
+        ProcessInfoReads,
+        CounterCount
+    };
+
+    /** The number of recent samples kept per stage */
+    static const int SAMPLE_COUNT = 512;
+
+    PipelineStatistics();
+
+    /** Returns true if statistics are being collected. */
+    bool isEnabled() const
+    {
+        return _enabled;
+    }
+
+    /**
+     * Enables or disables collection.  Enabling collection starts from
+     * a clean slate, see reset().
+     */
+    void setEnabled(bool enabled);
+
+    /** Returns true if views should draw the statistics overlay. */
+    bool isOverlayVisible() const
+    {
+        return _enabled && _overlayVisible;
+    }
+
+    /** Sets whether views should draw the statistics overlay. */
+    void setOverlayVisible(bool visible);
+
+    /** Adds @p amount to @p counter if collection is enabled. */
+    void add(Counter counter, qint64 amount)
+    {
+        if (_enabled) {
+            _counters[counter] += amount;
+        }
+    }
+
+    /** Returns the value of @p counter accumulated since the last reset(). */
+    qint64 counter(Counter counter) const
+    {
+        return _counters[counter];
+    }
+
+    /** Records that a run of @p stage took @p nsecs nanoseconds. */
+    void addSample(Stage stage, qint64 nsecs);
+
+    /** Discards all samples and zeroes all counters. */
+    void reset();
+
+    /**
+     * Returns a multi-line, human readable report of all counters and of
+     * the percentiles and histogram of every stage.
+     */
+    QString report() const;
+
+    /** Returns a compact summary, one line per entry, for the overlay. */
+    QStringList overlayText() const;
+
+    /**
+     * Measures the lifetime of the timer object and records it as a sample
+     * for a stage.  Does nothing if @p statistics is null or disabled.
+     */
+    class StageTimer
+    {
+    public:
+        StageTimer(PipelineStatistics *statistics, Stage stage) :
+            _statistics((statistics != nullptr && statistics->isEnabled()) ? statistics : nullptr),
+            _stage(stage)
+        {
+            if (_statistics != nullptr) {
+                _timer.start();
+            }
+        }
+
+        ~StageTimer()
+        {
+            if (_statistics != nullptr) {
+                _statistics->addSample(_stage, _timer.nsecsElapsed());
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY(StageTimer)
+
+        PipelineStatistics *_statistics;
+        Stage _stage;
+        QElapsedTimer _timer;
+    };
+
+private:
+    Q_DISABLE_COPY(PipelineStatistics)
+
+    struct Summary {
+        int count;
+        qint64 median;
+        qint64 p95;
+        qint64 max;
+        qint64 mean;
+    };
+
+    Summary summary(Stage stage) const;
+
+    bool _enabled;
+    bool _overlayVisible;
+    qint64 _counters[CounterCount];
+    // ring buffers of the most recent samples, allocated on first use
+    QVector<qint64> _samples[StageCount];
+    int _nextSample[StageCount];
+    QElapsedTimer _sinceReset;
+};
+}
+
+#endif // PIPELINESTATISTICS_H
@@ -0,0 +1,237 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "ProcParser.h"
+
+// Unix
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Qt
+#include <QtGlobal>
+
+using namespace Konsole;
+
+// large enough for the stat and status files of any process
+static const int FILE_BUFFER_SIZE = 4096;
+
+// parses a decimal number at the start of [data, end), returns the position
+// after it, or null if there is none
+static const char *parseInt(const char *data, const char *end, int &value)
+{
+    bool negative = false;
+    if (data < end && *data == '-') {
+        negative = true;
+        data++;
+    }
+
+    const char *digits = data;
+    long long result = 0;
+    while (data < end && *data >= '0' && *data <= '9') {
+        result = result * 10 + (*data - '0');
+        if (result > 0x7fffffff) {
+            return nullptr;
+        }
+        data++;
+    }
+    if (data == digits) {
+        return nullptr;
+    }
+
+    value = static_cast<int>(negative ? -result : result);
+    return data;
+}
+
+ProcParser::ProcParser(const char *root) :
+    _root(root)
+{
+}
+
+bool ProcParser::makePath(int pid, const char *file, char *buffer, int size) const
+{
+    const int length = snprintf(buffer, size, "%s/%d/%s", _root, pid, file);
+    return length > 0 && length < size;
+}
+
+int ProcParser::readFile(int pid, const char *file, char *buffer, int size) const
+{
+    char path[256];
+    if (!makePath(pid, file, path, sizeof(path))) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+
+    ssize_t length;
+    do {
+        length = read(fd, buffer, size);
+    } while (length == -1 && errno == EINTR);
+
+    const int readError = errno;
+    close(fd);
+    errno = readError;
+
+    return static_cast<int>(length);
+}
+
+bool ProcParser::parseStat(const char *data, int length, ProcessStatus &status)
+{
+    // the format is "pid (name) state ppid pgrp session tty_nr tpgid ...".
+    // the name may itself contain spaces and parentheses, so it ends
+    // at the last closing parenthesis
+    const char *end = data + length;
+    const char *nameStart = static_cast<const char *>(memchr(data, '(', length));
+    if (nameStart == nullptr) {
+        return false;
+    }
+    nameStart++;
+
+    const char *nameEnd = end;
+    while (nameEnd > nameStart && *(nameEnd - 1) != ')') {
+        nameEnd--;
+    }
+    if (nameEnd == nameStart) {
+        return false;
+    }
+    nameEnd--;
+
+    const int nameLength = qMin(static_cast<int>(nameEnd - nameStart), NAME_SIZE - 1);
+    memcpy(status.name, nameStart, nameLength);
+    status.name[nameLength] = '\0';
+
+    // the fields following the name, counting from the state
+    const int PARENT_PID_FIELD = 1;
+    const int FOREGROUND_PID_FIELD = 5;
+
+    const char *position = nameEnd + 1;
+    for (int field = 0; field <= FOREGROUND_PID_FIELD; field++) {
+        if (position >= end || *position != ' ') {
+            return false;
+        }
+        position++;
+
+        int value = 0;
+        if (field == PARENT_PID_FIELD || field == FOREGROUND_PID_FIELD) {
+            position = parseInt(position, end, value);
+            if (position == nullptr) {
+                return false;
+            }
+            if (field == PARENT_PID_FIELD) {
+                status.parentPid = value;
+            } else {
+                status.foregroundPid = value;
+            }
+        } else {
+            while (position < end && *position != ' ') {
+                position++;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ProcParser::parseUserId(const char *data, int length, int &userId)
+{
+    // the line looks like "Uid:\t<real>\t<effective>\t<saved>\t<filesystem>"
+    const char *end = data + length;
+    const char *line = data;
+    while (line < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        if (lineEnd - line > 4 && memcmp(line, "Uid:", 4) == 0) {
+            const char *position = line + 4;
+            while (position < lineEnd && (*position == '\t' || *position == ' ')) {
+                position++;
+            }
+            return parseInt(position, lineEnd, userId) != nullptr;
+        }
+
+        line = lineEnd + 1;
+    }
+
+    return false;
+}
+
+bool ProcParser::readStatus(int pid, ProcessStatus &status, int *error) const
+{
+    char buffer[FILE_BUFFER_SIZE];
+
+    // the user id is read from the status file, the real user id of a
+    // process is not necessarily that of Konsole, e.g. for 'su'
+    int length = readFile(pid, "status", buffer, sizeof(buffer));
+    if (length == -1) {
+        if (error != nullptr) {
+            *error = errno;
+        }
+        return false;
+    }
+    if (!parseUserId(buffer, length, status.userId)) {
+        status.userId = -1;
+    }
+
+    length = readFile(pid, "stat", buffer, sizeof(buffer));
+    if (length == -1) {
+        if (error != nullptr) {
+            *error = errno;
+        }
+        return false;
+    }
+    if (!parseStat(buffer, length, status)) {
+        if (error != nullptr) {
+            *error = 0;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+int ProcParser::readArguments(int pid, char *buffer, int size) const
+{
+    return readFile(pid, "cmdline", buffer, size);
+}
+
+int ProcParser::readCurrentDir(int pid, char *buffer, int size) const
+{
+    char path[256];
+    if (!makePath(pid, "cwd", path, sizeof(path))) {
+        return -1;
+    }
+
+    const ssize_t length = readlink(path, buffer, size - 1);
+    if (length == -1) {
+        return -1;
+    }
+
+    buffer[length] = '\0';
+    return static_cast<int>(length);
+}
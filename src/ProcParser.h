@@ -0,0 +1,99 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef PROCPARSER_H
+#define PROCPARSER_H
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole {
+/**
+ * Reads the files describing a process in Linux's /proc file system.
+ *
+ * Each file is read with a single read() into a buffer on the stack and
+ * parsed in place by scanning its bytes, so that reading a process does
+ * not allocate any memory.  The results are plain structs and buffers
+ * provided by the caller.
+ *
+ * The directory to read from can be chosen, which is used to test and
+ * benchmark the parser with synthetic process trees.
+ */
+class KONSOLEPRIVATE_EXPORT ProcParser
+{
+public:
+    /** The maximum length of a process name, including the terminating null */
+    static const int NAME_SIZE = 64;
+
+    /** The fields of /proc/<pid>/stat and /proc/<pid>/status used by ProcessInfo */
+    struct ProcessStatus {
+        /** The process name, truncated to NAME_SIZE - 1 bytes */
+        char name[NAME_SIZE];
+        int parentPid;
+        /** The foreground process group of the process' terminal, or -1 */
+        int foregroundPid;
+        /** The real user id, or -1 if it is not known */
+        int userId;
+    };
+
+    /**
+     * Constructs a parser reading from @p root.  The string is not copied
+     * and has to outlive the parser.
+     */
+    explicit ProcParser(const char *root = "/proc");
+
+    /**
+     * Reads /proc/<pid>/stat and the user id from /proc/<pid>/status.
+     *
+     * Returns false if a file could not be read or parsed, in which case
+     * @p error, if not null, is set to the errno value of the failure or
+     * to 0 if the contents could not be parsed.
+     */
+    bool readStatus(int pid, ProcessStatus &status, int *error = nullptr) const;
+
+    /**
+     * Reads the null separated command line arguments of @p pid into
+     * @p buffer, truncated to @p size bytes.  Returns the number of bytes
+     * read, or -1 if the file could not be read.
+     */
+    int readArguments(int pid, char *buffer, int size) const;
+
+    /**
+     * Reads the current directory of @p pid into @p buffer as a null
+     * terminated string.  Returns its length, or -1 if it could not be read.
+     */
+    int readCurrentDir(int pid, char *buffer, int size) const;
+
+    /** Parses the contents of a stat file into @p status, except for the user id. */
+    static bool parseStat(const char *data, int length, ProcessStatus &status);
+    /** Parses the real user id from the contents of a status file. */
+    static bool parseUserId(const char *data, int length, int &userId);
+
+private:
+    // reads a file of the process with one read(), returns its length or -1
+    int readFile(int pid, const char *file, char *buffer, int size) const;
+    // writes the path of a file of the process to buffer, returns false if it does not fit
+    bool makePath(int pid, const char *file, char *buffer, int size) const;
+
+    const char *_root;
+};
+}
+
+#endif // PROCPARSER_H
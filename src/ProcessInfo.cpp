@@ -45,6 +45,10 @@
 #include <KSharedConfig>
 #include <KUser>
 
+#if defined(Q_OS_LINUX)
+#include "ProcParser.h"
+#endif
+
 #if defined(Q_OS_FREEBSD) || defined(Q_OS_OPENBSD) || defined(Q_OS_MACOS)
 #include <sys/sysctl.h>
 #endif
@@ -416,141 +420,44 @@ protected:
     bool readCurrentDir(int pid) Q_DECL_OVERRIDE
     {
         char path_buffer[MAXPATHLEN + 1];
-        path_buffer[MAXPATHLEN] = 0;
-        QByteArray procCwd = QFile::encodeName(QStringLiteral("/proc/%1/cwd").arg(pid));
-        const int length = static_cast<int>(readlink(procCwd.constData(), path_buffer, MAXPATHLEN));
-        if (length == -1) {
+        if (ProcParser().readCurrentDir(pid, path_buffer, sizeof(path_buffer)) == -1) {
             setError(UnknownError);
             return false;
         }
 
-        path_buffer[length] = '\0';
-        QString path = QFile::decodeName(path_buffer);
-
-        setCurrentDir(path);
+        setCurrentDir(QFile::decodeName(path_buffer));
         return true;
     }
 
 private:
     bool readProcInfo(int pid) Q_DECL_OVERRIDE
     {
-        // indicies of various fields within the process status file which
-        // contain various information about the process
-        const int PARENT_PID_FIELD = 3;
-        const int PROCESS_NAME_FIELD = 1;
-        const int GROUP_PROCESS_FIELD = 7;
-
-        QString parentPidString;
-        QString processNameString;
-        QString foregroundPidString;
-        QString uidLine;
-        QString uidString;
-        QStringList uidStrings;
-
-        // For user id read process status file ( /proc/<pid>/status )
-        //  Can not use getuid() due to it does not work for 'su'
-        QFile statusInfo(QStringLiteral("/proc/%1/status").arg(pid));
-        if (statusInfo.open(QIODevice::ReadOnly)) {
-            QTextStream stream(&statusInfo);
-            QString statusLine;
-            do {
-                statusLine = stream.readLine();
-                if (statusLine.startsWith(QLatin1String("Uid:"))) {
-                    uidLine = statusLine;
-                }
-            } while (!statusLine.isNull() && uidLine.isNull());
-
-            uidStrings << uidLine.split(QLatin1Char('\t'), QString::SkipEmptyParts);
-            // Must be 5 entries: 'Uid: %d %d %d %d' and
-            // uid string must be less than 5 chars (uint)
-            if (uidStrings.size() == 5) {
-                uidString = uidStrings[1];
-            }
-            if (uidString.size() > 5) {
-                uidString.clear();
-            }
-
-            bool ok = false;
-            const int uid = uidString.toInt(&ok);
-            if (ok) {
-                setUserId(uid);
-            }
-            // This will cause constant opening of /etc/passwd
-            if (userNameRequired()) {
-                readUserName();
-            }
-        } else {
-            setFileError(statusInfo.error());
-            return false;
-        }
-
-        // read process status file ( /proc/<pid/stat )
-        //
-        // the expected file format is a list of fields separated by spaces, using
-        // parenthesies to escape fields such as the process name which may itself contain
-        // spaces:
-        //
-        // FIELD FIELD (FIELD WITH SPACES) FIELD FIELD
-        //
-        QFile processInfo(QStringLiteral("/proc/%1/stat").arg(pid));
-        if (processInfo.open(QIODevice::ReadOnly)) {
-            QTextStream stream(&processInfo);
-            const QString &data = stream.readAll();
-
-            int stack = 0;
-            int field = 0;
-            int pos = 0;
-
-            while (pos < data.count()) {
-                QChar c = data[pos];
-
-                if (c == QLatin1Char('(')) {
-                    stack++;
-                } else if (c == QLatin1Char(')')) {
-                    stack--;
-                } else if (stack == 0 && c == QLatin1Char(' ')) {
-                    field++;
-                } else {
-                    switch (field) {
-                    case PARENT_PID_FIELD:
-                        parentPidString.append(c);
-                        break;
-                    case PROCESS_NAME_FIELD:
-                        processNameString.append(c);
-                        break;
-                    case GROUP_PROCESS_FIELD:
-                        foregroundPidString.append(c);
-                        break;
-                    }
-                }
-
-                pos++;
-            }
-        } else {
-            setFileError(processInfo.error());
+        ProcParser::ProcessStatus status;
+        int error = 0;
+        if (!ProcParser().readStatus(pid, status, &error)) {
+            setError(error == EACCES ? PermissionsError : UnknownError);
             return false;
         }
 
-        // check that data was read successfully
-        bool ok = false;
-        const int foregroundPid = foregroundPidString.toInt(&ok);
-        if (ok) {
-            setForegroundPid(foregroundPid);
+        // Can not use getuid() as it does not work for 'su'
+        if (status.userId != -1) {
+            setUserId(status.userId);
         }
-
-        const int parentPid = parentPidString.toInt(&ok);
-        if (ok) {
-            setParentPid(parentPid);
+        // This will cause constant opening of /etc/passwd
+        if (userNameRequired()) {
+            readUserName();
         }
 
-        if (!processNameString.isEmpty()) {
-            setName(processNameString);
+        setForegroundPid(status.foregroundPid);
+        setParentPid(status.parentPid);
+        if (status.name[0] != '\0') {
+            setName(QString::fromLocal8Bit(status.name));
         }
 
         // update object state
         setPid(pid);
 
-        return ok;
+        return true;
     }
 
     bool readArguments(int pid) Q_DECL_OVERRIDE
@@ -558,25 +465,28 @@ private:
         // read command-line arguments file found at /proc/<pid>/cmdline
         // the expected format is a list of strings delimited by null characters,
         // and ending in a double null character pair.
+        char buffer[ARGUMENTS_BUFFER_SIZE];
+        const int length = ProcParser().readArguments(pid, buffer, sizeof(buffer));
+        if (length == -1) {
+            setError(errno == EACCES ? PermissionsError : UnknownError);
+            return true;
+        }
 
-        QFile argumentsFile(QStringLiteral("/proc/%1/cmdline").arg(pid));
-        if (argumentsFile.open(QIODevice::ReadOnly)) {
-            QTextStream stream(&argumentsFile);
-            const QString &data = stream.readAll();
-
-            const QStringList &argList = data.split(QLatin1Char('\0'));
-
-            foreach (const QString &entry, argList) {
-                if (!entry.isEmpty()) {
-                    addArgument(entry);
+        int start = 0;
+        for (int i = 0; i <= length; i++) {
+            if (i == length || buffer[i] == '\0') {
+                if (i > start) {
+                    addArgument(QString::fromLocal8Bit(buffer + start, i - start));
                 }
+                start = i + 1;
             }
-        } else {
-            setFileError(argumentsFile.error());
         }
 
         return true;
     }
+
+    // longer command lines are truncated
+    static const int ARGUMENTS_BUFFER_SIZE = 16384;
 };
 
 #elif defined(Q_OS_FREEBSD)
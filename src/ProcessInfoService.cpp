@@ -0,0 +1,127 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "ProcessInfoService.h"
+
+// Qt
+#include <QTimer>
+
+// Konsole
+#include "Session.h"
+
+using namespace Konsole;
+
+ProcessInfoService::ProcessInfoService(QObject *parent) :
+    QObject(parent),
+    _sessions(QSet<Session *>()),
+    _requestedSessions(QSet<Session *>()),
+    _pollTimer(new QTimer(this)),
+    _requestTimer(new QTimer(this))
+{
+    _pollTimer->setInterval(POLL_INTERVAL);
+    connect(_pollTimer, &QTimer::timeout, this, &Konsole::ProcessInfoService::poll);
+
+    _requestTimer->setSingleShot(true);
+    connect(_requestTimer, &QTimer::timeout, this, &Konsole::ProcessInfoService::updateRequested);
+}
+
+ProcessInfoService::~ProcessInfoService() = default;
+
+void ProcessInfoService::addSession(Session *session)
+{
+    if (_sessions.contains(session)) {
+        return;
+    }
+
+    _sessions.insert(session);
+    connect(session, &QObject::destroyed, this, &Konsole::ProcessInfoService::sessionDestroyed);
+    connect(session, &Konsole::Session::foregroundProcessGroupChanged,
+            this, &Konsole::ProcessInfoService::foregroundProcessGroupChanged);
+
+    if (!_pollTimer->isActive()) {
+        _pollTimer->start();
+    }
+}
+
+void ProcessInfoService::removeSession(Session *session)
+{
+    if (!_sessions.remove(session)) {
+        return;
+    }
+
+    _requestedSessions.remove(session);
+    disconnect(session, nullptr, this, nullptr);
+
+    if (_sessions.isEmpty()) {
+        _pollTimer->stop();
+    }
+}
+
+void ProcessInfoService::sessionDestroyed(QObject *session)
+{
+    // the session is no longer a Session at this point, only its address is used
+    removeSession(static_cast<Session *>(session));
+}
+
+void ProcessInfoService::foregroundProcessGroupChanged()
+{
+    requestUpdate(qobject_cast<Session *>(sender()), PROCESS_CHANGE_DELAY);
+}
+
+void ProcessInfoService::requestUpdate(Session *session, int delay)
+{
+    if (!_sessions.contains(session)) {
+        return;
+    }
+
+    _requestedSessions.insert(session);
+    if (!_requestTimer->isActive() || _requestTimer->remainingTime() > delay) {
+        _requestTimer->start(delay);
+    }
+}
+
+void ProcessInfoService::poll()
+{
+    foreach (Session *session, _sessions) {
+        if (session->processInfoMayHaveChanged()) {
+            // sessions polled now do not need to be updated again shortly after
+            _requestedSessions.remove(session);
+            updateSession(session);
+        }
+    }
+}
+
+void ProcessInfoService::updateRequested()
+{
+    const QSet<Session *> sessions = _requestedSessions;
+    _requestedSessions.clear();
+
+    foreach (Session *session, sessions) {
+        updateSession(session);
+    }
+}
+
+void ProcessInfoService::updateSession(Session *session)
+{
+    if (session->isRunning()) {
+        session->refreshProcessInfo();
+    }
+}
@@ -0,0 +1,105 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef PROCESSINFOSERVICE_H
+#define PROCESSINFOSERVICE_H
+
+// Qt
+#include <QObject>
+#include <QSet>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QTimer;
+
+namespace Konsole {
+class Session;
+
+/**
+ * Keeps the process information of all sessions up to date.
+ *
+ * Sessions check the foreground process group of their terminal whenever
+ * there is input or output, which is cheap, and the service reads their
+ * processes shortly after it changed.  In addition a single timer polls
+ * the sessions which had input or output since they were last read once
+ * per POLL_INTERVAL, to notice changes of the working directory.  Idle
+ * sessions are not read at all.
+ *
+ * What was read is cached by the session for CACHE_TTL milliseconds, so
+ * that everything asking for the title, the working directory or the
+ * foreground process in the meantime shares it.  Sessions only emit
+ * Session::processInfoChanged() when their foreground process, working
+ * directory or title actually changed.
+ *
+ * The service is owned by the SessionManager.
+ */
+class KONSOLEPRIVATE_EXPORT ProcessInfoService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessInfoService(QObject *parent = nullptr);
+    ~ProcessInfoService() Q_DECL_OVERRIDE;
+
+    /** Starts polling @p session. */
+    void addSession(Session *session);
+    /** Stops polling @p session. */
+    void removeSession(Session *session);
+
+    /**
+     * Updates @p session after @p delay milliseconds, for example because the
+     * user typed something which may start or end a program.  Requests made
+     * before the delay runs out are handled together.
+     */
+    void requestUpdate(Session *session, int delay = REQUEST_DELAY);
+
+    /** The interval, in milliseconds, in which all sessions are polled */
+    static const int POLL_INTERVAL = 2000;
+    /** The default delay, in milliseconds, before requested updates are made */
+    static const int REQUEST_DELAY = 500;
+    /**
+     * The delay, in milliseconds, before a session whose foreground process
+     * group changed is updated.  This gives a new program the time to replace
+     * the forked shell, which it starts out as.
+     */
+    static const int PROCESS_CHANGE_DELAY = 50;
+    /** How long, in milliseconds, process information read from the system is reused */
+    static const int CACHE_TTL = 500;
+
+private Q_SLOTS:
+    void poll();
+    void updateRequested();
+    void sessionDestroyed(QObject *session);
+    void foregroundProcessGroupChanged();
+
+private:
+    Q_DISABLE_COPY(ProcessInfoService)
+
+    void updateSession(Session *session);
+
+    QSet<Session *> _sessions;
+    QSet<Session *> _requestedSessions;
+    QTimer *_pollTimer;
+    QTimer *_requestTimer;
+};
+}
+
+#endif // PROCESSINFOSERVICE_H
@@ -51,6 +51,7 @@ static const char TERMINAL_GROUP[]    = "Terminal Features";
 static const char CURSOR_GROUP[]      = "Cursor Options";
 static const char INTERACTION_GROUP[] = "Interaction Options";
 static const char ENCODING_GROUP[]    = "Encoding Options";
+static const char OUTPUT_LOG_GROUP[]  = "Output Log";
 
 const Profile::PropertyInfo Profile::DefaultPropertyNames[] = {
     // General
@@ -122,6 +123,13 @@ const Profile::PropertyInfo Profile::DefaultPropertyNames[] = {
     , { MiddleClickPasteMode, "MiddleClickPasteMode" , INTERACTION_GROUP , QVariant::Int }
     , { MouseWheelZoomEnabled, "MouseWheelZoomEnabled", INTERACTION_GROUP, QVariant::Bool }
 
+    // Output Log
+    , { OutputLogMode , "OutputLogMode" , OUTPUT_LOG_GROUP , QVariant::Int }
+    , { OutputLogDirectory , "OutputLogDirectory" , OUTPUT_LOG_GROUP , QVariant::String }
+    , { OutputLogMaxSize , "OutputLogMaxSize" , OUTPUT_LOG_GROUP , QVariant::Int }
+    , { OutputLogRotationInterval , "OutputLogRotationInterval" , OUTPUT_LOG_GROUP , QVariant::Int }
+    , { OutputLogCompressed , "OutputLogCompressed" , OUTPUT_LOG_GROUP , QVariant::Bool }
+
     // Encoding
     , { DefaultEncoding , "DefaultEncoding" , ENCODING_GROUP , QVariant::String }
 
@@ -214,6 +222,12 @@ void Profile::useFallback()
 
     setProperty(WordCharacters, QStringLiteral(":@-./_~?&=%+#"));
 
+    setProperty(OutputLogMode, Enum::NoOutputLog);
+    setProperty(OutputLogDirectory, QString());
+    setProperty(OutputLogMaxSize, 10);
+    setProperty(OutputLogRotationInterval, 0);
+    setProperty(OutputLogCompressed, false);
+
     // Fallback should not be shown in menus
     setHidden(true);
 }
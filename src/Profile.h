@@ -270,7 +270,26 @@ public:
          */
         MouseWheelZoomEnabled,
         /** (int) Keyboard modifiers to show URL hints */
-        UrlHintsModifiers
+        UrlHintsModifiers,
+        /** (OutputLogModeEnum) Specifies what is written to the output log.
+         *
+         * See Enum::OutputLogModeEnum
+         */
+        OutputLogMode,
+        /** (String) Directory of the output log files, the application's
+         * data directory is used if empty.
+         */
+        OutputLogDirectory,
+        /** (int) Size in MiB after which the next output log file is
+         * started, or 0 for no limit.
+         */
+        OutputLogMaxSize,
+        /** (int) Number of minutes after which the next output log file is
+         * started, or 0 to never start one because of its age.
+         */
+        OutputLogRotationInterval,
+        /** (bool) Whether output log files are compressed */
+        OutputLogCompressed
     };
 
     /**
@@ -556,6 +575,18 @@ public:
         return property<int>(Profile::SilenceSeconds);
     }
 
+    /** Convenience method for property<int>(Profile::OutputLogMode) */
+    int outputLogMode() const
+    {
+        return property<int>(Profile::OutputLogMode);
+    }
+
+    /** Convenience method for property<QString>(Profile::OutputLogDirectory) */
+    QString outputLogDirectory() const
+    {
+        return property<QString>(Profile::OutputLogDirectory);
+    }
+
     /** Convenience method for property<QString>(Profile::TerminalColumns) */
     int terminalColumns() const
     {
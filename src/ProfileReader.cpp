@@ -24,6 +24,7 @@
 
 // Qt
 #include <QFile>
+#include <QDataStream>
 #include <QDir>
 
 // KDE
@@ -32,6 +33,7 @@
 
 // Konsole
 #include "ShellCommand.h"
+#include "StartupCache.h"
 
 using namespace Konsole;
 
@@ -51,7 +53,7 @@ QStringList ProfileReader::findProfiles()
     profiles.reserve(dirs.size());
 
     Q_FOREACH (const QString& dir, dirs) {
-        const QStringList fileNames = QDir(dir).entryList(QStringList() << QStringLiteral("*.profile"));
+        const QStringList fileNames = StartupCache::instance()->entryList(dir, QStringLiteral("*.profile"));
         Q_FOREACH (const QString& file, fileNames) {
             profiles.append(dir + QLatin1Char('/') + file);
         }
@@ -83,12 +85,79 @@ void ProfileReader::readProperties(const KConfig& config, Profile::Ptr profile,
     }
 }
 
+// the properties read from a profile, as kept in the startup cache
+static QByteArray cachedProfile(const Profile::Ptr &profile, const QString &parentProfile)
+{
+    const QHash<Profile::Property, QVariant> properties = profile->setProperties();
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    stream << parentProfile << static_cast<quint32>(properties.size());
+    for (auto iter = properties.constBegin(); iter != properties.constEnd(); ++iter) {
+        stream << static_cast<qint32>(iter.key()) << iter.value();
+    }
+
+    return data;
+}
+
+static bool readCachedProfile(const QByteArray &data, const Profile::Ptr &profile, QString &parentProfile)
+{
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    QString parent;
+    quint32 count = 0;
+    stream >> parent >> count;
+
+    QHash<Profile::Property, QVariant> properties;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        qint32 property = 0;
+        QVariant value;
+        stream >> property >> value;
+        properties.insert(static_cast<Profile::Property>(property), value);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    for (auto iter = properties.constBegin(); iter != properties.constEnd(); ++iter) {
+        profile->setProperty(iter.key(), iter.value());
+    }
+    parentProfile = parent;
+
+    return true;
+}
+
 bool ProfileReader::readProfile(const QString& path , Profile::Ptr profile , QString& parentProfile)
 {
+    StartupCache *cache = StartupCache::instance();
+
+    // use the properties read before, unless the profile changed since
+    if (readCachedProfile(cache->data(path), profile, parentProfile)) {
+        return true;
+    }
+
     if (!QFile::exists(path)) {
         return false;
     }
 
+    parseProfile(path, profile, parentProfile);
+
+    // after the changes made while reading have been written back
+    cache->setData(path, cachedProfile(profile, parentProfile));
+
+    return true;
+}
+
+void ProfileReader::parseProfile(const QString &path, Profile::Ptr profile, QString &parentProfile)
+{
     KConfig config(path, KConfig::NoGlobals);
 
     KConfigGroup general = config.group(GENERAL_GROUP);
@@ -120,7 +189,5 @@ bool ProfileReader::readProfile(const QString& path , Profile::Ptr profile , QSt
 
     // Read remaining properties
     readProperties(config, profile, Profile::DefaultPropertyNames);
-
-    return true;
 }
 
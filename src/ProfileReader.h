@@ -42,6 +42,8 @@ public:
      * save the property values described into @p profile.
      *
      * Returns true if the profile was successfully read or false otherwise.
+     * The settings read are kept in the StartupCache, and read from there
+     * as long as the file is unchanged.
      *
      * @param path Path to the profile to read
      * @param profile Pointer to the Profile the settings will be read into
@@ -50,6 +52,7 @@ public:
     bool readProfile(const QString &path, Profile::Ptr profile, QString &parentProfile);
 
 private:
+    void parseProfile(const QString &path, Profile::Ptr profile, QString &parentProfile);
     void readProperties(const KConfig &config, Profile::Ptr profile,
                         const Profile::PropertyInfo *properties);
 };
@@ -34,6 +34,10 @@
 // KDE
 #include <KPtyDevice>
 
+// Konsole
+#include "PtyReadPump.h"
+#include "PtyRecording.h"
+
 using Konsole::Pty;
 
 Pty::Pty(int masterFd, QObject *aParent) :
@@ -55,6 +59,9 @@ void Pty::init()
     _eraseChar = 0;
     _xonXoff = true;
     _utf8 = true;
+    _statistics = nullptr;
+    _recorder = nullptr;
+    _inputWritten = 0;
 
     setEraseChar(_eraseChar);
     setFlowControlEnabled(_xonXoff);
@@ -66,9 +73,23 @@ void Pty::init()
     setPtyChannels(KPtyProcess::AllChannels);
 
     connect(pty(), &KPtyDevice::readyRead, this, &Konsole::Pty::dataReceived);
+    connect(pty(), &KPtyDevice::bytesWritten, this, &Konsole::Pty::writePendingInput);
+    // connected before anybody else, so that all output is passed on first
+    connect(this, static_cast<void(Pty::*)(int,QProcess::ExitStatus)>(&Konsole::Pty::finished),
+            this, &Konsole::Pty::readRemainingData);
+}
+
+Pty::~Pty()
+{
+    PtyReadPump *pump = PtyReadPump::instance();
+    if (pump != nullptr) {
+        pump->remove(this);
+    }
 }
 
-Pty::~Pty() = default;
+// the amount of input handed to the teletype at once, so that a large paste
+// does not fill up the write buffer while output waits to be read
+static const int INPUT_CHUNK_SIZE = 4096;
 
 void Pty::sendData(const QByteArray &data)
 {
@@ -76,24 +97,142 @@ void Pty::sendData(const QByteArray &data)
         return;
     }
 
-    if (pty()->write(data) == -1) {
+    if (_recorder != nullptr) {
+        _recorder->recordInput(data);
+    }
+
+    if (!_inputTimer.isValid() && _statistics != nullptr && _statistics->isEnabled()) {
+        _inputTimer.start();
+    }
+
+    // small amounts of input, such as key presses, are written directly
+    // unless they would overtake input which is still pending
+    if (_pendingInput.isEmpty() && data.size() <= INPUT_CHUNK_SIZE) {
+        if (pty()->write(data) == -1) {
+            qCDebug(KonsoleDebug) << "Could not send input data to terminal process.";
+        }
+        return;
+    }
+
+    _pendingInput.append(data);
+    writePendingInput();
+}
+
+void Pty::writePendingInput()
+{
+    // wait until the previous chunk has been written
+    if (pty()->bytesToWrite() > 0) {
+        return;
+    }
+
+    if (_pendingInput.isEmpty()) {
+        if (_inputTimer.isValid()) {
+            if (_statistics != nullptr) {
+                _statistics->addSample(PipelineStatistics::InputWrite, _inputTimer.nsecsElapsed());
+            }
+            _inputTimer.invalidate();
+        }
+        return;
+    }
+
+    const int length = qMin(INPUT_CHUNK_SIZE, _pendingInput.size() - _inputWritten);
+    if (pty()->write(_pendingInput.constData() + _inputWritten, length) == -1) {
         qCDebug(KonsoleDebug) << "Could not send input data to terminal process.";
+        cancelInput();
         return;
     }
+    _inputWritten += length;
+
+    const qint64 total = _pendingInput.size();
+    if (_inputWritten == _pendingInput.size()) {
+        _pendingInput.clear();
+        _inputWritten = 0;
+    }
+
+    emit inputProgress(total - pendingInputSize(), total);
 }
 
-void Pty::dataReceived()
+void Pty::cancelInput()
 {
-    QByteArray data = pty()->readAll();
-    if (data.isEmpty()) {
+    if (_pendingInput.isEmpty()) {
         return;
     }
 
-    emit receivedData(data.constData(), data.count());
+    _pendingInput.clear();
+    _inputWritten = 0;
+
+    emit inputProgress(0, 0);
+}
+
+qint64 Pty::pendingInputSize() const
+{
+    return _pendingInput.size() - _inputWritten;
+}
+
+void Pty::dataReceived()
+{
+    // the data is passed on when it is this terminal's turn
+    PtyReadPump::instance()->schedule(this);
+}
+
+bool Pty::readBlock(char *buffer, int size)
+{
+    qint64 length;
+    {
+        PipelineStatistics::StageTimer timer(_statistics, PipelineStatistics::PtyRead);
+        length = pty()->read(buffer, size);
+    }
+
+    if (length > 0) {
+        if (_statistics != nullptr) {
+            _statistics->add(PipelineStatistics::BytesIn, length);
+        }
+        if (_recorder != nullptr) {
+            _recorder->recordOutput(buffer, static_cast<int>(length));
+        }
+
+        emit receivedData(buffer, static_cast<int>(length));
+    }
+
+    if (pty()->bytesAvailable() > 0) {
+        return true;
+    }
+
+    setReadSuspended(false);
+    return false;
+}
+
+void Pty::setReadSuspended(bool suspended)
+{
+    if (pty()->masterFd() >= 0 && pty()->isSuspended() != suspended) {
+        pty()->setSuspended(suspended);
+    }
+}
+
+void Pty::readRemainingData()
+{
+    PtyReadPump *pump = PtyReadPump::instance();
+    if (pump != nullptr) {
+        pump->remove(this);
+    }
+
+    // also take what is left in the kernel's buffer
+    setReadSuspended(false);
+    if (pty()->masterFd() >= 0) {
+        pty()->waitForReadyRead(0);
+    }
+
+    char buffer[4096];
+    while (readBlock(buffer, sizeof(buffer))) {
+    }
 }
 
 void Pty::setWindowSize(int columns, int lines)
 {
+    if (_recorder != nullptr && (columns != _windowColumns || lines != _windowLines)) {
+        _recorder->recordResize(columns, lines);
+    }
+
     _windowColumns = columns;
     _windowLines = lines;
 
@@ -301,11 +440,22 @@ void Pty::sendEof()
     struct ::termios ttyAttributes;
     pty()->tcGetAttr(&ttyAttributes);
     char eofChar = ttyAttributes.c_cc[VEOF];
-    if (pty()->write(QByteArray(1, eofChar)) == -1) {
-        qCDebug(KonsoleDebug) << "Unable to send EOF";
+    // after any input which is still pending
+    sendData(QByteArray(1, eofChar));
+
+    if (_pendingInput.isEmpty()) {
+        pty()->waitForBytesWritten();
     }
+}
 
-    pty()->waitForBytesWritten();
+void Pty::setStatistics(PipelineStatistics *statistics)
+{
+    _statistics = statistics;
+}
+
+void Pty::setRecorder(PtyRecorder *recorder)
+{
+    _recorder = recorder;
 }
 
 int Pty::foregroundProcessGroup() const
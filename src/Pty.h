@@ -24,6 +24,7 @@
 #define PTY_H
 
 // Qt
+#include <QElapsedTimer>
 #include <QSize>
 
 // KDE
@@ -31,10 +32,13 @@
 
 // Konsole
 #include "konsoleprivate_export.h"
+#include "PipelineStatistics.h"
 
 class QStringList;
 
 namespace Konsole {
+class PtyRecorder;
+
 /**
  * The Pty class is used to start the terminal process,
  * send data to it, receive data from it and manipulate
@@ -142,6 +146,26 @@ public:
      */
     void sendEof();
 
+    /**
+     * Sets the statistics in which reads from the teletype are recorded.
+     * Usually these are the statistics of the emulation which the
+     * received data is passed to.
+     */
+    void setStatistics(PipelineStatistics *statistics);
+
+    /**
+     * Returns the number of bytes passed to sendData() which have not been
+     * written to the teletype yet.
+     */
+    qint64 pendingInputSize() const;
+
+    /**
+     * Sets the recorder which the data sent to and received from the
+     * teletype, and the changes of the window size, are recorded with,
+     * or nullptr to stop recording.  The recorder is not owned.
+     */
+    void setRecorder(PtyRecorder *recorder);
+
 public Q_SLOTS:
     /**
      * Put the pty into UTF-8 mode on systems which support it.
@@ -152,10 +176,21 @@ public Q_SLOTS:
      * Sends data to the process currently controlling the
      * teletype ( whose id is returned by foregroundProcessGroup() )
      *
+     * Large amounts of data are written in chunks whenever the teletype
+     * can accept more, so that output of the process continues to be read
+     * in the meantime.  Data sent while earlier data is still pending is
+     * written after it.
+     *
      * @param data the data to send.
      */
     void sendData(const QByteArray &data);
 
+    /**
+     * Discards the data passed to sendData() which has not been written
+     * to the teletype yet.
+     */
+    void cancelInput();
+
 Q_SIGNALS:
     /**
      * Emitted when a new block of data is received from
@@ -166,16 +201,40 @@ Q_SIGNALS:
      */
     void receivedData(const char *buffer, int length);
 
+    /**
+     * Emitted when a chunk of pending input has been written to the
+     * teletype.
+     *
+     * @param written The number of pending bytes written so far
+     * @param total The number of bytes which were pending, @p written
+     * equals @p total once all of them have been written.  After
+     * cancelInput() both are 0.
+     */
+    void inputProgress(qint64 written, qint64 total);
+
 protected:
     void setupChildProcess() Q_DECL_OVERRIDE;
 
 private Q_SLOTS:
     // called when data is received from the terminal process
     void dataReceived();
+    // passes on the data still buffered once the process finished
+    void readRemainingData();
+    // writes the next chunk of pending input once the teletype accepted
+    // the previous one
+    void writePendingInput();
 
 private:
+    friend class PtyReadPump;
+
     void init();
 
+    // reads a block of received data into buffer and emits receivedData(),
+    // returns true if there is more data
+    bool readBlock(char *buffer, int size);
+    // stops or resumes reading from the kernel's buffer
+    void setReadSuspended(bool suspended);
+
     // takes a list of key=value pairs and adds them
     // to the environment for the process
     void addEnvironmentVariables(const QStringList &environment);
@@ -185,6 +244,14 @@ private:
     char _eraseChar;
     bool _xonXoff;
     bool _utf8;
+    PipelineStatistics *_statistics;
+    PtyRecorder *_recorder;
+
+    // input not written yet, from _inputWritten on
+    QByteArray _pendingInput;
+    int _inputWritten;
+    // started when input is sent while none is waiting to be written
+    QElapsedTimer _inputTimer;
 };
 }
 
@@ -0,0 +1,91 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "PtyReadPump.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QTimer>
+
+// Konsole
+#include "Pty.h"
+
+using namespace Konsole;
+
+Q_GLOBAL_STATIC(PtyReadPump, thePtyReadPump)
+PtyReadPump *PtyReadPump::instance()
+{
+    return thePtyReadPump;
+}
+
+PtyReadPump::PtyReadPump() :
+    _scheduled(QList<Pty *>()),
+    _buffer(BLOCK_SIZE, Qt::Uninitialized),
+    _pumpTimer(new QTimer(this))
+{
+    // a zero timeout runs the pump once the pending events are handled
+    _pumpTimer->setSingleShot(true);
+    _pumpTimer->setInterval(0);
+    connect(_pumpTimer, &QTimer::timeout, this, &Konsole::PtyReadPump::pump);
+}
+
+PtyReadPump::~PtyReadPump() = default;
+
+void PtyReadPump::schedule(Pty *pty)
+{
+    if (!_scheduled.contains(pty)) {
+        _scheduled.append(pty);
+    }
+
+    if (!_pumpTimer->isActive()) {
+        _pumpTimer->start();
+    }
+}
+
+void PtyReadPump::remove(Pty *pty)
+{
+    _scheduled.removeAll(pty);
+}
+
+void PtyReadPump::pump()
+{
+    QElapsedTimer budget;
+    budget.start();
+
+    while (!_scheduled.isEmpty() && !budget.hasExpired(TIME_BUDGET)) {
+        // the terminal goes to the back of the queue if it has more data,
+        // so that the others get their turn first
+        Pty *pty = _scheduled.takeFirst();
+        if (pty->readBlock(_buffer.data(), _buffer.size())) {
+            _scheduled.append(pty);
+        }
+    }
+
+    if (_scheduled.isEmpty()) {
+        return;
+    }
+
+    // stop reading more data from the kernel than can be handled
+    foreach (Pty *pty, _scheduled) {
+        pty->setReadSuspended(true);
+    }
+    _pumpTimer->start();
+}
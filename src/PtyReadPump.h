@@ -0,0 +1,86 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef PTYREADPUMP_H
+#define PTYREADPUMP_H
+
+// Qt
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QTimer;
+
+namespace Konsole {
+class Pty;
+
+/**
+ * Passes the data received by all terminals on to their sessions, within
+ * a bounded time per iteration of the event loop.
+ *
+ * A Pty with data available schedules itself with the pump instead of
+ * handing all of it over at once.  Once per iteration of the event loop
+ * the pump takes turns between the scheduled terminals, reading a block
+ * of at most BLOCK_SIZE bytes from each, until all data is read or
+ * TIME_BUDGET milliseconds are spent.  A program flooding its terminal
+ * therefore cannot starve the other terminals, nor keep input and resize
+ * events from being handled.
+ *
+ * Terminals which still have data left when the time is spent stop
+ * reading from the kernel until the pump caught up with them.  The
+ * kernel's buffer then fills up, which blocks the writing program.
+ */
+class KONSOLEPRIVATE_EXPORT PtyReadPump : public QObject
+{
+    Q_OBJECT
+
+public:
+    PtyReadPump();
+    ~PtyReadPump() Q_DECL_OVERRIDE;
+
+    /** Returns the pump of the application. */
+    static PtyReadPump *instance();
+
+    /** Reads the data available from @p pty in the next iteration of the event loop. */
+    void schedule(Pty *pty);
+    /** Forgets about @p pty, which is about to be destroyed. */
+    void remove(Pty *pty);
+
+    /** The time, in milliseconds, spent reading terminals per event loop iteration */
+    static const int TIME_BUDGET = 10;
+    /** The maximum number of bytes read from one terminal before the next one's turn */
+    static const int BLOCK_SIZE = 16 * 1024;
+
+private Q_SLOTS:
+    void pump();
+
+private:
+    Q_DISABLE_COPY(PtyReadPump)
+
+    QList<Pty *> _scheduled; // in the order of their turns
+    QByteArray _buffer;      // reused for every block
+    QTimer *_pumpTimer;
+};
+}
+
+#endif // PTYREADPUMP_H
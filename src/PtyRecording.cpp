@@ -0,0 +1,282 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "PtyRecording.h"
+
+// Qt
+#include <QTimer>
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+// the start of every recording, followed by the version
+static const char MAGIC[] = "KPTYREC";
+static const int MAGIC_SIZE = sizeof(MAGIC) - 1;
+static const char VERSION = 1;
+
+// reads a number written by PtyRecorder::writeNumber() at position and
+// moves position past it, returns false if the data ends before the number
+static bool readNumber(const QByteArray &data, int &position, quint64 &number)
+{
+    number = 0;
+    for (int shift = 0; position < data.size() && shift < 64; shift += 7) {
+        const uchar byte = static_cast<uchar>(data.at(position++));
+        number |= quint64(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PtyRecorder::PtyRecorder() :
+    _file(),
+    _clock(),
+    _lastRecordTime(0)
+{
+}
+
+bool PtyRecorder::open(const QString &fileName, int columns, int lines)
+{
+    _file.close();
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    _file.write(MAGIC, MAGIC_SIZE);
+    _file.putChar(VERSION);
+
+    _clock.start();
+    _lastRecordTime = 0;
+    recordResize(columns, lines);
+    return true;
+}
+
+QString PtyRecorder::errorString() const
+{
+    return _file.errorString();
+}
+
+void PtyRecorder::recordOutput(const char *data, int length)
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    writeRecordStart(Output);
+    writeNumber(static_cast<quint64>(length));
+    _file.write(data, length);
+}
+
+void PtyRecorder::recordInput(const QByteArray &data)
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    writeRecordStart(Input);
+    writeNumber(static_cast<quint64>(data.size()));
+    _file.write(data);
+}
+
+void PtyRecorder::recordResize(int columns, int lines)
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    writeRecordStart(Resize);
+    writeNumber(static_cast<quint64>(columns));
+    writeNumber(static_cast<quint64>(lines));
+}
+
+void PtyRecorder::writeRecordStart(RecordType type)
+{
+    const qint64 time = _clock.nsecsElapsed() / 1000;
+
+    _file.putChar(static_cast<char>(type));
+    writeNumber(static_cast<quint64>(time - _lastRecordTime));
+    _lastRecordTime = time;
+}
+
+void PtyRecorder::writeNumber(quint64 number)
+{
+    char buffer[10];
+    int length = 0;
+    do {
+        const char byte = static_cast<char>(number & 0x7f);
+        number >>= 7;
+        buffer[length++] = number != 0 ? static_cast<char>(byte | 0x80) : byte;
+    } while (number != 0);
+
+    _file.write(buffer, length);
+}
+
+PtyReplay::PtyReplay(QObject *parent) :
+    QObject(parent),
+    _records(QVector<Record>()),
+    _nextRecord(-1),
+    _speed(0),
+    _clock(),
+    _timer(new QTimer(this)),
+    _duration(-1)
+{
+    _timer->setSingleShot(true);
+    _timer->setTimerType(Qt::PreciseTimer);
+    connect(_timer, &QTimer::timeout, this, &Konsole::PtyReplay::replayNext);
+}
+
+bool PtyReplay::load(const QString &fileName)
+{
+    stop();
+    _records.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(KonsoleDebug) << "Unable to open recording" << fileName << ":" << file.errorString();
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    if (!data.startsWith(QByteArray(MAGIC, MAGIC_SIZE) + VERSION)) {
+        qCWarning(KonsoleDebug) << fileName << "is not a recording of a supported version";
+        return false;
+    }
+
+    int position = MAGIC_SIZE + 1;
+    qint64 time = 0;
+    while (position < data.size()) {
+        const auto type = static_cast<PtyRecorder::RecordType>(data.at(position++));
+        quint64 delay;
+        if (!readNumber(data, position, delay)) {
+            break;
+        }
+        time += static_cast<qint64>(delay);
+
+        Record record;
+        record.type = type;
+        record.time = time;
+        record.columns = 0;
+        record.lines = 0;
+
+        if (type == PtyRecorder::Output || type == PtyRecorder::Input) {
+            quint64 length;
+            if (!readNumber(data, position, length)
+                || length > static_cast<quint64>(data.size() - position)) {
+                break;
+            }
+            // the input only tells what caused the output, it is not replayed
+            if (type == PtyRecorder::Output) {
+                record.data = data.mid(position, static_cast<int>(length));
+            }
+            position += static_cast<int>(length);
+        } else if (type == PtyRecorder::Resize) {
+            quint64 columns;
+            quint64 lines;
+            if (!readNumber(data, position, columns) || !readNumber(data, position, lines)) {
+                break;
+            }
+            // the size is set on the session, do not let a broken recording
+            // ask for an absurd amount of memory
+            if (columns == 0 || columns > static_cast<quint64>(MAX_COLUMNS)
+                || lines == 0 || lines > static_cast<quint64>(MAX_LINES)) {
+                qCWarning(KonsoleDebug) << "Invalid terminal size" << columns << "x" << lines
+                                        << "in" << fileName;
+                break;
+            }
+            record.columns = static_cast<int>(columns);
+            record.lines = static_cast<int>(lines);
+        } else {
+            qCWarning(KonsoleDebug) << "Unknown record in" << fileName << "at" << position - 1;
+            break;
+        }
+
+        if (type != PtyRecorder::Input) {
+            _records.append(record);
+        }
+    }
+
+    return true;
+}
+
+void PtyReplay::start(double speed)
+{
+    _speed = qMax(0.0, speed);
+    _nextRecord = 0;
+    _clock.start();
+    _timer->start(0);
+}
+
+void PtyReplay::stop()
+{
+    _timer->stop();
+    _nextRecord = -1;
+}
+
+bool PtyReplay::isActive() const
+{
+    return _nextRecord >= 0;
+}
+
+qint64 PtyReplay::duration() const
+{
+    return _duration;
+}
+
+void PtyReplay::replayNext()
+{
+    while (_nextRecord >= 0 && _nextRecord < _records.count()) {
+        // a copy, receivers may load another recording
+        const Record record = _records.at(_nextRecord);
+
+        if (_speed > 0) {
+            const auto due = static_cast<qint64>(record.time / _speed);
+            const qint64 now = _clock.nsecsElapsed() / 1000;
+            if (due > now) {
+                _timer->start(static_cast<int>((due - now + 999) / 1000));
+                return;
+            }
+        }
+
+        _nextRecord++;
+        if (record.type == PtyRecorder::Resize) {
+            emit resizeReplayed(record.columns, record.lines);
+        } else {
+            emit outputReplayed(record.data.constData(), record.data.size());
+
+            if (_speed <= 0) {
+                _timer->start(0);
+                return;
+            }
+        }
+    }
+
+    if (_nextRecord < 0) {
+        return;
+    }
+
+    _duration = _clock.elapsed();
+    _nextRecord = -1;
+    emit finished();
+}
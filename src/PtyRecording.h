@@ -0,0 +1,164 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef PTYRECORDING_H
+#define PTYRECORDING_H
+
+// Qt
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QVector>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QTimer;
+
+namespace Konsole {
+/**
+ * Records the data passing through a Pty, with its timing and the
+ * changes of the terminal size, so that the output of a session can
+ * be replayed exactly with PtyReplay.
+ *
+ * A recording starts with the bytes "KPTYREC" and a version byte, which
+ * is 1.  It is followed by records made of a type byte, the number of
+ * microseconds since the previous record and the type's data:
+ *
+ *  - Output: the length and the bytes received from the terminal
+ *  - Input: the length and the bytes sent to the terminal
+ *  - Resize: the number of columns and lines
+ *
+ * Numbers are written as unsigned LEB128, 7 bits per byte with the
+ * least significant first.  The first record is the size of the
+ * terminal when the recording started.
+ */
+class KONSOLEPRIVATE_EXPORT PtyRecorder
+{
+public:
+    enum RecordType {
+        Output = 0,
+        Input = 1,
+        Resize = 2
+    };
+
+    PtyRecorder();
+
+    /**
+     * Starts recording to @p fileName, whose contents are replaced, for a
+     * terminal of @p columns by @p lines characters.  Returns false if the
+     * file could not be opened, see errorString().
+     */
+    bool open(const QString &fileName, int columns, int lines);
+    /** Returns a description of the last error. */
+    QString errorString() const;
+
+    void recordOutput(const char *data, int length);
+    void recordInput(const QByteArray &data);
+    void recordResize(int columns, int lines);
+
+private:
+    Q_DISABLE_COPY(PtyRecorder)
+
+    void writeRecordStart(RecordType type);
+    void writeNumber(quint64 number);
+
+    QFile _file;
+    QElapsedTimer _clock;
+    qint64 _lastRecordTime;     // microseconds since the recording started
+};
+
+/**
+ * Plays the output and the size changes of a recording made by
+ * PtyRecorder, at the original speed, faster or as fast as possible.
+ * The input recorded is skipped.
+ */
+class KONSOLEPRIVATE_EXPORT PtyReplay : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PtyReplay(QObject *parent = nullptr);
+
+    /**
+     * Reads the recording in @p fileName.  Returns false if it is not
+     * a recording; a recording cut short is read up to the last
+     * complete record.
+     */
+    bool load(const QString &fileName);
+
+    /**
+     * Starts replaying the loaded recording, @p speed times as fast as
+     * it was recorded, or as fast as possible if @p speed is 0.  As fast
+     * as possible passes one block of output at a time and returns to
+     * the event loop in between, so that the output is drawn as usual.
+     */
+    void start(double speed);
+    /** Stops replaying. */
+    void stop();
+    /** Returns true while replaying. */
+    bool isActive() const;
+
+    /**
+     * Returns the number of milliseconds which the last complete replay
+     * took, or -1 if there was none yet.
+     */
+    qint64 duration() const;
+
+    /**
+     * The largest terminal size replayed.  A recording is only read up to
+     * a resize beyond these, as it is for a recording cut short.
+     */
+    static const int MAX_COLUMNS = 2048;
+    static const int MAX_LINES = 1024;
+
+Q_SIGNALS:
+    /** Emitted for each block of output replayed. */
+    void outputReplayed(const char *data, int length);
+    /** Emitted when the terminal size changes in the recording. */
+    void resizeReplayed(int columns, int lines);
+    /** Emitted when everything has been replayed. */
+    void finished();
+
+private Q_SLOTS:
+    void replayNext();
+
+private:
+    Q_DISABLE_COPY(PtyReplay)
+
+    struct Record {
+        PtyRecorder::RecordType type;
+        qint64 time;        // microseconds since the recording started
+        QByteArray data;
+        int columns;
+        int lines;
+    };
+
+    QVector<Record> _records;
+    int _nextRecord;
+    double _speed;
+    QElapsedTimer _clock;
+    QTimer *_timer;
+    qint64 _duration;
+};
+}
+
+#endif // PTYRECORDING_H
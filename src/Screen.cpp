@@ -60,6 +60,7 @@ Screen::Screen(int lines, int columns):
     _screenLinesSize(_lines),
     _scrolledLines(0),
     _droppedLines(0),
+    _scrolledOffLines(0),
     _history(new HistoryScrollNone()),
     _cuX(0),
     _cuY(0),
@@ -801,6 +802,11 @@ int Screen::droppedLines() const
 {
     return _droppedLines;
 }
+
+qint64 Screen::scrolledOffLines() const
+{
+    return _scrolledOffLines;
+}
 void Screen::resetDroppedLines()
 {
     _droppedLines = 0;
@@ -1420,6 +1426,8 @@ void Screen::addHistLine()
     // add line to history buffer
     // we have to take care about scrolling, too...
 
+    _scrolledOffLines++;
+
     if (hasScroll()) {
         const int oldHistLines = _history->getLines();
 
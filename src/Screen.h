@@ -565,6 +565,13 @@ public:
      */
     void resetDroppedLines();
 
+    /**
+     * Returns the number of lines which have scrolled off the top of the
+     * screen since it was created, including those which the history
+     * did not keep or has dropped since.
+     */
+    qint64 scrolledOffLines() const;
+
     /**
       * Fills the buffer @p dest with @p count instances of the default (ie. blank)
       * Character style.
@@ -662,6 +669,7 @@ private:
     QRect _lastScrolledRegion;
 
     int _droppedLines;
+    qint64 _scrolledOffLines;
 
     QVarLengthArray<LineProperty, 64> _lineProperties;
 
@@ -27,6 +27,7 @@ using namespace Konsole;
 
 ScreenWindow::ScreenWindow(Screen *screen, QObject *parent) :
     QObject(parent),
+    _statistics(nullptr),
     _windowBuffer(nullptr),
     _windowBufferSize(0),
     _bufferNeedsUpdate(true),
@@ -56,6 +57,16 @@ Screen *ScreenWindow::screen() const
     return _screen;
 }
 
+void ScreenWindow::setStatistics(PipelineStatistics *statistics)
+{
+    _statistics = statistics;
+}
+
+PipelineStatistics *ScreenWindow::statistics() const
+{
+    return _statistics;
+}
+
 Character *ScreenWindow::getImage()
 {
     // reallocate internal buffer if the window size has changed
@@ -71,6 +82,8 @@ Character *ScreenWindow::getImage()
         return _windowBuffer;
     }
 
+    PipelineStatistics::StageTimer timer(_statistics, PipelineStatistics::GetImage);
+
     _screen->getImage(_windowBuffer, size,
                       currentLine(), endWindowLine());
 
@@ -28,6 +28,7 @@
 // Konsole
 #include "Character.h"
 #include "Screen.h"
+#include "PipelineStatistics.h"
 
 namespace Konsole {
 
@@ -70,6 +71,14 @@ public:
     /** Returns the screen which this window looks onto */
     Screen *screen() const;
 
+    /**
+     * Sets the statistics of the output pipeline which this window is part of.
+     * Views use them to record their own stages.
+     */
+    void setStatistics(PipelineStatistics *statistics);
+    /** Returns the pipeline statistics set with setStatistics(), or null */
+    PipelineStatistics *statistics() const;
+
     /**
      * Returns the image of characters which are currently visible through this window
      * onto the screen.
@@ -264,6 +273,7 @@ private:
     void fillUnusedArea();
 
     Screen *_screen; // see setScreen() , screen()
+    PipelineStatistics *_statistics; // see setStatistics() , statistics()
     Character *_windowBuffer;
     int _windowBufferSize;
     bool _bufferNeedsUpdate;
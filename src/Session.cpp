@@ -34,8 +34,10 @@
 #include <QColor>
 #include <QDir>
 #include <QFile>
+#include <QScopedPointer>
 #include <QStringList>
 #include <QKeyEvent>
+#include <QTextStream>
 
 // KDE
 #include <KLocalizedString>
@@ -49,10 +51,15 @@
 #include <sessionadaptor.h>
 
 #include "ProcessInfo.h"
+#include "ProcessInfoService.h"
 #include "Pty.h"
+#include "PtyRecording.h"
+#include "TerminalCharacterDecoder.h"
 #include "TerminalDisplay.h"
 #include "ShellCommand.h"
+#include "StartupTrace.h"
 #include "Vt102Emulation.h"
+#include "SessionLogger.h"
 #include "ZModemDialog.h"
 #include "History.h"
 #include "konsoledebug.h"
@@ -78,10 +85,17 @@ Session::Session(QObject* parent) :
     , _sessionProcessInfo(nullptr)
     , _foregroundProcessInfo(nullptr)
     , _foregroundPid(0)
+    , _checkedForegroundProcessGroup(0)
+    , _processInfoMayHaveChanged(true)
+    , _reportedForegroundPid(0)
     , _zmodemBusy(false)
     , _zmodemProc(nullptr)
     , _zmodemProgress(nullptr)
     , _hasDarkBackground(false)
+    , _outputSequence(0)
+    , _outputLogger(nullptr)
+    , _recorder(nullptr)
+    , _replay(nullptr)
 {
     _uniqueIdentifier = QUuid::createUuid();
 
@@ -103,6 +117,7 @@ Session::Session(QObject* parent) :
     connect(_emulation, &Konsole::Emulation::selectionChanged, this, &Konsole::Session::selectionChanged);
     connect(_emulation, &Konsole::Emulation::imageResizeRequest, this, &Konsole::Session::resizeRequest);
     connect(_emulation, &Konsole::Emulation::sessionAttributeRequest, this, &Konsole::Session::sessionAttributeRequest);
+    connect(_emulation, &Konsole::Emulation::sendData, this, &Konsole::Session::checkForegroundProcessGroup);
 
     //create new teletype for I/O with shell process
     openTeletype(-1);
@@ -124,6 +139,9 @@ Session::~Session()
     delete _emulation;
     delete _shellProcess;
     delete _zmodemProc;
+    delete _recorder;
+    // waits for the pending output to be written
+    delete _outputLogger;
 }
 
 void Session::openTeletype(int fd)
@@ -142,10 +160,13 @@ void Session::openTeletype(int fd)
     }
 
     _shellProcess->setUtf8Mode(_emulation->utf8());
+    _shellProcess->setStatistics(_emulation->statistics());
+    _shellProcess->setRecorder(_recorder);
 
     // connect the I/O between emulator and pty process
     connect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::onReceiveBlock);
     connect(_emulation, &Konsole::Emulation::sendData, _shellProcess, &Konsole::Pty::sendData);
+    connect(_shellProcess, &Konsole::Pty::inputProgress, this, &Konsole::Session::inputProgress);
 
     // UTF8 mode
     connect(_emulation, &Konsole::Emulation::useUtf8Request, _shellProcess, &Konsole::Pty::setUtf8Mode);
@@ -203,6 +224,18 @@ void Session::setCodec(QTextCodec* codec)
     emulation()->setCodec(codec);
 }
 
+void Session::setOutputLogger(SessionLogger *logger)
+{
+    if (_outputLogger != nullptr) {
+        _outputLogger->close();
+    }
+
+    _outputLogger = logger;
+    if (_outputLogger != nullptr && !_outputLogger->isRunning()) {
+        _outputLogger->start(QThread::LowPriority);
+    }
+}
+
 bool Session::setCodec(const QByteArray& name)
 {
     QTextCodec* codec = QTextCodec::codecForName(name);
@@ -380,6 +413,8 @@ QString Session::shellSessionId() const
 
 void Session::run()
 {
+    StartupTrace::Phase phase("Session::run");
+
     // FIXME: run() is called twice in some instances
     if (isRunning()) {
         qCDebug(KonsoleDebug) << "Attempted to re-run an already running session (" << _shellProcess->pid() << ")";
@@ -453,7 +488,9 @@ void Session::run()
     const QString dbusObject = QStringLiteral("/Sessions/%1").arg(QString::number(_sessionId));
     addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_SESSION=%1").arg(dbusObject));
 
+    StartupTrace::beginPhase("Pty::start");
     int result = _shellProcess->start(exec, arguments, _environment);
+    StartupTrace::endPhase("Pty::start");
     if (result < 0) {
         terminalWarning(i18n("Could not start program '%1' with arguments '%2'.", exec, arguments.join(QLatin1String(" "))));
         terminalWarning(_shellProcess->errorString());
@@ -552,6 +589,9 @@ void Session::setTabTitleFormat(TabTitleContext context , const QString& format)
     } else if (context == RemoteTabTitle) {
         _remoteTabTitleFormat = format;
     }
+
+    // the title needs to be formatted again
+    _processInfoMayHaveChanged = true;
 }
 QString Session::tabTitleFormat(TabTitleContext context) const
 {
@@ -706,6 +746,97 @@ void Session::updateTerminalSize()
         _emulation->setImageSize(minLines , minColumns);
     }
 }
+void Session::setHeadlessSize(int lines, int columns)
+{
+    if (!_views.isEmpty() || lines < 1 || columns < 1) {
+        return;
+    }
+
+    // the first size set starts the shell, as it does for a new view
+    _emulation->setImageSize(lines, columns);
+}
+
+QString Session::screenText() const
+{
+    return linesText(historyLineCount(), _emulation->lineCount() - 1);
+}
+
+int Session::historyLineCount() const
+{
+    return _emulation->lineCount() - _emulation->imageSize().height();
+}
+
+QString Session::historyText(int startLine, int endLine) const
+{
+    return linesText(qMax(startLine, 0), qMin(endLine, historyLineCount() - 1));
+}
+
+QString Session::linesText(int startLine, int endLine) const
+{
+    if (startLine > endLine) {
+        return QString();
+    }
+
+    QString text;
+    QTextStream stream(&text);
+    PlainTextDecoder decoder;
+    decoder.begin(&stream);
+    _emulation->writeToStream(&decoder, startLine, endLine);
+    decoder.end();
+
+    return text;
+}
+
+qlonglong Session::outputSequence()
+{
+    // the cursor moving up does not make the lines below it new again
+    _outputSequence = qMax(_outputSequence, _emulation->outputLine());
+    return _outputSequence;
+}
+
+QString Session::outputText(qlonglong startLine, qlonglong endLine, int format) const
+{
+    QString text;
+    QTextStream stream(&text);
+    decodeOutput(&stream, startLine, endLine, format);
+
+    return text;
+}
+
+qlonglong Session::writeOutput(qlonglong startLine, int format, const QDBusUnixFileDescriptor &fd)
+{
+    const qint64 sequence = outputSequence();
+
+    QFile file;
+    if (!fd.isValid()
+        || !file.open(fd.fileDescriptor(), QIODevice::WriteOnly, QFileDevice::DontCloseHandle)) {
+        qCDebug(KonsoleDebug) << "Unable to write the output of session" << _sessionId;
+        return startLine;
+    }
+
+    // the stream writes to the file whenever its buffer fills up
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    decodeOutput(&stream, startLine, sequence - 1, format);
+    stream.flush();
+
+    return sequence;
+}
+
+void Session::decodeOutput(QTextStream *stream, qint64 startLine, qint64 endLine, int format) const
+{
+    QScopedPointer<TerminalCharacterDecoder> decoder;
+    if (format == HtmlOutput) {
+        decoder.reset(new HTMLDecoder());
+    } else {
+        decoder.reset(new PlainTextDecoder());
+    }
+
+    decoder->begin(stream);
+    _emulation->writeOutputToStream(decoder.data(), startLine, endLine);
+    decoder->end();
+}
+
 void Session::updateWindowSize(int lines, int columns)
 {
     Q_ASSERT(lines > 0 && columns > 0);
@@ -842,7 +973,7 @@ void Session::sendTextToTerminal(const QString& text, const QChar& eol) const
 }
 
 // Only D-Bus calls this function (via SendText or runCommand)
-void Session::sendText(const QString& text) const
+void Session::sendText(const QString& text)
 {
 #if !defined(REMOVE_SENDTEXT_RUNCOMMAND_DBUS_METHODS)
     if (show_disallow_certain_dbus_methods_message) {
@@ -854,26 +985,42 @@ void Session::sendText(const QString& text) const
     }
 #endif
 
+    if (!isRunning()) {
+        emit runRequested();
+    }
+
     _emulation->sendText(text);
 }
 
 // Only D-Bus calls this function
-void Session::runCommand(const QString& command) const
+void Session::runCommand(const QString& command)
 {
     sendText(command + QLatin1Char('\n'));
 }
 
 void Session::sendMouseEvent(int buttons, int column, int line, int eventType)
 {
+    if (!isRunning()) {
+        emit runRequested();
+    }
+
     _emulation->sendMouseEvent(buttons, column, line, eventType);
 }
 
+void Session::cancelInput()
+{
+    _shellProcess->cancelInput();
+}
+
 void Session::done(int exitCode, QProcess::ExitStatus exitStatus)
 {
     // This slot should be triggered only one time
     disconnect(_shellProcess, static_cast<void(Pty::*)(int,QProcess::ExitStatus)>(&Konsole::Pty::finished),
                this, &Konsole::Session::done);
 
+    // the program in the foreground is gone along with the shell
+    checkForegroundProcessGroup();
+
     if (!_autoClose) {
         _userTitle = i18nc("@info:shell This session is done", "Finished");
         emit titleChanged();
@@ -996,8 +1143,17 @@ void Session::updateSessionProcessInfo()
         _sessionProcessInfo = ProcessInfo::newInstance(processId(),
                     tabTitleFormat(Session::LocalTabTitle));
         _sessionProcessInfo->setUserHomeDir();
+        _sessionProcessInfoRead.start();
+        _emulation->statistics()->add(PipelineStatistics::ProcessInfoReads, 1);
+    }
+
+    // reuse what was read recently, many callers ask in quick succession
+    if (!_sessionProcessInfoRead.isValid()
+            || _sessionProcessInfoRead.hasExpired(ProcessInfoService::CACHE_TTL)) {
+        _sessionProcessInfo->update();
+        _sessionProcessInfoRead.start();
+        _emulation->statistics()->add(PipelineStatistics::ProcessInfoReads, 1);
     }
-    _sessionProcessInfo->update();
 }
 
 bool Session::updateForegroundProcessInfo()
@@ -1010,16 +1166,53 @@ bool Session::updateForegroundProcessInfo()
         _foregroundProcessInfo = ProcessInfo::newInstance(foregroundPid,
                     tabTitleFormat(Session::LocalTabTitle));
         _foregroundPid = foregroundPid;
+        _foregroundProcessInfoRead.start();
+        _emulation->statistics()->add(PipelineStatistics::ProcessInfoReads, 1);
     }
 
     if (_foregroundProcessInfo != nullptr) {
-        _foregroundProcessInfo->update();
+        if (!_foregroundProcessInfoRead.isValid()
+                || _foregroundProcessInfoRead.hasExpired(ProcessInfoService::CACHE_TTL)) {
+            _foregroundProcessInfo->update();
+            _foregroundProcessInfoRead.start();
+            _emulation->statistics()->add(PipelineStatistics::ProcessInfoReads, 1);
+        }
         return _foregroundProcessInfo->isValid();
     } else {
         return false;
     }
 }
 
+void Session::refreshProcessInfo()
+{
+    // read the processes again, instead of using what is cached
+    _sessionProcessInfoRead.invalidate();
+    _foregroundProcessInfoRead.invalidate();
+    _processInfoMayHaveChanged = false;
+
+    const int foregroundPid = _shellProcess->foregroundProcessGroup();
+    _checkedForegroundProcessGroup = foregroundPid;
+    const QString title = getDynamicTitle();
+    const QString workingDir = currentWorkingDirectory();
+
+    if (foregroundPid == _reportedForegroundPid
+            && workingDir == _reportedWorkingDir
+            && title == _reportedDynamicTitle) {
+        return;
+    }
+
+    _reportedForegroundPid = foregroundPid;
+    _reportedWorkingDir = workingDir;
+    _reportedDynamicTitle = title;
+
+    emit processInfoChanged();
+}
+
+bool Session::processInfoMayHaveChanged() const
+{
+    return _processInfoMayHaveChanged;
+}
+
 bool Session::isRemote()
 {
     ProcessInfo* process = getProcessInfo();
@@ -1371,7 +1564,27 @@ void Session::zmodemFinished()
 
 void Session::onReceiveBlock(const char* buf, int len)
 {
+    // the prompt of the first session completes Konsole's startup
+    StartupTrace::finish("first output");
+
+    if (_outputLogger != nullptr) {
+        _outputLogger->log(buf, len);
+    }
+
     _emulation->receiveData(buf, len);
+    checkForegroundProcessGroup();
+}
+
+void Session::checkForegroundProcessGroup()
+{
+    _processInfoMayHaveChanged = true;
+
+    // this only asks the terminal, the processes are read once it changed
+    const int foregroundProcessGroup = _shellProcess->foregroundProcessGroup();
+    if (foregroundProcessGroup != _checkedForegroundProcessGroup) {
+        _checkedForegroundProcessGroup = foregroundProcessGroup;
+        emit foregroundProcessGroupChanged();
+    }
 }
 
 QSize Session::size()
@@ -1483,6 +1696,100 @@ int Session::historySize() const
     }
 }
 
+void Session::setPipelineStatisticsEnabled(bool enabled)
+{
+    _emulation->statistics()->setEnabled(enabled);
+
+    // show or remove the overlay, if any
+    foreach(TerminalDisplay* view, _views) {
+        view->update();
+    }
+}
+
+bool Session::pipelineStatisticsEnabled() const
+{
+    return _emulation->statistics()->isEnabled();
+}
+
+void Session::setPipelineStatisticsOverlayVisible(bool visible)
+{
+    _emulation->statistics()->setOverlayVisible(visible);
+
+    foreach(TerminalDisplay* view, _views) {
+        view->update();
+    }
+}
+
+QString Session::pipelineStatistics() const
+{
+    return _emulation->statistics()->report();
+}
+
+void Session::resetPipelineStatistics()
+{
+    _emulation->statistics()->reset();
+}
+
+bool Session::startRecording(const QString &fileName)
+{
+    stopRecording();
+
+    auto recorder = new PtyRecorder();
+    const QSize size = _emulation->imageSize();
+    if (!recorder->open(fileName, size.width(), size.height())) {
+        qCWarning(KonsoleDebug) << "Unable to record to" << fileName << ":" << recorder->errorString();
+        delete recorder;
+        return false;
+    }
+
+    _recorder = recorder;
+    _shellProcess->setRecorder(_recorder);
+    return true;
+}
+
+void Session::stopRecording()
+{
+    _shellProcess->setRecorder(nullptr);
+    delete _recorder;
+    _recorder = nullptr;
+}
+
+bool Session::replayRecording(const QString &fileName, double speed)
+{
+    if (_replay == nullptr) {
+        _replay = new PtyReplay(this);
+        connect(_replay, &Konsole::PtyReplay::outputReplayed, _emulation, &Konsole::Emulation::receiveData);
+        connect(_replay, &Konsole::PtyReplay::resizeReplayed, this, &Konsole::Session::replayResize);
+        connect(_replay, &Konsole::PtyReplay::finished, this, &Konsole::Session::replayFinished);
+    }
+
+    if (!_replay->load(fileName)) {
+        return false;
+    }
+
+    _replay->start(speed);
+    return true;
+}
+
+bool Session::isReplaying() const
+{
+    return _replay != nullptr && _replay->isActive();
+}
+
+qlonglong Session::replayDuration() const
+{
+    return _replay != nullptr ? _replay->duration() : -1;
+}
+
+void Session::replayResize(int columns, int lines)
+{
+    if (_views.isEmpty()) {
+        setHeadlessSize(lines, columns);
+    } else {
+        setSize(QSize(columns, lines));
+    }
+}
+
 int Session::foregroundProcessId()
 {
     int pid;
@@ -1519,7 +1826,12 @@ QString Session::foregroundProcessName()
 
 void Session::saveSession(KConfigGroup& group)
 {
-    group.writePathEntry("WorkingDir", currentWorkingDirectory());
+    // sessions restored on demand may not have been started yet
+    if (isRunning() || !_currentWorkingDir.isEmpty()) {
+        group.writePathEntry("WorkingDir", currentWorkingDirectory());
+    } else {
+        group.writePathEntry("WorkingDir", _initialWorkingDir);
+    }
     group.writeEntry("LocalTab",       tabTitleFormat(LocalTabTitle));
     group.writeEntry("RemoteTab",      tabTitleFormat(RemoteTabTitle));
     group.writeEntry("SessionGuid",    _uniqueIdentifier.toString());
@@ -1568,7 +1880,7 @@ QString Session::validDirectory(const QString& dir) const
 }
 
 SessionGroup::SessionGroup(QObject* parent)
-    : QObject(parent), _masterMode(0)
+    : QObject(parent), _masterMode(0), _forwardedData(QByteArray())
 {
 }
 SessionGroup::~SessionGroup() = default;
@@ -1628,10 +1940,12 @@ void SessionGroup::setMasterStatus(Session* session , bool master)
                    this, &Konsole::SessionGroup::forwardData);
     }
 }
+// set while the input of the masters of a group is copied to its other sessions
+static bool inForwardData = false;
+
 void SessionGroup::forwardData(const QByteArray& data)
 {
-    static bool _inForwardData = false;
-    if (_inForwardData) {  // Avoid recursive calls among session groups!
+    if (inForwardData) {  // Avoid recursive calls among session groups!
         // A recursive call happens when a master in group A calls forwardData()
         // in group B. If one of the destination sessions in group B is also a
         // master of a group including the master session of group A, this would
@@ -1639,13 +1953,22 @@ void SessionGroup::forwardData(const QByteArray& data)
         return;
     }
 
-    _inForwardData = true;
+    if (_forwardedData.isEmpty()) {
+        QTimer::singleShot(0, this, &Konsole::SessionGroup::flushForwardedData);
+    }
+    _forwardedData.append(data);
+}
+
+void SessionGroup::flushForwardedData()
+{
+    inForwardData = true;
+    const QByteArray data = _forwardedData;
+    _forwardedData.clear();
     const QList<Session*> sessionsKeys = _sessions.keys();
     foreach(Session* other, sessionsKeys) {
         if (!_sessions[other]) {
             other->emulation()->sendString(data);
         }
     }
-    _inForwardData = false;
+    inForwardData = false;
 }
-
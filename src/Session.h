@@ -26,12 +26,14 @@
 
 // Qt
 #include <QStringList>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QUuid>
 #include <QSize>
 #include <QProcess>
 #include <QWidget>
 #include <QUrl>
+#include <QDBusUnixFileDescriptor>
 
 // Konsole
 #include "konsoleprivate_export.h"
@@ -50,6 +52,9 @@ class ProcessInfo;
 class TerminalDisplay;
 class ZModemDialog;
 class HistoryType;
+class SessionLogger;
+class PtyRecorder;
+class PtyReplay;
 
 /**
  * Represents a terminal session consisting of a pseudo-teletype and a terminal emulation.
@@ -243,6 +248,17 @@ public:
         DisplayedTitleRole
     };
 
+    /**
+     * This enum describes the formats in which the output of the
+     * session can be read, see outputText().
+     */
+    enum OutputFormat {
+        /** Plain text. */
+        PlainTextOutput = 0,
+        /** HTML, which keeps the colors and appearance of the text. */
+        HtmlOutput = 1
+    };
+
     /**
      * Return the session title set by the user (ie. the program running
      * in the terminal), or an empty string if the user has not set a custom title
@@ -298,6 +314,22 @@ public:
     /** Returns the name of the current foreground process. */
     QString foregroundProcessName();
 
+    /**
+     * Reads the state of the session's processes again and emits
+     * processInfoChanged() if the foreground process, the working directory
+     * or the dynamic title changed since the last call.
+     *
+     * This is called by the ProcessInfoService.
+     */
+    void refreshProcessInfo();
+
+    /**
+     * Returns true if there was input or output since the last call to
+     * refreshProcessInfo(), so that the state of the session's processes
+     * may have changed.
+     */
+    bool processInfoMayHaveChanged() const;
+
     /** Returns the terminal session's window size in lines and columns. */
     QSize size();
     /**
@@ -355,6 +387,14 @@ public:
     // Sets the text codec used by this sessions terminal emulation.
     void setCodec(QTextCodec *codec);
 
+    /**
+     * Writes the output received from the terminal to @p logger, which is
+     * started if needed and owned by the session.  The previous logger is
+     * closed once it has written what it was given.  Pass nullptr to stop
+     * logging.
+     */
+    void setOutputLogger(SessionLogger *logger);
+
     // session management
     void saveSession(KConfigGroup &group);
     void restoreSession(KConfigGroup &group);
@@ -471,18 +511,18 @@ public Q_SLOTS:
     void sendTextToTerminal(const QString &text, const QChar &eol = QChar()) const;
 
 #if defined(REMOVE_SENDTEXT_RUNCOMMAND_DBUS_METHODS)
-    void sendText(const QString &text) const;
+    void sendText(const QString &text);
 #else
-    Q_SCRIPTABLE void sendText(const QString &text) const;
+    Q_SCRIPTABLE void sendText(const QString &text);
 #endif
 
     /**
      * Sends @p command to the current foreground terminal program.
      */
 #if defined(REMOVE_SENDTEXT_RUNCOMMAND_DBUS_METHODS)
-    void runCommand(const QString &command) const;
+    void runCommand(const QString &command);
 #else
-    Q_SCRIPTABLE void runCommand(const QString &command) const;
+    Q_SCRIPTABLE void runCommand(const QString &command);
 #endif
 
     /**
@@ -492,6 +532,58 @@ public Q_SLOTS:
      */
     Q_SCRIPTABLE void sendMouseEvent(int buttons, int column, int line, int eventType);
 
+    /**
+     * Discards text sent to the terminal program which it has not
+     * read yet, such as the rest of a large paste.
+     * See inputProgress()
+     */
+    Q_SCRIPTABLE void cancelInput();
+
+    /**
+     * Sets the size of the terminal to @p lines by @p columns while the
+     * session has no view; once views are added, they determine the size.
+     * Setting the size of a session without a view runs it, so that the
+     * session can be used headless, for example from scripts over D-Bus.
+     */
+    Q_SCRIPTABLE void setHeadlessSize(int lines, int columns);
+
+    /** Returns the text of the lines currently on the screen. */
+    Q_SCRIPTABLE QString screenText() const;
+
+    /** Returns the number of lines which have scrolled off the screen into the history. */
+    Q_SCRIPTABLE int historyLineCount() const;
+
+    /**
+     * Returns the text of the history lines from @p startLine to @p endLine,
+     * inclusive, where line 0 is the oldest line in the history.
+     */
+    Q_SCRIPTABLE QString historyText(int startLine, int endLine) const;
+
+    /**
+     * Returns the number of the line of output which the cursor is on,
+     * the lines before it are complete.  Lines are numbered in the order
+     * they were written, see Emulation::outputLine(), and the number
+     * returned never decreases.  Pollers pass it to outputText() or
+     * writeOutput() to only read the lines written since.
+     */
+    Q_SCRIPTABLE qlonglong outputSequence();
+
+    /**
+     * Returns the lines of output from @p startLine to @p endLine,
+     * inclusive, numbered as for outputSequence(), in the OutputFormat
+     * @p format.  Lines which are no longer in the history are skipped.
+     */
+    Q_SCRIPTABLE QString outputText(qlonglong startLine, qlonglong endLine, int format) const;
+
+    /**
+     * Writes the complete lines of output from @p startLine on to @p fd,
+     * in the OutputFormat @p format encoded as UTF-8, and returns the
+     * outputSequence() to read from next time.  Meant for large amounts of
+     * output; @p fd should be a file or memfd, as writing blocks until
+     * everything is written.
+     */
+    Q_SCRIPTABLE qlonglong writeOutput(qlonglong startLine, int format, const QDBusUnixFileDescriptor &fd);
+
     /**
     * Returns the process id of the terminal process.
     * This is the id used by the system API to refer to the process.
@@ -568,6 +660,67 @@ public Q_SLOTS:
      */
     Q_SCRIPTABLE int historySize() const;
 
+    /**
+     * Enables or disables the collection of timings and counters for the
+     * stages which the output of this session passes through.
+     * See pipelineStatistics().
+     */
+    Q_SCRIPTABLE void setPipelineStatisticsEnabled(bool enabled);
+
+    /** Returns true if pipeline statistics are being collected. */
+    Q_SCRIPTABLE bool pipelineStatisticsEnabled() const;
+
+    /**
+     * Shows or hides a summary of the pipeline statistics on top of
+     * the views of this session.  Statistics must be enabled for the
+     * overlay to be drawn.
+     */
+    Q_SCRIPTABLE void setPipelineStatisticsOverlayVisible(bool visible);
+
+    /**
+     * Returns a report of the pipeline statistics collected since they
+     * were enabled or last reset: counters for bytes in, characters parsed,
+     * lines scrolled, dirty lines and frames, and the percentiles and a
+     * histogram of recent timings for each stage.
+     */
+    Q_SCRIPTABLE QString pipelineStatistics() const;
+
+    /** Discards the pipeline statistics collected so far. */
+    Q_SCRIPTABLE void resetPipelineStatistics();
+
+    /**
+     * Records the data sent to and received from the terminal, with its
+     * timing and the changes of the terminal size, to @p fileName until
+     * stopRecording() is called.  See PtyRecorder for the format.
+     * Returns false if the file could not be written.
+     */
+    Q_SCRIPTABLE bool startRecording(const QString &fileName);
+
+    /** Stops recording, see startRecording(). */
+    Q_SCRIPTABLE void stopRecording();
+
+    /**
+     * Replays the output recorded by startRecording() in @p fileName,
+     * @p speed times as fast as it was recorded, or as fast as possible if
+     * @p speed is 0.  The output is passed to the emulation as if the
+     * program had written it, mixed with the output of the session's own
+     * program if it writes any, and the terminal takes the recorded size.
+     * Returns false if the file is not a recording.
+     *
+     * Replaying as fast as possible with pipeline statistics enabled
+     * measures the whole way from the received data to the painted view.
+     */
+    Q_SCRIPTABLE bool replayRecording(const QString &fileName, double speed);
+
+    /** Returns true while a recording is replayed. */
+    Q_SCRIPTABLE bool isReplaying() const;
+
+    /**
+     * Returns the number of milliseconds the last complete replay took,
+     * or -1 if no replay was completed.
+     */
+    Q_SCRIPTABLE qlonglong replayDuration() const;
+
 Q_SIGNALS:
 
     /** Emitted when the terminal process starts. */
@@ -578,6 +731,13 @@ Q_SIGNALS:
      */
     void finished();
 
+    /**
+     * Emitted when input is sent to the session before it has been
+     * started, for example over D-Bus to a restored tab which has not
+     * been shown yet.  The session should be run in response.
+     */
+    void runRequested();
+
     /** Emitted when the session's title has changed. */
     void titleChanged();
 
@@ -596,6 +756,18 @@ Q_SIGNALS:
      */
     void currentDirectoryChanged(const QString &dir);
 
+    /**
+     * Emitted by refreshProcessInfo() when the foreground process, the
+     * working directory or the dynamic title of the session changed.
+     */
+    void processInfoChanged();
+
+    /**
+     * Emitted when input or output is found to have changed the foreground
+     * process group of the terminal, i.e. a program started or finished.
+     */
+    void foregroundProcessGroupChanged();
+
     /** Emitted when a bell event occurs in the session. */
     void bellRequest(const QString &message);
 
@@ -635,6 +807,9 @@ Q_SIGNALS:
      */
     void resizeRequest(const QSize &size);
 
+    /** Emitted when replayRecording() has replayed everything. */
+    void replayFinished();
+
     /**
      * Emitted when a profile change command is received from the terminal.
      *
@@ -650,6 +825,16 @@ Q_SIGNALS:
      */
     void flowControlEnabledChanged(bool enabled);
 
+    /**
+     * Emitted while large amounts of text are being sent to the terminal
+     * program, which is done in chunks as the program reads them.
+     *
+     * @param written The number of bytes sent so far
+     * @param total The number of bytes to send, @p written equals @p total
+     * once all of them have been sent.  Both are 0 after cancelInput().
+     */
+    void inputProgress(qint64 written, qint64 total);
+
     /**
      * Emitted when the active screen is switched, to indicate whether the primary
      * screen is in use.
@@ -679,9 +864,13 @@ Q_SIGNALS:
 private Q_SLOTS:
     void done(int, QProcess::ExitStatus);
 
+    void replayResize(int columns, int lines);
+
     void fireZModemDetected();
 
     void onReceiveBlock(const char *buf, int len);
+    // called on input and output, which is when programs start and finish
+    void checkForegroundProcessGroup();
     void silenceTimerDone();
     void activityTimerDone();
 
@@ -723,6 +912,11 @@ private:
     void updateSessionProcessInfo();
     bool updateForegroundProcessInfo();
     void updateWorkingDirectory();
+    // returns the text of the lines from startLine to endLine, counting
+    // the history lines first and then the lines on the screen
+    QString linesText(int startLine, int endLine) const;
+    // writes the lines of output from startLine to endLine to stream
+    void decodeOutput(QTextStream *stream, qint64 startLine, qint64 endLine, int format) const;
 
     QString validDirectory(const QString &dir) const;
 
@@ -769,6 +963,18 @@ private:
     ProcessInfo *_sessionProcessInfo;
     ProcessInfo *_foregroundProcessInfo;
     int _foregroundPid;
+    // when the process information was last read, see ProcessInfoService::CACHE_TTL
+    QElapsedTimer _sessionProcessInfoRead;
+    QElapsedTimer _foregroundProcessInfoRead;
+
+    // the foreground process group found by checkForegroundProcessGroup()
+    int _checkedForegroundProcessGroup;
+    bool _processInfoMayHaveChanged;
+
+    // the state reported by the last processInfoChanged()
+    int _reportedForegroundPid;
+    QString _reportedWorkingDir;
+    QString _reportedDynamicTitle;
 
     // ZModem
     bool _zmodemBusy;
@@ -779,6 +985,13 @@ private:
 
     QSize _preferredSize;
 
+    qint64 _outputSequence;
+
+    SessionLogger *_outputLogger;
+
+    PtyRecorder *_recorder;
+    PtyReplay *_replay;
+
     static int lastSessionId;
 };
 
@@ -787,6 +1000,11 @@ private:
  * Activity in master sessions can be propagated to all sessions within the group.
  * The type of activity which is propagated and method of propagation is controlled
  * by the masterMode() flags.
+ *
+ * Input is translated once, by the master's emulation, and the resulting
+ * bytes are copied to the other sessions.  Input arriving within one pass
+ * of the event loop is collected and copied in one piece, so that each
+ * session's pty is written to once however fast keys repeat.
  */
 class SessionGroup : public QObject
 {
@@ -846,6 +1064,7 @@ public:
 private Q_SLOTS:
     void sessionFinished();
     void forwardData(const QByteArray &data);
+    void flushForwardedData();
 
 private:
     QList<Session *> masters() const;
@@ -854,6 +1073,9 @@ private:
     QHash<Session *, bool> _sessions;
 
     int _masterMode;
+
+    // input of the masters not copied to the other sessions yet
+    QByteArray _forwardedData;
 };
 }
 
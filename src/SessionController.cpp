@@ -31,6 +31,7 @@
 #include <QKeyEvent>
 #include <QPrinter>
 #include <QPrintDialog>
+#include <QProgressDialog>
 #include <QFileDialog>
 #include <QPainter>
 #include <QStandardPaths>
@@ -60,6 +61,7 @@
 #include "EditProfileDialog.h"
 #include "CopyInputDialog.h"
 #include "Emulation.h"
+#include "FileListCache.h"
 #include "Filter.h"
 #include "History.h"
 #include "HistorySizeDialog.h"
@@ -72,6 +74,7 @@
 #include "SessionManager.h"
 #include "Enumeration.h"
 #include "PrintOptions.h"
+#include "ProcessInfoService.h"
 
 // for SaveHistoryTask
 #include <KIO/Job>
@@ -118,6 +121,7 @@ SessionController::SessionController(Session* session , TerminalDisplay* view, Q
     , _keepIconUntilInteraction(false)
     , _showMenuAction(nullptr)
     , _isSearchBarEnabled(false)
+    , _inputProgressDialog(nullptr)
 {
     Q_ASSERT(session);
     Q_ASSERT(view);
@@ -153,6 +157,9 @@ SessionController::SessionController(Session* session , TerminalDisplay* view, Q
     // listen for session resize requests
     connect(_session.data(), &Konsole::Session::resizeRequest, this, &Konsole::SessionController::sessionResizeRequest);
 
+    // show the progress of large pastes
+    connect(_session.data(), &Konsole::Session::inputProgress, this, &Konsole::SessionController::showInputProgress);
+
     // listen for popup menu requests
     connect(_view.data(), &Konsole::TerminalDisplay::configureRequest, this, &Konsole::SessionController::showDisplayContextMenu);
 
@@ -183,24 +190,12 @@ SessionController::SessionController(Session* session , TerminalDisplay* view, Q
     connect(_session.data(), &Konsole::Session::flowControlEnabledChanged, _view.data(), &Konsole::TerminalDisplay::setFlowControlWarningEnabled);
     _view->setFlowControlWarningEnabled(_session->flowControlEnabled());
 
-    // take a snapshot of the session state every so often when
-    // user activity occurs
-    //
-    // the timer is owned by the session so that it will be destroyed along
-    // with the session
-    _interactionTimer = new QTimer(_session);
-    _interactionTimer->setSingleShot(true);
-    _interactionTimer->setInterval(500);
-    connect(_interactionTimer, &QTimer::timeout, this, &Konsole::SessionController::snapshot);
+    // take a snapshot of the session state when its processes change, these
+    // are polled for all sessions by the session manager's process info service
+    connect(_session.data(), &Konsole::Session::processInfoChanged, this, &Konsole::SessionController::snapshot);
+    // and shortly after user activity occurs
     connect(_view.data(), &Konsole::TerminalDisplay::keyPressedSignal, this, &Konsole::SessionController::interactionHandler);
 
-    // take a snapshot of the session state periodically in the background
-    auto backgroundTimer = new QTimer(_session);
-    backgroundTimer->setSingleShot(false);
-    backgroundTimer->setInterval(2000);
-    connect(backgroundTimer, &QTimer::timeout, this, &Konsole::SessionController::snapshot);
-    backgroundTimer->start();
-
     // xterm '11;?' request
     connect(_session.data(), &Konsole::Session::getBackgroundColor,
             this, &Konsole::SessionController::sendBackgroundColor);
@@ -224,6 +219,10 @@ SessionController::~SessionController()
     if (!_editProfileDialog.isNull()) {
         delete _editProfileDialog.data();
     }
+
+    if (!_inputProgressDialog.isNull()) {
+        delete _inputProgressDialog.data();
+    }
 }
 void SessionController::trackOutput(QKeyEvent* event)
 {
@@ -244,7 +243,9 @@ void SessionController::interactionHandler()
     // happens. Otherwise, those special icons will quickly be replaced by
     // normal icon when ::snapshot() is triggered
     _keepIconUntilInteraction = false;
-    _interactionTimer->start();
+    updateSessionIcon();
+
+    SessionManager::instance()->processInfoService()->requestUpdate(_session);
 }
 
 void SessionController::snapshot()
@@ -1112,9 +1113,15 @@ void SessionController::updateFilterList(Profile::Ptr profile)
         _view->filterChain()->removeFilter(_fileFilter);
         delete _fileFilter;
         _fileFilter = nullptr;
+        disconnect(FileListCache::instance(), &Konsole::FileListCache::listingChanged,
+                   this, &Konsole::SessionController::fileListingChanged);
     } else if (underlineFiles && (_fileFilter == nullptr)) {
         _fileFilter = new FileFilter(_session);
         _view->filterChain()->addFilter(_fileFilter);
+        // directories are listed in the background, look for files again
+        // once a listing becomes available
+        connect(FileListCache::instance(), &Konsole::FileListCache::listingChanged,
+                this, &Konsole::SessionController::fileListingChanged);
     }
 
     bool underlineLinks = profile->underlineLinksEnabled();
@@ -1128,6 +1135,14 @@ void SessionController::updateFilterList(Profile::Ptr profile)
     }
 }
 
+void SessionController::fileListingChanged(const QString &canonicalPath)
+{
+    // the listings of other sessions' directories do not change the files found
+    if ((_fileFilter != nullptr) && (_view != nullptr) && _fileFilter->isCurrentDirectory(canonicalPath)) {
+        _view->invalidateFilters();
+    }
+}
+
 void SessionController::setSearchStartToWindowCurrentLine()
 {
     setSearchStartTo(-1);
@@ -1410,6 +1425,39 @@ void SessionController::sessionResizeRequest(const QSize& size)
     ////qDebug() << "View resize requested to " << size;
     _view->setSize(size.width(), size.height());
 }
+
+void SessionController::showInputProgress(qint64 written, qint64 total)
+{
+    // only input which takes a while to be read is worth showing
+    static const qint64 LARGE_INPUT_SIZE = 64 * 1024;
+    static const int PROGRESS_DELAY = 500;
+
+    if (written == total) {
+        if (_inputProgressDialog != nullptr) {
+            _inputProgressDialog->deleteLater();
+            _inputProgressDialog = nullptr;
+        }
+        return;
+    }
+
+    if (_inputProgressDialog == nullptr) {
+        if (total < LARGE_INPUT_SIZE) {
+            return;
+        }
+
+        // not modal, so that the output of the program can be followed
+        _inputProgressDialog = new QProgressDialog(_view->window());
+        _inputProgressDialog->setWindowTitle(i18nc("@title:window", "Paste"));
+        _inputProgressDialog->setLabelText(i18n("Sending text to the terminal program..."));
+        _inputProgressDialog->setRange(0, 100);
+        _inputProgressDialog->setAutoClose(false);
+        _inputProgressDialog->setAutoReset(false);
+        _inputProgressDialog->setMinimumDuration(PROGRESS_DELAY);
+        connect(_inputProgressDialog.data(), &QProgressDialog::canceled, _session.data(), &Konsole::Session::cancelInput);
+    }
+
+    _inputProgressDialog->setValue(static_cast<int>(written * 100 / total));
+}
 void SessionController::scrollBackOptionsChanged(int mode, int lines)
 {
     switch (mode) {
@@ -1573,7 +1621,14 @@ void SessionController::showDisplayContextMenu(const QPoint& position)
             }
         }
 
-        QAction* chosen = popup->exec(_view->mapToGlobal(position));
+        // the content-specific actions belong to hotspots, which are deleted
+        // when the view filters its image again while the menu is shown
+        QList<QPointer<QAction> > guardedContentActions;
+        foreach (QAction *action, contentActions) {
+            guardedContentActions << action;
+        }
+
+        QPointer<QAction> chosen = popup->exec(_view->mapToGlobal(position));
 
         // check for validity of the pointer to the popup menu
         if (popup != nullptr) {
@@ -1582,8 +1637,10 @@ void SessionController::showDisplayContextMenu(const QPoint& position)
             // If the close action was chosen, the popup menu will be partially
             // destroyed at this point, and the rest will be destroyed later by
             // 'chosen->trigger()'
-            foreach(QAction * action, contentActions) {
-                popup->removeAction(action);
+            foreach (const QPointer<QAction> &action, guardedContentActions) {
+                if (action != nullptr) {
+                    popup->removeAction(action);
+                }
             }
 
             delete contentSeparator;
@@ -44,7 +44,7 @@ class Job;
 class QAction;
 class QTextCodec;
 class QKeyEvent;
-class QTimer;
+class QProgressDialog;
 class QUrl;
 
 class KCodecAction;
@@ -274,6 +274,7 @@ private Q_SLOTS:
     // history search bar's close button
 
     void updateFilterList(Profile::Ptr profile); // Called when the profile has changed, so we might need to change the list of filters
+    void fileListingChanged(const QString &canonicalPath); // a new FileListCache listing is available
 
     void interactionHandler();
     void snapshot(); // called periodically as the user types
@@ -283,6 +284,8 @@ private Q_SLOTS:
     void highlightMatches(bool highlight);
     void scrollBackOptionsChanged(int mode, int lines);
     void sessionResizeRequest(const QSize &size);
+    void showInputProgress(qint64 written, qint64 total); // shows the progress
+    // of large pastes and allows to cancel them
     void trackOutput(QKeyEvent *event);  // move view to end of current output
     // when a key press occurs in the
     // display area
@@ -335,8 +338,6 @@ private:
     QAction *_findNextAction;
     QAction *_findPreviousAction;
 
-    QTimer *_interactionTimer;
-
     int _searchStartLine;
     int _prevSearchResultLine;
     QPointer<IncrementalSearchBar> _searchBar;
@@ -362,6 +363,7 @@ private:
 
     bool _isSearchBarEnabled;
     QPointer<EditProfileDialog> _editProfileDialog;
+    QPointer<QProgressDialog> _inputProgressDialog;
 
     QString _searchText;
 };
@@ -0,0 +1,401 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Config
+#include <config-konsole.h>
+
+// Own
+#include "SessionLogger.h"
+
+// System
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Qt
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextCodec>
+#include <QTextDecoder>
+
+// KDE
+#if HAVE_KARCHIVE
+#include <KCompressionDevice>
+#endif
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+namespace {
+// where in an escape sequence the text logged with a codec is
+enum EscapeState {
+    NoEscape,
+    Escape,                 // after ESC
+    ControlSequence,        // after CSI, up to the final character
+    ControlString,          // after OSC, DCS, SOS, PM or APC, up to ST or BEL
+    ControlStringEscape     // after ESC in a control string
+};
+}
+
+SessionLogger::SessionLogger(const QString &filePrefix, QObject *parent) :
+    QThread(parent),
+    _filePrefix(filePrefix),
+    _maxFileSize(0),
+    _rotationInterval(0),
+    _compressed(false),
+    _pendingChunks(nullptr),
+    _pendingBytes(0),
+    _droppedBytes(0),
+    _stopRequested(0),
+    _wakeUp(0),
+    _logFile(nullptr),
+    _timingFile(nullptr),
+    _decoder(nullptr),
+    _escapeState(NoEscape),
+    _part(1),
+    _fileSize(0),
+    _fileStartTime(0),
+    _lastChunkTime(0),
+    _failed(false)
+{
+}
+
+SessionLogger::~SessionLogger()
+{
+    requestStop();
+    wait();
+
+    // left over if the writer was never started
+    Chunk *chunk = _pendingChunks.fetchAndStoreAcquire(nullptr);
+    while (chunk != nullptr) {
+        Chunk *next = chunk->next;
+        delete chunk;
+        chunk = next;
+    }
+
+    closeFiles();
+    delete _decoder;
+}
+
+void SessionLogger::setTextCodec(QTextCodec *codec)
+{
+    Q_ASSERT(!isRunning());
+
+    delete _decoder;
+    _decoder = codec != nullptr ? codec->makeDecoder() : nullptr;
+}
+
+void SessionLogger::setMaxFileSize(qint64 bytes)
+{
+    _maxFileSize = bytes;
+}
+
+void SessionLogger::setRotationInterval(int seconds)
+{
+    _rotationInterval = seconds;
+}
+
+void SessionLogger::setCompressed(bool compressed)
+{
+    _compressed = compressed && compressionSupported();
+}
+
+bool SessionLogger::compressionSupported()
+{
+    return HAVE_KARCHIVE;
+}
+
+void SessionLogger::log(const char *data, int length)
+{
+    if (length <= 0) {
+        return;
+    }
+
+    // never wait for the writer, rather lose output
+    if (_pendingBytes.fetchAndAddRelaxed(length) + length > MAX_PENDING_BYTES) {
+        _pendingBytes.fetchAndAddRelaxed(-length);
+        _droppedBytes.fetchAndAddRelaxed(length);
+        return;
+    }
+
+    auto chunk = new Chunk;
+    chunk->time = QDateTime::currentMSecsSinceEpoch();
+    chunk->data = QByteArray(data, length);
+
+    Chunk *head = _pendingChunks.loadAcquire();
+    do {
+        chunk->next = head;
+    } while (!_pendingChunks.testAndSetOrdered(head, chunk, head));
+
+    // the writer takes all chunks at once, so it only needs to be woken
+    // up for the first one
+    if (head == nullptr) {
+        _wakeUp.release();
+    }
+}
+
+void SessionLogger::close()
+{
+    if (isRunning()) {
+        connect(this, &QThread::finished, this, &QObject::deleteLater);
+        requestStop();
+    } else {
+        deleteLater();
+    }
+}
+
+void SessionLogger::requestStop()
+{
+    _stopRequested.storeRelease(1);
+    _wakeUp.release();
+}
+
+void SessionLogger::run()
+{
+    forever {
+        _wakeUp.acquire();
+
+        // read before taking the chunks, so that all chunks logged before
+        // the stop was requested are written
+        const bool stop = _stopRequested.loadAcquire() != 0;
+
+        // the list is newest first, reverse it
+        Chunk *chunk = _pendingChunks.fetchAndStoreAcquire(nullptr);
+        Chunk *oldest = nullptr;
+        while (chunk != nullptr) {
+            Chunk *next = chunk->next;
+            chunk->next = oldest;
+            oldest = chunk;
+            chunk = next;
+        }
+
+        while (oldest != nullptr) {
+            writeChunk(oldest);
+            _pendingBytes.fetchAndAddRelaxed(-oldest->data.size());
+
+            Chunk *next = oldest->next;
+            delete oldest;
+            oldest = next;
+        }
+
+        const int dropped = _droppedBytes.fetchAndStoreRelaxed(0);
+        if (dropped > 0) {
+            qCWarning(KonsoleDebug) << "Output log" << _filePrefix << "fell behind, dropped"
+                                    << dropped << "bytes";
+        }
+
+        if (stop) {
+            break;
+        }
+    }
+
+    closeFiles();
+}
+
+void SessionLogger::writeChunk(const Chunk *chunk)
+{
+    if (_failed) {
+        return;
+    }
+
+    const QByteArray data = _decoder != nullptr ? toText(chunk->data) : chunk->data;
+    if (data.isEmpty()) {
+        return;
+    }
+
+    if (_logFile != nullptr) {
+        const bool full = _maxFileSize > 0 && _fileSize > 0
+                          && _fileSize + data.size() > _maxFileSize;
+        const bool old = _rotationInterval > 0
+                         && chunk->time - _fileStartTime >= _rotationInterval * 1000LL;
+        if (full || old) {
+            closeFiles();
+        }
+    }
+
+    if (_logFile == nullptr && !openFiles(chunk->time)) {
+        _failed = true;
+        return;
+    }
+
+    const double delay = (chunk->time - _lastChunkTime) / 1000.0;
+    _lastChunkTime = chunk->time;
+
+    _logFile->write(data);
+    _timingFile->write(QByteArray::number(delay, 'f', 6) + ' '
+                       + QByteArray::number(data.size()) + '\n');
+    _fileSize += data.size();
+}
+
+QByteArray SessionLogger::toText(const QByteArray &data)
+{
+    const QString decoded = _decoder->toUnicode(data);
+
+    QString text;
+    text.reserve(decoded.size());
+
+    for (const QChar &c : decoded) {
+        const ushort u = c.unicode();
+
+        switch (_escapeState) {
+        case NoEscape:
+            if (u == 0x1b) {
+                _escapeState = Escape;
+            } else if (u == 0x9b) {
+                _escapeState = ControlSequence;
+            } else if (u == 0x90 || u == 0x98 || (u >= 0x9d && u <= 0x9f)) {
+                _escapeState = ControlString;
+            } else if (u == '\n' || u == '\t'
+                       || (u >= 0x20 && u != 0x7f && (u < 0x80 || u >= 0xa0))) {
+                text.append(c);
+            }
+            break;
+        case Escape:
+            if (u == '[') {
+                _escapeState = ControlSequence;
+            } else if (u == ']' || u == 'P' || u == 'X' || u == '^' || u == '_') {
+                _escapeState = ControlString;
+            } else if (u < 0x20 || u > 0x2f) {
+                // anything but an intermediate character ends the sequence
+                _escapeState = NoEscape;
+            }
+            break;
+        case ControlSequence:
+            if (u >= 0x40 && u <= 0x7e) {
+                _escapeState = NoEscape;
+            }
+            break;
+        case ControlString:
+            if (u == 0x07 || u == 0x9c) {
+                _escapeState = NoEscape;
+            } else if (u == 0x1b) {
+                _escapeState = ControlStringEscape;
+            }
+            break;
+        case ControlStringEscape:
+            _escapeState = NoEscape;
+            break;
+        }
+    }
+
+    return text.toUtf8();
+}
+
+bool SessionLogger::openFiles(qint64 time)
+{
+    const QString fileName = QStringLiteral("%1.%2").arg(_filePrefix)
+                             .arg(_part++, 3, 10, QLatin1Char('0'));
+
+    // the names of the files tell when sessions were started, so the
+    // directory is created accessible to the user only.  Only its parents
+    // are created with mkpath(), which would use the umask
+    const QString directory = QFileInfo(fileName).absolutePath();
+    if (!QFileInfo::exists(directory)) {
+        const QString parent = QFileInfo(directory).absolutePath();
+        if (!QDir().mkpath(parent)) {
+            qCWarning(KonsoleDebug) << "Unable to create output log directory" << parent;
+        }
+        if (::mkdir(QFile::encodeName(directory).constData(), S_IRWXU) == -1 && errno != EEXIST) {
+            qCWarning(KonsoleDebug) << "Unable to create output log directory" << directory << ":"
+                                    << strerror(errno);
+        }
+    }
+
+    _logFile = openFile(fileName + QStringLiteral(".log"));
+    _timingFile = openFile(fileName + QStringLiteral(".timing"));
+    if (_logFile == nullptr || _timingFile == nullptr) {
+        closeFiles();
+        return false;
+    }
+
+    // scriptreplay skips the first line of the log
+    const QDateTime started = QDateTime::fromMSecsSinceEpoch(time).toUTC();
+    _logFile->write("Konsole output log started on "
+                    + started.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")).toLatin1()
+                    + " UTC\n");
+
+    _fileSize = 0;
+    _fileStartTime = time;
+    _lastChunkTime = time;
+    return true;
+}
+
+QIODevice *SessionLogger::openFile(const QString &fileName) const
+{
+    const QString path = _compressed ? fileName + QStringLiteral(".gz") : fileName;
+
+    // the output of a terminal is nobody else's business.  The file is
+    // created readable by the user only, changing its permissions later
+    // would leave it open to anybody who opened it in the meantime
+    const int fd = ::open(QFile::encodeName(path).constData(),
+                          O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+        qCWarning(KonsoleDebug) << "Unable to open output log" << path << ":"
+                                << strerror(errno);
+        return nullptr;
+    }
+
+    // the output is written as it comes, so that little is lost on a crash
+    const QIODevice::OpenMode mode = _compressed ? QIODevice::WriteOnly
+                                     : QIODevice::WriteOnly | QIODevice::Unbuffered;
+    auto file = new QFile();
+    if (!file->open(fd, mode, QFileDevice::AutoCloseHandle)) {
+        qCWarning(KonsoleDebug) << "Unable to open output log" << path << ":"
+                                << file->errorString();
+        delete file;
+        ::close(fd);
+        return nullptr;
+    }
+
+#if HAVE_KARCHIVE
+    if (_compressed) {
+        auto device = new KCompressionDevice(file, true, KCompressionDevice::GZip);
+        if (!device->open(QIODevice::WriteOnly)) {
+            qCWarning(KonsoleDebug) << "Unable to open output log" << path << ":"
+                                    << device->errorString();
+            delete device;
+            return nullptr;
+        }
+        return device;
+    }
+#endif
+
+    return file;
+}
+
+void SessionLogger::closeFiles()
+{
+    if (_logFile != nullptr) {
+        _logFile->close();
+    }
+    if (_timingFile != nullptr) {
+        _timingFile->close();
+    }
+
+    delete _logFile;
+    delete _timingFile;
+    _logFile = nullptr;
+    _timingFile = nullptr;
+}
@@ -0,0 +1,156 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef SESSIONLOGGER_H
+#define SESSIONLOGGER_H
+
+// Qt
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QByteArray>
+#include <QSemaphore>
+#include <QThread>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QIODevice;
+class QTextCodec;
+class QTextDecoder;
+
+namespace Konsole {
+/**
+ * Writes everything a session receives from its terminal to log files.
+ *
+ * log() is called by the GUI thread and never blocks: the data is stamped
+ * with the current time and handed to a writer thread through a lock-free
+ * list.  If the writer falls more than MAX_PENDING_BYTES behind, further
+ * data is dropped until it caught up, and a warning is printed.
+ *
+ * The output is either written as received, escape sequences and all, or,
+ * with setTextCodec(), decoded and with the escape sequences and control
+ * characters other than newlines and tabs removed.
+ *
+ * Each log file @c <prefix>.<part>.log starts with a line telling when it
+ * was started, and is accompanied by @c <prefix>.<part>.timing, which
+ * has a line "<seconds since the previous chunk> <bytes>" per chunk of
+ * output, as read by scriptreplay.  A new part is started when the current
+ * one would grow beyond the maximum size or got older than the rotation
+ * interval.  The files can be compressed with gzip while they are written,
+ * in which case ".gz" is appended to their names.  The files are only
+ * accessible to the user.
+ *
+ * The settings must be made before start() is called.
+ */
+class KONSOLEPRIVATE_EXPORT SessionLogger : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructs a logger writing to files whose names start with
+     * @p filePrefix.  The directory is created, accessible to the user
+     * only, if it does not exist.
+     */
+    explicit SessionLogger(const QString &filePrefix, QObject *parent = nullptr);
+    /** Writes the data which is still pending before returning. */
+    ~SessionLogger() Q_DECL_OVERRIDE;
+
+    /**
+     * Logs text decoded with @p codec instead of the data as received.
+     * The default is nullptr, which logs the data as received.
+     */
+    void setTextCodec(QTextCodec *codec);
+    /**
+     * Sets the size in bytes a log file may reach before the next one is
+     * started, or 0 for no limit.  The size counts the data before it is
+     * compressed.
+     */
+    void setMaxFileSize(qint64 bytes);
+    /**
+     * Sets the time in seconds after which the next log file is started,
+     * or 0 to never start one because of its age.
+     */
+    void setRotationInterval(int seconds);
+    /**
+     * Sets whether the log files are compressed with gzip.  This is ignored
+     * if compressionSupported() returns false.
+     */
+    void setCompressed(bool compressed);
+    /** Returns true if Konsole was built with support for compressed logs. */
+    static bool compressionSupported();
+
+    /** Queues @p length bytes of @p data to be logged. */
+    void log(const char *data, int length);
+
+    /**
+     * Stops logging once the pending data has been written, and deletes
+     * the logger afterwards.  Returns at once.
+     */
+    void close();
+
+    /** The maximum number of bytes waiting to be written */
+    static const int MAX_PENDING_BYTES = 16 * 1024 * 1024;
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    Q_DISABLE_COPY(SessionLogger)
+
+    struct Chunk {
+        Chunk *next;
+        qint64 time;        // msecs since the epoch
+        QByteArray data;
+    };
+
+    void requestStop();
+    void writeChunk(const Chunk *chunk);
+    QByteArray toText(const QByteArray &data);
+    bool openFiles(qint64 time);
+    QIODevice *openFile(const QString &fileName) const;
+    void closeFiles();
+
+    const QString _filePrefix;
+    qint64 _maxFileSize;
+    int _rotationInterval;
+    bool _compressed;
+
+    // shared between the GUI thread and the writer thread
+    QAtomicPointer<Chunk> _pendingChunks;   // newest first
+    QAtomicInt _pendingBytes;
+    QAtomicInt _droppedBytes;
+    QAtomicInt _stopRequested;
+    QSemaphore _wakeUp;
+
+    // only used by the writer thread
+    QIODevice *_logFile;
+    QIODevice *_timingFile;
+    QTextDecoder *_decoder;
+    int _escapeState;
+    int _part;
+    qint64 _fileSize;
+    qint64 _fileStartTime;
+    qint64 _lastChunkTime;
+    bool _failed;       // a file could not be opened, nothing more is logged
+};
+}
+
+#endif // SESSIONLOGGER_H
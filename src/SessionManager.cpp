@@ -25,6 +25,9 @@
 #include "konsoledebug.h"
 
 // Qt
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QStandardPaths>
 #include <QStringList>
 #include <QTextCodec>
 
@@ -34,13 +37,48 @@
 
 // Konsole
 #include "Session.h"
+#include "ProcessInfoService.h"
+#include "SessionLogger.h"
+#include "SessionPool.h"
 #include "ProfileManager.h"
 #include "History.h"
 #include "Enumeration.h"
 
 using namespace Konsole;
 
-SessionManager::SessionManager()
+// creates the logger for the output of session as configured in profile,
+// or returns nullptr if the output is not logged
+static SessionLogger *createOutputLogger(Session *session, const Profile::Ptr &profile)
+{
+    const int mode = profile->outputLogMode();
+    if (mode == Enum::NoOutputLog) {
+        return nullptr;
+    }
+
+    QString directory = profile->outputLogDirectory();
+    if (directory.isEmpty()) {
+        directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                    + QStringLiteral("/logs");
+    }
+
+    const QString prefix = QStringLiteral("%1/%2-%3-%4").arg(directory,
+                           QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-HHmmss")),
+                           QString::number(QCoreApplication::applicationPid()),
+                           QString::number(session->sessionId()));
+
+    auto logger = new SessionLogger(prefix);
+    if (mode == Enum::TextOutputLog) {
+        logger->setTextCodec(QTextCodec::codecForName(session->codec()));
+    }
+    logger->setMaxFileSize(profile->property<int>(Profile::OutputLogMaxSize) * 1024LL * 1024LL);
+    logger->setRotationInterval(profile->property<int>(Profile::OutputLogRotationInterval) * 60);
+    logger->setCompressed(profile->property<bool>(Profile::OutputLogCompressed));
+    return logger;
+}
+
+SessionManager::SessionManager() :
+    _processInfoService(new ProcessInfoService(this)),
+    _sessionPool(new SessionPool(this))
 {
     ProfileManager *profileMananger = ProfileManager::instance();
     connect(profileMananger, &Konsole::ProfileManager::profileChanged, this,
@@ -81,6 +119,16 @@ const QList<Session *> SessionManager::sessions() const
     return _sessions;
 }
 
+ProcessInfoService *SessionManager::processInfoService() const
+{
+    return _processInfoService;
+}
+
+SessionPool *SessionManager::sessionPool() const
+{
+    return _sessionPool;
+}
+
 Session *SessionManager::createSession(Profile::Ptr profile)
 {
     if (!profile) {
@@ -109,6 +157,7 @@ Session *SessionManager::createSession(Profile::Ptr profile)
     //add session to active list
     _sessions << session;
     _sessionProfiles.insert(session, profile);
+    _processInfoService->addSession(session);
 
     return session;
 }
@@ -125,6 +174,7 @@ void SessionManager::sessionTerminated(Session *session)
     _sessions.removeAll(session);
     _sessionProfiles.remove(session);
     _sessionRuntimeProfiles.remove(session);
+    _processInfoService->removeSession(session);
 
     session->deleteLater();
 }
@@ -256,6 +306,15 @@ void SessionManager::applyProfile(Session *session, const Profile::Ptr profile,
     if (apply.shouldApply(Profile::SilenceSeconds)) {
         session->setMonitorSilenceSeconds(profile->silenceSeconds());
     }
+
+    // Output log, applied after the encoding which it decodes text with
+    if (apply.shouldApply(Profile::OutputLogMode)
+        || apply.shouldApply(Profile::OutputLogDirectory)
+        || apply.shouldApply(Profile::OutputLogMaxSize)
+        || apply.shouldApply(Profile::OutputLogRotationInterval)
+        || apply.shouldApply(Profile::OutputLogCompressed)) {
+        session->setOutputLogger(createOutputLogger(session, profile));
+    }
 }
 
 void SessionManager::sessionProfileCommandReceived(const QString &text)
@@ -32,7 +32,9 @@
 class KConfig;
 
 namespace Konsole {
+class ProcessInfoService;
 class Session;
+class SessionPool;
 
 /**
  * Manages running terminal sessions.
@@ -86,6 +88,12 @@ public:
      */
     const QList<Session *> sessions() const;
 
+    /** Returns the service which keeps the process information of all sessions up to date. */
+    ProcessInfoService *processInfoService() const;
+
+    /** Returns the pool of sessions started in advance for new tabs. */
+    SessionPool *sessionPool() const;
+
     // System session management
     void saveSessions(KConfig *config);
     void restoreSessions(KConfig *config);
@@ -132,6 +140,9 @@ private:
     QHash<Session *, Profile::Ptr> _sessionProfiles;
     QHash<Session *, Profile::Ptr> _sessionRuntimeProfiles;
     QHash<Session *, int> _restoreMapping;
+
+    ProcessInfoService *_processInfoService;
+    SessionPool *_sessionPool;
 };
 
 /** Utility class to simplify code in SessionManager::applyProfile(). */
@@ -0,0 +1,65 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "SessionPlaceholder.h"
+
+// Qt
+#include <QDir>
+#include <QWidget>
+
+// Konsole
+#include "Session.h"
+
+using namespace Konsole;
+
+SessionPlaceholder::SessionPlaceholder(Session *session, QWidget *view) :
+    ViewProperties(view),
+    _session(session)
+{
+    // the tab title format can only be expanded once the shell runs,
+    // so show the directory which the shell will start in
+    const QString directory = session->initialWorkingDirectory();
+    if (!directory.isEmpty()) {
+        setTitle(QDir(directory).dirName());
+    } else {
+        setTitle(session->title(Session::NameRole));
+    }
+    setIcon(QIcon::fromTheme(session->iconName()));
+}
+
+Session *SessionPlaceholder::session() const
+{
+    return _session;
+}
+
+QUrl SessionPlaceholder::url() const
+{
+    return QUrl::fromLocalFile(currentDir());
+}
+
+QString SessionPlaceholder::currentDir() const
+{
+    if (_session.isNull()) {
+        return QString();
+    }
+
+    return _session->initialWorkingDirectory();
+}
@@ -0,0 +1,65 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef SESSIONPLACEHOLDER_H
+#define SESSIONPLACEHOLDER_H
+
+// Qt
+#include <QPointer>
+
+// Konsole
+#include "ViewProperties.h"
+
+namespace Konsole {
+class Session;
+
+/**
+ * Provides the title and icon of a restored tab whose session has not
+ * been started yet.
+ *
+ * When a window is restored, the ViewManager shows a placeholder widget
+ * for each tab instead of a terminal display, and only starts the
+ * session and creates its view when the tab is first shown.
+ */
+class SessionPlaceholder : public ViewProperties
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructs the properties of the placeholder @p view for @p session.
+     * The properties are deleted with the view.
+     */
+    SessionPlaceholder(Session *session, QWidget *view);
+
+    /** Returns the session which the placeholder stands for. */
+    Session *session() const;
+
+    QUrl url() const Q_DECL_OVERRIDE;
+    QString currentDir() const Q_DECL_OVERRIDE;
+
+private:
+    Q_DISABLE_COPY(SessionPlaceholder)
+
+    QPointer<Session> _session;
+};
+}
+
+#endif // SESSIONPLACEHOLDER_H
@@ -0,0 +1,220 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "SessionPool.h"
+
+// Qt
+#include <QDir>
+#include <QTimer>
+
+// Konsole
+#include "ColorScheme.h"
+#include "ColorSchemeManager.h"
+#include "ProfileManager.h"
+#include "Session.h"
+#include "SessionManager.h"
+
+using namespace Konsole;
+
+SessionPool::SessionPool(QObject *parent) :
+    QObject(parent),
+    _wanted(QList<Key>()),
+    _sessions(QList<PooledSession>()),
+    _replenishTimer(new QTimer(this)),
+    _enabled(false)
+{
+    _replenishTimer->setSingleShot(true);
+    _replenishTimer->setInterval(REPLENISH_DELAY);
+    connect(_replenishTimer, &QTimer::timeout, this, &Konsole::SessionPool::replenish);
+
+    ProfileManager *profileManager = ProfileManager::instance();
+    connect(profileManager, &Konsole::ProfileManager::profileChanged, this,
+            &Konsole::SessionPool::profileChanged);
+    connect(profileManager, &Konsole::ProfileManager::profileRemoved, this,
+            [this](Profile::Ptr profile) {
+                for (int i = _wanted.count() - 1; i >= 0; i--) {
+                    if (_wanted[i].profile == profile) {
+                        _wanted.removeAt(i);
+                    }
+                }
+                profileChanged(profile);
+            });
+}
+
+SessionPool::~SessionPool() = default;
+
+void SessionPool::setEnabled(bool enabled)
+{
+    if (_enabled == enabled) {
+        return;
+    }
+
+    _enabled = enabled;
+
+    if (!enabled) {
+        _replenishTimer->stop();
+        _wanted.clear();
+        while (!_sessions.isEmpty()) {
+            closeSession(0);
+        }
+    }
+}
+
+bool SessionPool::isEnabled() const
+{
+    return _enabled;
+}
+
+Session *SessionPool::takeSession(const Profile::Ptr &profile, int windowId,
+                                  const QString &directory)
+{
+    if (!_enabled || !profile) {
+        return nullptr;
+    }
+
+    Key key;
+    key.profile = profile;
+    key.windowId = windowId;
+    key.directory = QDir::cleanPath(directory.isEmpty() ? profile->defaultWorkingDirectory() : directory);
+
+    // the next session for this profile and window is started where
+    // this one was asked for, replacing one kept for another directory
+    for (int i = _wanted.count() - 1; i >= 0; i--) {
+        if (_wanted[i].profile == profile && _wanted[i].windowId == windowId) {
+            _wanted.removeAt(i);
+        }
+    }
+    _wanted.prepend(key);
+    while (_wanted.count() > MAX_SESSIONS) {
+        _wanted.removeLast();
+    }
+
+    Session *session = nullptr;
+    for (int i = 0; i < _sessions.count(); i++) {
+        if (_sessions[i].key == key && !_sessions[i].session.isNull()
+            && _sessions[i].session->views().isEmpty()) {
+            session = _sessions.takeAt(i).session;
+            disconnect(session, nullptr, this, nullptr);
+            break;
+        }
+    }
+
+    _replenishTimer->start();
+
+    return session;
+}
+
+void SessionPool::removeWindow(int windowId)
+{
+    for (int i = _wanted.count() - 1; i >= 0; i--) {
+        if (_wanted[i].windowId == windowId) {
+            _wanted.removeAt(i);
+        }
+    }
+
+    for (int i = _sessions.count() - 1; i >= 0; i--) {
+        if (_sessions[i].key.windowId == windowId) {
+            closeSession(i);
+        }
+    }
+}
+
+void SessionPool::profileChanged(Profile::Ptr profile)
+{
+    // the shells were started with the old settings
+    bool closed = false;
+    for (int i = _sessions.count() - 1; i >= 0; i--) {
+        if (_sessions[i].key.profile == profile) {
+            closeSession(i);
+            closed = true;
+        }
+    }
+
+    if (closed && _enabled) {
+        _replenishTimer->start();
+    }
+}
+
+void SessionPool::replenish()
+{
+    // sessions for profiles and windows which were not asked for recently,
+    // or which were started in another directory, make room for the others
+    for (int i = _sessions.count() - 1; i >= 0; i--) {
+        if (!_wanted.contains(_sessions[i].key)) {
+            closeSession(i);
+        }
+    }
+
+    foreach (const Key &key, _wanted) {
+        bool pooled = false;
+        foreach (const PooledSession &pooledSession, _sessions) {
+            pooled = pooled || pooledSession.key == key;
+        }
+
+        if (!pooled && _sessions.count() < MAX_SESSIONS) {
+            startSession(key);
+        }
+    }
+}
+
+void SessionPool::startSession(const Key &key)
+{
+    Session *session = SessionManager::instance()->createSession(key.profile);
+    if (!key.directory.isEmpty()) {
+        session->setInitialWorkingDirectory(key.directory);
+    }
+    session->addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_WINDOW=/Windows/%1").arg(key.windowId));
+
+    // as a view would, for the COLORFGBG variable of the shell
+    const ColorScheme *colorScheme = ColorSchemeManager::instance()->findColorScheme(key.profile->colorScheme());
+    if (colorScheme == nullptr) {
+        colorScheme = ColorSchemeManager::instance()->defaultColorScheme();
+    }
+    session->setDarkBackground(colorScheme->hasDarkBackground());
+
+    PooledSession pooledSession;
+    pooledSession.key = key;
+    pooledSession.session = session;
+    _sessions.append(pooledSession);
+
+    // a shell which exits on its own is not replaced until asked for again
+    connect(session, &Konsole::Session::finished, this, [this, session]() {
+        for (int i = _sessions.count() - 1; i >= 0; i--) {
+            if (_sessions[i].session == session) {
+                _sessions.removeAt(i);
+            }
+        }
+    });
+
+    // without a view, the shell is started once the size of the terminal is set
+    const int lines = qMax(key.profile->terminalRows(), 1);
+    const int columns = qMax(key.profile->terminalColumns(), 1);
+    session->setHeadlessSize(lines, columns);
+}
+
+void SessionPool::closeSession(int index)
+{
+    Session *session = _sessions.takeAt(index).session;
+    if (session != nullptr) {
+        disconnect(session, nullptr, this, nullptr);
+        session->close();
+    }
+}
@@ -0,0 +1,124 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef SESSIONPOOL_H
+#define SESSIONPOOL_H
+
+// Qt
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+// Konsole
+#include "konsoleprivate_export.h"
+#include "Profile.h"
+
+class QTimer;
+
+namespace Konsole {
+class Session;
+
+/**
+ * Keeps sessions whose shell was started in advance, so that new tabs
+ * show a prompt right away instead of waiting for the shell to start.
+ *
+ * Whenever a session for a profile is asked for in a window, the pool
+ * starts another one for that profile and window after REPLENISH_DELAY,
+ * without a view, and keeps its output until the session is taken.  The
+ * profiles and windows asked for most recently are served, up to
+ * MAX_SESSIONS sessions in total.  Sessions kept for a window are closed
+ * when the window is, and those kept for a profile when it changes.
+ *
+ * The next session is started in the directory the last one was asked for
+ * in, which is usually that of the current session, and is only taken for
+ * a tab starting in the same directory.  When another directory is asked
+ * for, the session is started again in that one.
+ *
+ * The pool is only active if enabled in the settings.  It is owned by
+ * the SessionManager.
+ */
+class KONSOLEPRIVATE_EXPORT SessionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionPool(QObject *parent = nullptr);
+    ~SessionPool() Q_DECL_OVERRIDE;
+
+    /** Enables or disables the pool, disabling closes the pooled sessions. */
+    void setEnabled(bool enabled);
+    /** Returns true if the pool is enabled. */
+    bool isEnabled() const;
+
+    /**
+     * Returns a running session using @p profile in the window whose
+     * view manager has the id @p windowId, which started in @p directory
+     * or the profile's initial directory if @p directory is empty, and
+     * starts the next one.  Returns nullptr if no such session is available.
+     */
+    Session *takeSession(const Profile::Ptr &profile, int windowId, const QString &directory);
+
+    /** Closes the sessions kept for the window @p windowId. */
+    void removeWindow(int windowId);
+
+    /** The maximum number of sessions kept */
+    static const int MAX_SESSIONS = 4;
+    /**
+     * The delay, in milliseconds, before sessions taken are replaced, so that
+     * starting their replacements does not slow down their own start.
+     */
+    static const int REPLENISH_DELAY = 2000;
+
+private Q_SLOTS:
+    void replenish();
+    void profileChanged(Profile::Ptr profile);
+
+private:
+    Q_DISABLE_COPY(SessionPool)
+
+    struct Key {
+        Profile::Ptr profile;
+        int windowId;
+        QString directory;  // the shell's initial working directory
+
+        bool operator==(const Key &other) const
+        {
+            return profile == other.profile && windowId == other.windowId
+                   && directory == other.directory;
+        }
+    };
+
+    struct PooledSession {
+        Key key;
+        QPointer<Session> session;
+    };
+
+    void startSession(const Key &key);
+    void closeSession(int index);
+
+    // most recently asked for first, one directory per profile and window
+    QList<Key> _wanted;
+    QList<PooledSession> _sessions;
+    QTimer *_replenishTimer;
+    bool _enabled;
+};
+}
+
+#endif // SESSIONPOOL_H
@@ -0,0 +1,312 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Config
+#include <config-konsole.h>
+
+// Own
+#include "StartupCache.h"
+
+// Qt
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+namespace {
+// identifies the cache file and the version of its layout
+const quint32 CACHE_MAGIC = 0x4b435343;
+const quint32 CACHE_VERSION = 1;
+
+// the time after which additions to the cache are written to disk
+const int SAVE_DELAY = 5000;
+
+// files modified this recently are not cached, since another change within
+// the resolution of the file system's timestamps would go unnoticed
+const qint64 MODIFICATION_MARGIN = 2000;
+
+// the translated strings in the cached contents depend on the languages
+QString cacheLanguages()
+{
+    return QLocale().uiLanguages().join(QLatin1Char(':'))
+           + QLatin1Char(';') + QString::fromLocal8Bit(qgetenv("LANGUAGE"));
+}
+
+qint64 modificationTime(const QFileInfo &info)
+{
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+bool isRecentlyModified(qint64 modified)
+{
+    return modified > QDateTime::currentMSecsSinceEpoch() - MODIFICATION_MARGIN;
+}
+}
+
+Q_GLOBAL_STATIC(StartupCache, theStartupCache)
+StartupCache *StartupCache::instance()
+{
+    return theStartupCache;
+}
+
+StartupCache::StartupCache() :
+    StartupCache(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                 + QStringLiteral("/konsole/startup.cache"))
+{
+}
+
+StartupCache::StartupCache(const QString &fileName) :
+    _fileName(fileName),
+    _file(fileName),
+    _directories(QHash<QString, Directory>()),
+    _files(QHash<QString, File>()),
+    _saveTimer(new QTimer(this)),
+    _modified(false)
+{
+    _saveTimer->setSingleShot(true);
+    _saveTimer->setInterval(SAVE_DELAY);
+    connect(_saveTimer, &QTimer::timeout, this, &Konsole::StartupCache::save);
+
+    load();
+}
+
+StartupCache::~StartupCache()
+{
+    // before the cache file is unmapped
+    save();
+}
+
+QString StartupCache::fileName() const
+{
+    return _fileName;
+}
+
+void StartupCache::load()
+{
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // the file stays mapped, the cached contents are not copied from it
+    const qint64 size = _file.size();
+    const uchar *map = size > 0 ? _file.map(0, size) : nullptr;
+    if (map == nullptr) {
+        _file.close();
+        return;
+    }
+
+    const QByteArray contents = QByteArray::fromRawData(reinterpret_cast<const char *>(map),
+                                                        static_cast<int>(size));
+    QDataStream stream(contents);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        return;
+    }
+
+    QString konsoleVersion;
+    QString languages;
+    stream >> konsoleVersion >> languages;
+    if (konsoleVersion != QLatin1String(KONSOLE_VERSION) || languages != cacheLanguages()) {
+        return;
+    }
+
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        QString key;
+        Directory directory;
+        stream >> key >> directory.modified >> directory.names;
+        directory.used = false;
+        _directories.insert(key, directory);
+    }
+
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        QString path;
+        File file;
+        quint32 length = 0;
+        stream >> path >> file.modified >> file.size >> length;
+
+        const qint64 offset = stream.device()->pos();
+        if (stream.skipRawData(static_cast<int>(length)) != static_cast<int>(length)) {
+            stream.setStatus(QDataStream::ReadPastEnd);
+            break;
+        }
+        file.data = QByteArray::fromRawData(contents.constData() + offset, static_cast<int>(length));
+        file.used = false;
+        _files.insert(path, file);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCDebug(KonsoleDebug) << "Ignoring damaged startup cache" << _fileName;
+        _directories.clear();
+        _files.clear();
+    }
+}
+
+QStringList StartupCache::entryList(const QString &dir, const QString &nameFilter)
+{
+    const QFileInfo info(dir);
+    if (!info.isDir()) {
+        return QStringList();
+    }
+
+    const QString key = dir + QLatin1Char('/') + nameFilter;
+    const qint64 modified = modificationTime(info);
+
+    auto iter = _directories.find(key);
+    if (iter != _directories.end() && iter->modified == modified) {
+        iter->used = true;
+        return iter->names;
+    }
+
+    Directory directory;
+    directory.modified = modified;
+    directory.names = QDir(dir).entryList(QStringList() << nameFilter);
+    directory.used = true;
+
+    if (isRecentlyModified(modified)) {
+        _directories.remove(key);
+    } else {
+        _directories.insert(key, directory);
+        scheduleSave();
+    }
+
+    return directory.names;
+}
+
+QByteArray StartupCache::data(const QString &path)
+{
+    auto iter = _files.find(path);
+    if (iter == _files.end()) {
+        return QByteArray();
+    }
+
+    const QFileInfo info(path);
+    if (!info.exists() || modificationTime(info) != iter->modified || info.size() != iter->size) {
+        _files.erase(iter);
+        _modified = true;
+        return QByteArray();
+    }
+
+    iter->used = true;
+    return iter->data;
+}
+
+void StartupCache::setData(const QString &path, const QByteArray &data)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        return;
+    }
+
+    File file;
+    file.modified = modificationTime(info);
+    file.size = info.size();
+    file.data = data;
+    file.used = true;
+
+    if (isRecentlyModified(file.modified)) {
+        _files.remove(path);
+    } else {
+        _files.insert(path, file);
+        scheduleSave();
+    }
+}
+
+void StartupCache::scheduleSave()
+{
+    _modified = true;
+
+    if (!_saveTimer->isActive()) {
+        _saveTimer->start();
+    }
+}
+
+bool StartupCache::save()
+{
+    _saveTimer->stop();
+
+    if (!_modified) {
+        return true;
+    }
+
+    // entries which were not used this time are kept while they exist,
+    // they are likely to be used by a later instance
+    QHash<QString, Directory> directories;
+    for (auto iter = _directories.constBegin(); iter != _directories.constEnd(); ++iter) {
+        const QString dir = iter.key().left(iter.key().lastIndexOf(QLatin1Char('/')));
+        if (iter->used || QFileInfo(dir).isDir()) {
+            directories.insert(iter.key(), iter.value());
+        }
+    }
+    QHash<QString, File> files;
+    for (auto iter = _files.constBegin(); iter != _files.constEnd(); ++iter) {
+        if (iter->used || QFile::exists(iter.key())) {
+            files.insert(iter.key(), iter.value());
+        }
+    }
+
+    QDir().mkpath(QFileInfo(_fileName).path());
+
+    QSaveFile output(_fileName);
+    if (!output.open(QIODevice::WriteOnly)) {
+        qCDebug(KonsoleDebug) << "Unable to write startup cache:" << output.errorString();
+        return false;
+    }
+
+    QDataStream stream(&output);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    stream << CACHE_MAGIC << CACHE_VERSION;
+    stream << QStringLiteral(KONSOLE_VERSION) << cacheLanguages();
+
+    stream << static_cast<quint32>(directories.size());
+    for (auto iter = directories.constBegin(); iter != directories.constEnd(); ++iter) {
+        stream << iter.key() << iter->modified << iter->names;
+    }
+
+    stream << static_cast<quint32>(files.size());
+    for (auto iter = files.constBegin(); iter != files.constEnd(); ++iter) {
+        stream << iter.key() << iter->modified << iter->size << static_cast<quint32>(iter->data.size());
+        stream.writeRawData(iter->data.constData(), iter->data.size());
+    }
+
+    if (!output.commit()) {
+        qCDebug(KonsoleDebug) << "Unable to write startup cache:" << output.errorString();
+        return false;
+    }
+
+    _modified = false;
+    return true;
+}
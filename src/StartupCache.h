@@ -0,0 +1,126 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef STARTUPCACHE_H
+#define STARTUPCACHE_H
+
+// Qt
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QTimer;
+
+namespace Konsole {
+/**
+ * Caches what is read from the data directories at startup: the listings
+ * of the directories containing profiles, color schemes and keyboard
+ * translators, and the parsed contents of those files.
+ *
+ * The cache is kept in a single binary file which is mapped into memory
+ * when the cache is created, so that unchanged files are neither listed
+ * nor parsed again.  A directory listing is valid as long as the directory's
+ * modification time is unchanged, the contents of a file as long as its
+ * modification time and size are unchanged.  The cache file is written
+ * again shortly after new contents were added, and when the cache is
+ * destroyed.
+ *
+ * The file is ignored if it was written by a different version of Konsole
+ * or with different languages, since the parsed contents include
+ * translated strings.
+ */
+class KONSOLEPRIVATE_EXPORT StartupCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** Constructs a cache kept in Konsole's default cache file. */
+    StartupCache();
+    /** Constructs a cache kept in @p fileName. */
+    explicit StartupCache(const QString &fileName);
+    ~StartupCache() Q_DECL_OVERRIDE;
+
+    /** Returns the global cache. */
+    static StartupCache *instance();
+
+    /** Returns the path of the file in which the cache is kept. */
+    QString fileName() const;
+
+    /**
+     * Returns the names of the files in @p dir which match @p nameFilter,
+     * such as "*.profile", listing the directory only if it changed.
+     */
+    QStringList entryList(const QString &dir, const QString &nameFilter);
+
+    /**
+     * Returns the cached contents of the file @p path, or an empty array if
+     * none are cached or the file changed since they were cached.
+     *
+     * The array may refer to the mapped cache file and must not be kept
+     * beyond the lifetime of the cache.
+     */
+    QByteArray data(const QString &path);
+
+    /**
+     * Caches @p data as the contents of the file @p path in its current
+     * state.  To be called after the file has been read.
+     */
+    void setData(const QString &path, const QByteArray &data);
+
+public Q_SLOTS:
+    /**
+     * Writes the cache file if anything was added to the cache.
+     * Returns false if the cache file could not be written.
+     */
+    bool save();
+
+private:
+    Q_DISABLE_COPY(StartupCache)
+
+    struct Directory {
+        qint64 modified;
+        QStringList names;
+        bool used;
+    };
+
+    struct File {
+        qint64 modified;
+        qint64 size;
+        QByteArray data;
+        bool used;
+    };
+
+    void load();
+    void scheduleSave();
+
+    QString _fileName;
+    QFile _file;   // the mapped cache file
+    QHash<QString, Directory> _directories; // directory/name filter -> listing
+    QHash<QString, File> _files;            // path -> contents
+    QTimer *_saveTimer;
+    bool _modified;
+};
+}
+
+#endif // STARTUPCACHE_H
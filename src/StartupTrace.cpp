@@ -0,0 +1,158 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "StartupTrace.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QVector>
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+namespace {
+struct TraceEvent {
+    const char *name;
+    char type;          // phase in the trace event format: B(egin), E(nd) or i(nstant)
+    qint64 timestamp;   // in microseconds
+};
+
+struct TraceState {
+    TraceState() :
+        enabled(qEnvironmentVariableIsSet("KONSOLE_STARTUP_TRACE")),
+        path(QFile::decodeName(qgetenv("KONSOLE_STARTUP_TRACE"))),
+        timer(),
+        events()
+    {
+        if (enabled) {
+            timer.start();
+            events.reserve(64);
+
+            // otherwise a Konsole started from one of the shells would
+            // trace its startup to the same file
+            qunsetenv("KONSOLE_STARTUP_TRACE");
+        }
+    }
+
+    bool enabled;
+    QString path;
+    QElapsedTimer timer;
+    QVector<TraceEvent> events;
+};
+}
+
+Q_GLOBAL_STATIC(TraceState, theTraceState)
+
+void StartupTrace::start()
+{
+    record("start", 'i');
+}
+
+bool StartupTrace::isEnabled()
+{
+    return theTraceState->enabled;
+}
+
+void StartupTrace::beginPhase(const char *name)
+{
+    record(name, 'B');
+}
+
+void StartupTrace::endPhase(const char *name)
+{
+    record(name, 'E');
+}
+
+void StartupTrace::mark(const char *name)
+{
+    record(name, 'i');
+}
+
+void StartupTrace::finish(const char *name)
+{
+    TraceState *state = theTraceState;
+    if (!state->enabled) {
+        return;
+    }
+
+    record(name, 'i');
+    write();
+
+    // the startup is over
+    state->enabled = false;
+    state->events.clear();
+}
+
+void StartupTrace::record(const char *name, char type)
+{
+    TraceState *state = theTraceState;
+    if (!state->enabled) {
+        return;
+    }
+
+    TraceEvent event;
+    event.name = name;
+    event.type = type;
+    event.timestamp = state->timer.nsecsElapsed() / 1000;
+    state->events.append(event);
+}
+
+void StartupTrace::write()
+{
+    const TraceState *state = theTraceState;
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray events;
+    foreach (const TraceEvent &event, state->events) {
+        QJsonObject object;
+        object[QStringLiteral("name")] = QLatin1String(event.name);
+        object[QStringLiteral("cat")] = QStringLiteral("startup");
+        object[QStringLiteral("ph")] = QString(QLatin1Char(event.type));
+        object[QStringLiteral("ts")] = static_cast<double>(event.timestamp);
+        object[QStringLiteral("pid")] = static_cast<double>(pid);
+        object[QStringLiteral("tid")] = 0;
+        if (event.type == 'i') {
+            object[QStringLiteral("s")] = QStringLiteral("p");
+        }
+        events.append(object);
+    }
+
+    QJsonObject trace;
+    trace[QStringLiteral("traceEvents")] = events;
+    trace[QStringLiteral("displayTimeUnit")] = QStringLiteral("ms");
+
+    // written at once, so that nobody waiting for the file sees a partial trace
+    QSaveFile file(state->path);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(trace).toJson()) == -1
+            || !file.commit()) {
+        qCDebug(KonsoleDebug) << "Unable to write startup trace to" << state->path
+                              << ":" << file.errorString();
+    }
+}
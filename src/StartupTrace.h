@@ -0,0 +1,95 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+// Qt
+#include <QtGlobal>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole {
+/**
+ * Records how long the phases of Konsole's startup take, from main() until
+ * the first session received its first output, which is usually the prompt.
+ *
+ * Tracing is enabled by setting the environment variable
+ * KONSOLE_STARTUP_TRACE to the path of a file, which is then removed from
+ * the environment of the processes Konsole starts.  Once the first output
+ * arrived, the recorded phases are written to that file in the Chrome
+ * trace event format, which can be read by chrome://tracing or Perfetto.
+ * Timestamps are in microseconds of a monotonic clock started by start().
+ *
+ * When tracing is disabled, or after the trace was written, recording a
+ * phase costs a single check.
+ */
+class KONSOLEPRIVATE_EXPORT StartupTrace
+{
+public:
+    /** Starts the clock, to be called first thing in main(). */
+    static void start();
+
+    /** Returns true if the startup is being traced. */
+    static bool isEnabled();
+
+    /** Records the beginning of the phase @p name, a string literal. */
+    static void beginPhase(const char *name);
+    /** Records the end of the phase @p name, see beginPhase() */
+    static void endPhase(const char *name);
+
+    /** Records that the event @p name happened. */
+    static void mark(const char *name);
+
+    /**
+     * Records that the event @p name, which completes the startup,
+     * happened and writes the trace.  Later calls are ignored.
+     */
+    static void finish(const char *name);
+
+    /** Records a phase lasting from its construction to its destruction */
+    class Phase
+    {
+    public:
+        explicit Phase(const char *name) :
+            _name(name)
+        {
+            beginPhase(_name);
+        }
+
+        ~Phase()
+        {
+            endPhase(_name);
+        }
+
+    private:
+        Q_DISABLE_COPY(Phase)
+
+        const char *_name;
+    };
+
+private:
+    static void record(const char *name, char type);
+    static void write();
+};
+}
+
+#endif // STARTUPTRACE_H
@@ -58,12 +58,13 @@
 #include <KIO/StatJob>
 
 // Konsole
+#include "BlinkTicker.h"
 #include "Filter.h"
 #include "konsoledebug.h"
 #include "konsole_wcwidth.h"
 #include "TerminalCharacterDecoder.h"
 #include "Screen.h"
-#include "LineFont.h"
+#include "LineCharRenderer.h"
 #include "SessionController.h"
 #include "ExtendedCharTable.h"
 #include "TerminalDisplayAccessible.h"
@@ -345,6 +346,7 @@ TerminalDisplay::TerminalDisplay(QWidget* parent)
     , _image(nullptr)
     , _randomSeed(0)
     , _resizing(false)
+    , _dirtySinceHidden(false)
     , _showTerminalSizeHint(true)
     , _bidiEnabled(false)
     , _actSel(0)
@@ -364,6 +366,10 @@ TerminalDisplay::TerminalDisplay(QWidget* parent)
     , _textBlinking(false)
     , _cursorBlinking(false)
     , _hasTextBlinker(false)
+    , _blinkingRegion(QRegion())
+    , _blinkTicker(nullptr)
+    , _textBlinkSubscribed(false)
+    , _cursorBlinkSubscribed(false)
     , _urlHintsModifiers(Qt::NoModifier)
     , _showUrlHint(false)
     , _openLinksByDirectClick(false)
@@ -372,6 +378,8 @@ TerminalDisplay::TerminalDisplay(QWidget* parent)
     , _possibleTripleClick(false)
     , _resizeWidget(nullptr)
     , _resizeTimer(nullptr)
+    , _sizePropagationTimer(new QTimer(this))
+    , _sizePropagationPending(QElapsedTimer())
     , _flowControlWarningEnabled(false)
     , _outputSuspendedLabel(nullptr)
     , _lineSpacing(0)
@@ -403,15 +411,8 @@ TerminalDisplay::TerminalDisplay(QWidget* parent)
     connect(_scrollBar, &QScrollBar::valueChanged, this, &Konsole::TerminalDisplay::scrollBarPositionChanged);
     connect(_scrollBar, &QScrollBar::sliderMoved, this, &Konsole::TerminalDisplay::viewScrolledByUser);
 
-    // setup timers for blinking text
-    _blinkTextTimer = new QTimer(this);
-    _blinkTextTimer->setInterval(TEXT_BLINK_DELAY);
-    connect(_blinkTextTimer, &QTimer::timeout, this, &Konsole::TerminalDisplay::blinkTextEvent);
-
-    // setup timers for blinking cursor
-    _blinkCursorTimer = new QTimer(this);
-    _blinkCursorTimer->setInterval(QApplication::cursorFlashTime() / 2);
-    connect(_blinkCursorTimer, &QTimer::timeout, this, &Konsole::TerminalDisplay::blinkCursorEvent);
+    _sizePropagationTimer->setSingleShot(true);
+    connect(_sizePropagationTimer, &QTimer::timeout, this, &Konsole::TerminalDisplay::propagateContentSize);
 
     // hide mouse cursor on keystroke or idle
     KCursor::setAutoHideCursor(this, true);
@@ -450,8 +451,10 @@ TerminalDisplay::TerminalDisplay(QWidget* parent)
 
 TerminalDisplay::~TerminalDisplay()
 {
-    disconnect(_blinkTextTimer);
-    disconnect(_blinkCursorTimer);
+    if (_blinkTicker != nullptr) {
+        _blinkTicker->subscribeText(this, false);
+        _blinkTicker->subscribeCursor(this, false);
+    }
 
     delete[] _image;
     delete _filterChain;
@@ -463,246 +466,31 @@ TerminalDisplay::~TerminalDisplay()
 /*                                                                           */
 /* ------------------------------------------------------------------------- */
 
-/**
- A table for emulating the simple (single width) unicode drawing chars.
- It represents the 250x - 257x glyphs. If it's zero, we can't use it.
- if it's not, it's encoded as follows: imagine a 5x5 grid where the points are numbered
- 0 to 24 left to top, top to bottom. Each point is represented by the corresponding bit.
-
- Then, the pixels basically have the following interpretation:
- _|||_
- -...-
- -...-
- -...-
- _|||_
-
-where _ = none
-      | = vertical line.
-      - = horizontal line.
- */
-
-enum LineEncode {
-    TopL  = (1 << 1),
-    TopC  = (1 << 2),
-    TopR  = (1 << 3),
-
-    LeftT = (1 << 5),
-    Int11 = (1 << 6),
-    Int12 = (1 << 7),
-    Int13 = (1 << 8),
-    RightT = (1 << 9),
-
-    LeftC = (1 << 10),
-    Int21 = (1 << 11),
-    Int22 = (1 << 12),
-    Int23 = (1 << 13),
-    RightC = (1 << 14),
-
-    LeftB = (1 << 15),
-    Int31 = (1 << 16),
-    Int32 = (1 << 17),
-    Int33 = (1 << 18),
-    RightB = (1 << 19),
-
-    BotL  = (1 << 21),
-    BotC  = (1 << 22),
-    BotR  = (1 << 23)
-};
-
-static void drawLineChar(QPainter& paint, int x, int y, int w, int h, uchar code)
-{
-    //Calculate cell midpoints, end points.
-    const int cx = x + w / 2;
-    const int cy = y + h / 2;
-    const int ex = x + w - 1;
-    const int ey = y + h - 1;
-
-    const quint32 toDraw = LineChars[code];
-
-    //Top _lines:
-    if ((toDraw & TopL) != 0u) {
-        paint.drawLine(cx - 1, y, cx - 1, cy - 2);
-    }
-    if ((toDraw & TopC) != 0u) {
-        paint.drawLine(cx, y, cx, cy - 2);
-    }
-    if ((toDraw & TopR) != 0u) {
-        paint.drawLine(cx + 1, y, cx + 1, cy - 2);
-    }
-
-    //Bot _lines:
-    if ((toDraw & BotL) != 0u) {
-        paint.drawLine(cx - 1, cy + 2, cx - 1, ey);
-    }
-    if ((toDraw & BotC) != 0u) {
-        paint.drawLine(cx, cy + 2, cx, ey);
-    }
-    if ((toDraw & BotR) != 0u) {
-        paint.drawLine(cx + 1, cy + 2, cx + 1, ey);
-    }
-
-    //Left _lines:
-    if ((toDraw & LeftT) != 0u) {
-        paint.drawLine(x, cy - 1, cx - 2, cy - 1);
-    }
-    if ((toDraw & LeftC) != 0u) {
-        paint.drawLine(x, cy, cx - 2, cy);
-    }
-    if ((toDraw & LeftB) != 0u) {
-        paint.drawLine(x, cy + 1, cx - 2, cy + 1);
-    }
-
-    //Right _lines:
-    if ((toDraw & RightT) != 0u) {
-        paint.drawLine(cx + 2, cy - 1, ex, cy - 1);
-    }
-    if ((toDraw & RightC) != 0u) {
-        paint.drawLine(cx + 2, cy, ex, cy);
-    }
-    if ((toDraw & RightB) != 0u) {
-        paint.drawLine(cx + 2, cy + 1, ex, cy + 1);
-    }
-
-    //Intersection points.
-    if ((toDraw & Int11) != 0u) {
-        paint.drawPoint(cx - 1, cy - 1);
-    }
-    if ((toDraw & Int12) != 0u) {
-        paint.drawPoint(cx, cy - 1);
-    }
-    if ((toDraw & Int13) != 0u) {
-        paint.drawPoint(cx + 1, cy - 1);
-    }
-
-    if ((toDraw & Int21) != 0u) {
-        paint.drawPoint(cx - 1, cy);
-    }
-    if ((toDraw & Int22) != 0u) {
-        paint.drawPoint(cx, cy);
-    }
-    if ((toDraw & Int23) != 0u) {
-        paint.drawPoint(cx + 1, cy);
-    }
-
-    if ((toDraw & Int31) != 0u) {
-        paint.drawPoint(cx - 1, cy + 1);
-    }
-    if ((toDraw & Int32) != 0u) {
-        paint.drawPoint(cx, cy + 1);
-    }
-    if ((toDraw & Int33) != 0u) {
-        paint.drawPoint(cx + 1, cy + 1);
-    }
-}
-
-static void drawOtherChar(QPainter& paint, int x, int y, int w, int h, uchar code)
+void TerminalDisplay::drawLineCharString(QPainter& painter, int x, int y, const QString& str,
+        const Character* attributes)
 {
-    //Calculate cell midpoints, end points.
-    const int cx = x + w / 2;
-    const int cy = y + h / 2;
-    const int ex = x + w - 1;
-    const int ey = y + h - 1;
+    const bool bold = ((attributes->rendition & RE_BOLD) != 0) && _boldIntense;
 
-    // Double dashes
-    if (0x4C <= code && code <= 0x4F) {
-        const int xHalfGap = qMax(w / 15, 1);
-        const int yHalfGap = qMax(h / 15, 1);
-        switch (code) {
-        case 0x4D: // BOX DRAWINGS HEAVY DOUBLE DASH HORIZONTAL
-            paint.drawLine(x, cy - 1, cx - xHalfGap - 1, cy - 1);
-            paint.drawLine(x, cy + 1, cx - xHalfGap - 1, cy + 1);
-            paint.drawLine(cx + xHalfGap, cy - 1, ex, cy - 1);
-            paint.drawLine(cx + xHalfGap, cy + 1, ex, cy + 1);
-            // No break!
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 8, 0))
-            Q_FALLTHROUGH();
-#endif
-        case 0x4C: // BOX DRAWINGS LIGHT DOUBLE DASH HORIZONTAL
-            paint.drawLine(x, cy, cx - xHalfGap - 1, cy);
-            paint.drawLine(cx + xHalfGap, cy, ex, cy);
-            break;
-        case 0x4F: // BOX DRAWINGS HEAVY DOUBLE DASH VERTICAL
-            paint.drawLine(cx - 1, y, cx - 1, cy - yHalfGap - 1);
-            paint.drawLine(cx + 1, y, cx + 1, cy - yHalfGap - 1);
-            paint.drawLine(cx - 1, cy + yHalfGap, cx - 1, ey);
-            paint.drawLine(cx + 1, cy + yHalfGap, cx + 1, ey);
-            // No break!
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 8, 0))
-            Q_FALLTHROUGH();
-#endif
-        case 0x4E: // BOX DRAWINGS LIGHT DOUBLE DASH VERTICAL
-            paint.drawLine(cx, y, cx, cy - yHalfGap - 1);
-            paint.drawLine(cx, cy + yHalfGap, cx, ey);
-            break;
-        }
-    }
+    // printers get vector output, the screen gets cell-sized cached glyphs
+    if (painter.device()->devType() == QInternal::Printer) {
+        const QPen& originalPen = painter.pen();
 
-    // Rounded corner characters
-    else if (0x6D <= code && code <= 0x70) {
-        const int r = w * 3 / 8;
-        const int d = 2 * r;
-        switch (code) {
-        case 0x6D: // BOX DRAWINGS LIGHT ARC DOWN AND RIGHT
-            paint.drawLine(cx, cy + r, cx, ey);
-            paint.drawLine(cx + r, cy, ex, cy);
-            paint.drawArc(cx, cy, d, d, 90 * 16, 90 * 16);
-            break;
-        case 0x6E: // BOX DRAWINGS LIGHT ARC DOWN AND LEFT
-            paint.drawLine(cx, cy + r, cx, ey);
-            paint.drawLine(x, cy, cx - r, cy);
-            paint.drawArc(cx - d, cy, d, d, 0 * 16, 90 * 16);
-            break;
-        case 0x6F: // BOX DRAWINGS LIGHT ARC UP AND LEFT
-            paint.drawLine(cx, y, cx, cy - r);
-            paint.drawLine(x, cy, cx - r, cy);
-            paint.drawArc(cx - d, cy - d, d, d, 270 * 16, 90 * 16);
-            break;
-        case 0x70: // BOX DRAWINGS LIGHT ARC UP AND RIGHT
-            paint.drawLine(cx, y, cx, cy - r);
-            paint.drawLine(cx + r, cy, ex, cy);
-            paint.drawArc(cx, cy - d, d, d, 180 * 16, 90 * 16);
-            break;
+        if (bold) {
+            QPen boldPen(originalPen);
+            boldPen.setWidth(3);
+            painter.setPen(boldPen);
         }
-    }
 
-    // Diagonals
-    else if (0x71 <= code && code <= 0x73) {
-        switch (code) {
-        case 0x71: // BOX DRAWINGS LIGHT DIAGONAL UPPER RIGHT TO LOWER LEFT
-            paint.drawLine(ex, y, x, ey);
-            break;
-        case 0x72: // BOX DRAWINGS LIGHT DIAGONAL UPPER LEFT TO LOWER RIGHT
-            paint.drawLine(x, y, ex, ey);
-            break;
-        case 0x73: // BOX DRAWINGS LIGHT DIAGONAL CROSS
-            paint.drawLine(ex, y, x, ey);
-            paint.drawLine(x, y, ex, ey);
-            break;
+        for (int i = 0 ; i < str.length(); i++) {
+            LineCharRenderer::drawChar(painter, QRect(x + (_fontWidth * i), y, _fontWidth, _fontHeight),
+                                       str[i].unicode());
         }
-    }
-}
 
-void TerminalDisplay::drawLineCharString(QPainter& painter, int x, int y, const QString& str,
-        const Character* attributes)
-{
-    const QPen& originalPen = painter.pen();
-
-    if (((attributes->rendition & RE_BOLD) != 0) && _boldIntense) {
-        QPen boldPen(originalPen);
-        boldPen.setWidth(3);
-        painter.setPen(boldPen);
-    }
-
-    for (int i = 0 ; i < str.length(); i++) {
-        const uchar code = str[i].cell();
-        if (LineChars[code] != 0u) {
-            drawLineChar(painter, x + (_fontWidth * i), y, _fontWidth, _fontHeight, code);
-        } else {
-            drawOtherChar(painter, x + (_fontWidth * i), y, _fontWidth, _fontHeight, code);
-        }
+        painter.setPen(originalPen);
+    } else {
+        LineCharRenderer::drawString(painter, x, y, QSize(_fontWidth, _fontHeight), str,
+                                     painter.pen().color(), bold, devicePixelRatioF());
     }
-
-    painter.setPen(originalPen);
 }
 
 void TerminalDisplay::setKeyboardCursorShape(Enum::CursorShapeEnum shape)
@@ -1103,18 +891,28 @@ void TerminalDisplay::processFilters()
         return;
     }
 
+    // hotspots of a hidden view are of no use to anybody, they will be
+    // recalculated once the view is shown again
+    if (!isVisible()) {
+        return;
+    }
+
     QRegion preUpdateHotSpots = hotSpotRegion();
 
-    // use _screenWindow->getImage() here rather than _image because
-    // other classes may call processFilters() when this display's
-    // ScreenWindow emits a scrolled() signal - which will happen before
-    // updateImage() is called on the display and therefore _image is
-    // out of date at this point
-    _filterChain->setImage(_screenWindow->getImage(),
-                           _screenWindow->windowLines(),
-                           _screenWindow->windowColumns(),
-                           _screenWindow->getLineProperties());
-    _filterChain->process();
+    {
+        PipelineStatistics::StageTimer timer(_screenWindow->statistics(), PipelineStatistics::Filters);
+
+        // use _screenWindow->getImage() here rather than _image because
+        // other classes may call processFilters() when this display's
+        // ScreenWindow emits a scrolled() signal - which will happen before
+        // updateImage() is called on the display and therefore _image is
+        // out of date at this point
+        _filterChain->setImage(_screenWindow->getImage(),
+                               _screenWindow->windowLines(),
+                               _screenWindow->windowColumns(),
+                               _screenWindow->getLineProperties());
+        _filterChain->process();
+    }
 
     QRegion postUpdateHotSpots = hotSpotRegion();
 
@@ -1122,12 +920,30 @@ void TerminalDisplay::processFilters()
     _filterUpdateRequired = false;
 }
 
+void TerminalDisplay::invalidateFilters()
+{
+    _filterUpdateRequired = true;
+    processFilters();
+}
+
 void TerminalDisplay::updateImage()
 {
     if (_screenWindow == nullptr) {
         return;
     }
 
+    // a view which is not visible (e.g. in a background tab) does not fetch
+    // or diff the image at all, it only remembers that it is out of date
+    // and catches up in showEvent()
+    if (!isVisible()) {
+        _dirtySinceHidden = true;
+        _screenWindow->resetScrollCount();
+        return;
+    }
+
+    PipelineStatistics* const statistics = _screenWindow->statistics();
+    PipelineStatistics::StageTimer timer(statistics, PipelineStatistics::UpdateImage);
+
     // optimization - scroll the existing image where possible and
     // avoid expensive text drawing for parts of the image that
     // can simply be moved up or down
@@ -1159,6 +975,7 @@ void TerminalDisplay::updateImage()
     const int    tLx = tL.x();
     const int    tLy = tL.y();
     _hasTextBlinker = false;
+    _blinkingRegion = QRegion();
 
     CharacterColor cf;       // undefined
 
@@ -1168,9 +985,9 @@ void TerminalDisplay::updateImage()
     auto dirtyMask = new char[columnsToUpdate + 2];
     QRegion dirtyRegion;
 
-    // debugging variable, this records the number of lines that are found to
-    // be 'dirty' ( ie. have changed from the old _image to the new _image ) and
-    // which therefore need to be repainted
+    // this records the number of lines that are found to be 'dirty'
+    // ( ie. have changed from the old _image to the new _image ) and
+    // which therefore need to be repainted, see PipelineStatistics::DirtyLines
     int dirtyLineCount = 0;
 
     for (y = 0; y < linesToUpdate; ++y) {
@@ -1190,10 +1007,36 @@ void TerminalDisplay::updateImage()
             }
         }
 
+        // record the runs of blinking characters on this line, so that
+        // blinkTextEvent() only has to repaint those
+        for (x = 0; x < columnsToUpdate; ++x) {
+            if ((newLine[x].rendition & RE_BLINK) == 0) {
+                continue;
+            }
+            int blinkEnd = x + 1;
+            while (blinkEnd < columnsToUpdate && ((newLine[blinkEnd].rendition & RE_BLINK) != 0
+                                                  || newLine[blinkEnd].character == 0u)) {
+                blinkEnd++;
+            }
+            _hasTextBlinker = true;
+            if (_lineProperties.count() > y && (_lineProperties[y] & (LINE_DOUBLEWIDTH | LINE_DOUBLEHEIGHT)) != 0) {
+                // scaled lines do not map cell for cell onto the widget,
+                // repaint the whole line (and the one below for double height)
+                _blinkingRegion |= QRect(_contentRect.left() + tLx,
+                                         _contentRect.top() + tLy + _fontHeight * y,
+                                         _fontWidth * columnsToUpdate,
+                                         _fontHeight * 2);
+            } else {
+                _blinkingRegion |= QRect(_contentRect.left() + tLx + _fontWidth * x,
+                                         _contentRect.top() + tLy + _fontHeight * y,
+                                         _fontWidth * (blinkEnd - x),
+                                         _fontHeight);
+            }
+            x = blinkEnd - 1;
+        }
+
         if (!_resizing) { // not while _resizing, we're expecting a paintEvent
             for (x = 0; x < columnsToUpdate; ++x) {
-                _hasTextBlinker |= (newLine[x].rendition & RE_BLINK);
-
                 // Start drawing if this character or the next one differs.
                 // We also take the next one into account to handle the situation
                 // where characters exceed their cell width.
@@ -1292,16 +1135,20 @@ void TerminalDisplay::updateImage()
 
     dirtyRegion |= _inputMethodData.previousPreeditRect;
 
+    if (statistics != nullptr) {
+        statistics->add(PipelineStatistics::DirtyLines, dirtyLineCount);
+        if (statistics->isOverlayVisible()) {
+            dirtyRegion |= statisticsOverlayRect();
+        }
+    }
+
     // update the parts of the display which have changed
     update(dirtyRegion);
 
-    if (_allowBlinkingText && _hasTextBlinker && !_blinkTextTimer->isActive()) {
-        _blinkTextTimer->start();
-    }
-    if (!_hasTextBlinker && _blinkTextTimer->isActive()) {
-        _blinkTextTimer->stop();
+    if (!_hasTextBlinker) {
         _textBlinking = false;
     }
+    updateBlinkSubscriptions();
     delete[] dirtyMask;
 
 #ifndef QT_NO_ACCESSIBILITY
@@ -1341,14 +1188,60 @@ void TerminalDisplay::paintEvent(QPaintEvent* pe)
 {
     QPainter paint(this);
 
-    foreach(const QRect & rect, (pe->region() & contentsRect()).rects()) {
-        drawBackground(paint, rect, palette().background().color(),
-                       true /* use opacity setting */);
-        drawContents(paint, rect);
+    {
+        PipelineStatistics::StageTimer timer(_screenWindow != nullptr ? _screenWindow->statistics() : nullptr,
+                                             PipelineStatistics::Paint);
+
+        foreach(const QRect & rect, (pe->region() & contentsRect()).rects()) {
+            drawBackground(paint, rect, palette().background().color(),
+                           true /* use opacity setting */);
+            drawContents(paint, rect);
+        }
+        drawCurrentResultRect(paint);
+        drawInputMethodPreeditString(paint, preeditRect());
+        paintFilters(paint);
     }
-    drawCurrentResultRect(paint);
-    drawInputMethodPreeditString(paint, preeditRect());
-    paintFilters(paint);
+
+    drawStatisticsOverlay(paint);
+}
+
+QRect TerminalDisplay::statisticsOverlayRect() const
+{
+    // wide enough for the lines of PipelineStatistics::overlayText()
+    const int columns = 36;
+    const int lines = PipelineStatistics::StageCount + 2;
+    const int margin = _fontWidth / 2;
+
+    const QSize size(columns * _fontWidth + 2 * margin, lines * _fontHeight + 2 * margin);
+    const QRect area = contentsRect();
+    return QRect(QPoint(area.right() - size.width() - margin, area.top() + margin), size);
+}
+
+void TerminalDisplay::drawStatisticsOverlay(QPainter& painter)
+{
+    if (_screenWindow == nullptr) {
+        return;
+    }
+
+    const PipelineStatistics* statistics = _screenWindow->statistics();
+    if (statistics == nullptr || !statistics->isOverlayVisible()) {
+        return;
+    }
+
+    const QRect rect = statisticsOverlayRect();
+    const int margin = _fontWidth / 2;
+
+    painter.save();
+    painter.setFont(font());
+    painter.fillRect(rect, QColor(0, 0, 0, 192));
+    painter.setPen(Qt::white);
+
+    int y = rect.top() + margin + _fontAscent;
+    foreach(const QString& line, statistics->overlayText()) {
+        painter.drawText(rect.left() + margin, y, line);
+        y += _fontHeight;
+    }
+    painter.restore();
 }
 
 void TerminalDisplay::printContent(QPainter& painter, bool friendly)
@@ -1716,32 +1609,66 @@ QRect TerminalDisplay::imageToWidget(const QRect& imageArea) const
 void TerminalDisplay::setBlinkingCursorEnabled(bool blink)
 {
     _allowBlinkingCursor = blink;
-
-    if (blink && !_blinkCursorTimer->isActive()) {
-        _blinkCursorTimer->start();
-    }
-
-    if (!blink && _blinkCursorTimer->isActive()) {
-        _blinkCursorTimer->stop();
-        if (_cursorBlinking) {
-            // if cursor is blinking(hidden), blink it again to make it show
-            blinkCursorEvent();
-        }
-        Q_ASSERT(!_cursorBlinking);
-    }
+    updateBlinkSubscriptions();
 }
 
 void TerminalDisplay::setBlinkingTextEnabled(bool blink)
 {
     _allowBlinkingText = blink;
+    updateBlinkSubscriptions();
+}
+
+void TerminalDisplay::updateBlinkSubscriptions()
+{
+    // only views which can actually be seen take part in blinking, so that
+    // hidden, minimized or unfocused views cause no timer wakeups at all
+    const bool active = isVisible() && hasFocus() && !window()->isMinimized();
+    const bool blinkText = active && _allowBlinkingText && _hasTextBlinker;
+    const bool blinkCursor = active && _allowBlinkingCursor;
+
+    // the display may have been moved to another window since it last
+    // subscribed, e.g. when its tab was detached
+    BlinkTicker *ticker = nullptr;
+    if (blinkText || blinkCursor) {
+        ticker = (_blinkTicker != nullptr && _blinkTicker->parent() == window()) ? _blinkTicker.data()
+                                                                                  : BlinkTicker::forWidget(this);
+    }
+    if (_blinkTicker != nullptr && _blinkTicker != ticker) {
+        _blinkTicker->subscribeText(this, false);
+        _blinkTicker->subscribeCursor(this, false);
+        disconnect(_blinkTicker.data(), nullptr, this, nullptr);
+        _textBlinkSubscribed = false;
+        _cursorBlinkSubscribed = false;
+    }
+    _blinkTicker = ticker;
 
-    if (blink && !_blinkTextTimer->isActive()) {
-        _blinkTextTimer->start();
+    if (ticker != nullptr && blinkText != _textBlinkSubscribed) {
+        ticker->subscribeText(this, blinkText);
+        if (blinkText) {
+            connect(ticker, &Konsole::BlinkTicker::textTick, this, &Konsole::TerminalDisplay::blinkTextEvent);
+        } else {
+            disconnect(ticker, &Konsole::BlinkTicker::textTick, this, &Konsole::TerminalDisplay::blinkTextEvent);
+        }
+        _textBlinkSubscribed = blinkText;
+    }
+    if (ticker != nullptr && blinkCursor != _cursorBlinkSubscribed) {
+        ticker->subscribeCursor(this, blinkCursor);
+        if (blinkCursor) {
+            connect(ticker, &Konsole::BlinkTicker::cursorTick, this, &Konsole::TerminalDisplay::blinkCursorEvent);
+        } else {
+            disconnect(ticker, &Konsole::BlinkTicker::cursorTick, this, &Konsole::TerminalDisplay::blinkCursorEvent);
+        }
+        _cursorBlinkSubscribed = blinkCursor;
     }
 
-    if (!blink && _blinkTextTimer->isActive()) {
-        _blinkTextTimer->stop();
+    // if text or cursor is blinking (hidden), show it again
+    if (!blinkText && _textBlinking) {
         _textBlinking = false;
+        update(_blinkingRegion);
+    }
+    if (!blinkCursor && _cursorBlinking) {
+        _cursorBlinking = false;
+        updateCursor();
     }
 }
 
@@ -1754,17 +1681,9 @@ void TerminalDisplay::focusOutEvent(QFocusEvent*)
     _cursorBlinking = false;
     updateCursor();
 
-    // suppress further cursor blinking
-    _blinkCursorTimer->stop();
+    // suppress further cursor and text blinking
+    updateBlinkSubscriptions();
     Q_ASSERT(!_cursorBlinking);
-
-    // if text is blinking (hidden), blink it again to make it shown
-    if (_textBlinking) {
-        blinkTextEvent();
-    }
-
-    // suppress further text blinking
-    _blinkTextTimer->stop();
     Q_ASSERT(!_textBlinking);
 
     _showUrlHint = false;
@@ -1774,16 +1693,10 @@ void TerminalDisplay::focusOutEvent(QFocusEvent*)
 
 void TerminalDisplay::focusInEvent(QFocusEvent*)
 {
-    if (_allowBlinkingCursor) {
-        _blinkCursorTimer->start();
-    }
+    updateBlinkSubscriptions();
 
     updateCursor();
 
-    if (_allowBlinkingText && _hasTextBlinker) {
-        _blinkTextTimer->start();
-    }
-
     emit focusGained();
 }
 
@@ -1793,9 +1706,8 @@ void TerminalDisplay::blinkTextEvent()
 
     _textBlinking = !_textBlinking;
 
-    // TODO: Optimize to only repaint the areas of the widget where there is
-    // blinking text rather than repainting the whole widget.
-    update();
+    // only the cells holding blinking characters need to be repainted
+    update(_blinkingRegion);
 }
 
 void TerminalDisplay::blinkCursorEvent()
@@ -1823,7 +1735,11 @@ void TerminalDisplay::updateCursor()
 void TerminalDisplay::resizeEvent(QResizeEvent*)
 {
     if (contentsRect().isValid()) {
-        updateImageSize();
+        // while the widget is being dragged to a new size, only the local image
+        // is resized - showing a cropped copy of the previous contents - and
+        // resizing the screen and the pty, which makes the running program
+        // redraw, is deferred until the size settles
+        updateImageSize(_image != nullptr && isVisible());
     }
 }
 
@@ -1834,7 +1750,7 @@ void TerminalDisplay::propagateSize()
     }
 }
 
-void TerminalDisplay::updateImageSize()
+void TerminalDisplay::updateImageSize(bool deferPropagation)
 {
     Character* oldImage = _image;
     const int oldLines = _lines;
@@ -1862,12 +1778,38 @@ void TerminalDisplay::updateImageSize()
 
     if (_resizing) {
         showResizeNotification();
-        emit changedContentSizeSignal(_contentRect.height(), _contentRect.width()); // expose resizeEvent
+        if (deferPropagation) {
+            scheduleContentSizePropagation();
+        } else {
+            propagateContentSize(); // expose resizeEvent
+        }
     }
 
     _resizing = false;
 }
 
+void TerminalDisplay::propagateContentSize()
+{
+    _sizePropagationTimer->stop();
+    _sizePropagationPending.invalidate();
+
+    emit changedContentSizeSignal(_contentRect.height(), _contentRect.width());
+}
+
+void TerminalDisplay::scheduleContentSizePropagation()
+{
+    if (!_sizePropagationPending.isValid()) {
+        _sizePropagationPending.start();
+    }
+
+    const qint64 pendingFor = _sizePropagationPending.elapsed();
+    if (pendingFor >= MAX_SIZE_PROPAGATION_DELAY) {
+        propagateContentSize();
+    } else {
+        _sizePropagationTimer->start(qMin(qint64(SIZE_SETTLE_DELAY), MAX_SIZE_PROPAGATION_DELAY - pendingFor));
+    }
+}
+
 void TerminalDisplay::makeImage()
 {
     _wallpaper->load();
@@ -1955,11 +1897,21 @@ QSize TerminalDisplay::sizeHint() const
 //the same signal as the one for a content size change
 void TerminalDisplay::showEvent(QShowEvent*)
 {
-    emit changedContentSizeSignal(_contentRect.height(), _contentRect.width());
+    // catch up with the output received whilst the view was hidden
+    if (_dirtySinceHidden) {
+        _dirtySinceHidden = false;
+        _filterUpdateRequired = true;
+        updateLineProperties();
+        updateImage();
+    }
+
+    updateBlinkSubscriptions();
+    propagateContentSize();
 }
 void TerminalDisplay::hideEvent(QHideEvent*)
 {
-    emit changedContentSizeSignal(_contentRect.height(), _contentRect.width());
+    updateBlinkSubscriptions();
+    propagateContentSize();
 }
 
 void TerminalDisplay::setMargin(int margin)
@@ -2544,6 +2496,12 @@ void TerminalDisplay::updateLineProperties()
         return;
     }
 
+    // see updateImage()
+    if (!isVisible()) {
+        _dirtySinceHidden = true;
+        return;
+    }
+
     _lineProperties = _screenWindow->getLineProperties();
 }
 
@@ -3368,7 +3326,9 @@ void TerminalDisplay::keyPressEvent(QKeyEvent* event)
     // know where the current selection is.
 
     if (_allowBlinkingCursor) {
-        _blinkCursorTimer->start();
+        if (_blinkTicker != nullptr) {
+            _blinkTicker->restartCursorPhase();
+        }
         if (_cursorBlinking) {
             // if cursor is blinking(hidden), blink it again to show it
             blinkCursorEvent();
@@ -23,6 +23,7 @@
 
 // Qt
 #include <QColor>
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QWidget>
 
@@ -48,6 +49,7 @@ class QHideEvent;
 class QTimerEvent;
 
 namespace Konsole {
+class BlinkTicker;
 class FilterChain;
 class TerminalImageFilterChain;
 class SessionController;
@@ -140,6 +142,13 @@ public:
      */
     void processFilters();
 
+    /**
+     * Marks the hotspots of the filters as out of date and updates them.  This is
+     * used when something other than the image which the filters depend on changed,
+     * such as the files in the directory which FileFilter looks for.
+     */
+    void invalidateFilters();
+
     /**
      * Returns a list of menu actions created by the filters for the content
      * at the given @p position.
@@ -808,6 +817,11 @@ private:
     // draws the preedit string for input methods
     void drawInputMethodPreeditString(QPainter &painter, const QRect &rect);
 
+    // draws the pipeline statistics overlay, if it is enabled for the session
+    void drawStatisticsOverlay(QPainter &painter);
+    // the area in the top right corner covered by the statistics overlay
+    QRect statisticsOverlayRect() const;
+
     // --
 
     // maps an area in the character image to an area on the widget
@@ -834,9 +848,19 @@ private:
 
     void calcGeometry();
     void propagateSize();
-    void updateImageSize();
+    // resizes the local image to fit the widget.  If the number of lines or
+    // columns changed, the new size is passed on to the session right away,
+    // or if @p deferPropagation is true, once the size has settled
+    void updateImageSize(bool deferPropagation = false);
     void makeImage();
 
+    // tells the session about the current number of lines and columns,
+    // cancelling any deferred propagation
+    void propagateContentSize();
+    // passes the size on to the session once it has not changed for
+    // SIZE_SETTLE_DELAY, but at least every MAX_SIZE_PROPAGATION_DELAY
+    void scheduleContentSizePropagation();
+
     void paintFilters(QPainter &painter);
 
     // returns a region covering all of the areas of the widget which contain
@@ -849,6 +873,11 @@ private:
     // redraws the cursor
     void updateCursor();
 
+    // subscribes to or unsubscribes from the window's shared blink ticker,
+    // depending on whether the display is visible, focused and has something
+    // to blink
+    void updateBlinkSubscriptions();
+
     bool handleShortcutOverrideEvent(QKeyEvent *keyEvent);
 
     void doPaste(QString text, bool appendReturn);
@@ -902,6 +931,7 @@ private:
     uint _randomSeed;
 
     bool _resizing;
+    bool _dirtySinceHidden; // output changed whilst the view was not visible
     bool _showTerminalSizeHint;
     bool _bidiEnabled;
     bool _mouseMarks;
@@ -931,8 +961,10 @@ private:
     bool _textBlinking;   // text is blinking, hide it when drawing
     bool _cursorBlinking;     // cursor is blinking, hide it when drawing
     bool _hasTextBlinker; // has characters to blink
-    QTimer *_blinkTextTimer;
-    QTimer *_blinkCursorTimer;
+    QRegion _blinkingRegion; // area of the widget covered by blinking characters
+    QPointer<BlinkTicker> _blinkTicker; // the shared ticker we are subscribed to, if any
+    bool _textBlinkSubscribed;
+    bool _cursorBlinkSubscribed;
 
     Qt::KeyboardModifiers _urlHintsModifiers;
     bool _showUrlHint;
@@ -948,6 +980,10 @@ private:
     QLabel *_resizeWidget;
     QTimer *_resizeTimer;
 
+    // defers resizing the screen and the pty while the widget is being resized
+    QTimer *_sizePropagationTimer;
+    QElapsedTimer _sizePropagationPending; // valid while a propagation is deferred
+
     bool _flowControlWarningEnabled;
 
     //widgets related to the warning message that appears when the user presses Ctrl+S to suspend
@@ -985,12 +1021,15 @@ private:
 
     bool _printerFriendly; // are we currently painting to a printer in black/white mode
 
-    //the delay in milliseconds between redrawing blinking text
-    static const int TEXT_BLINK_DELAY = 500;
-
     //the duration of the size hint in milliseconds
     static const int SIZE_HINT_DURATION = 1000;
 
+    // while the widget is being resized interactively, the screen and pty are
+    // resized once the size has been stable for SIZE_SETTLE_DELAY milliseconds,
+    // and at least every MAX_SIZE_PROPAGATION_DELAY milliseconds
+    static const int SIZE_SETTLE_DELAY = 100;
+    static const int MAX_SIZE_PROPAGATION_DELAY = 400;
+
     SessionController *_sessionController;
 
     bool _trimLeadingSpaces;   // trim leading spaces in selected text
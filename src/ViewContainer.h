@@ -30,6 +30,7 @@
 
 // Konsole
 #include "Profile.h"
+#include "konsoleprivate_export.h"
 
 class QStackedWidget;
 class QWidget;
@@ -60,7 +61,7 @@ class TabbedViewContainer;
  * to actually add or remove view widgets from the container widget, as well
  * as updating any navigation aids.
  */
-class ViewContainer : public QObject
+class KONSOLEPRIVATE_EXPORT ViewContainer : public QObject
 {
     Q_OBJECT
 
@@ -384,7 +385,7 @@ class ViewManager;
  * An alternative tabbed view container which uses a QTabBar and QStackedWidget
  * combination for navigation instead of QTabWidget
  */
-class TabbedViewContainer : public ViewContainer
+class KONSOLEPRIVATE_EXPORT TabbedViewContainer : public ViewContainer
 {
     Q_OBJECT
 
@@ -25,6 +25,7 @@
 // Qt
 #include <QStringList>
 #include <QAction>
+#include <QTimer>
 
 // KDE
 #include <KAcceleratorManager>
@@ -41,7 +42,10 @@
 #include "TerminalDisplay.h"
 #include "SessionController.h"
 #include "SessionManager.h"
+#include "SessionPlaceholder.h"
+#include "SessionPool.h"
 #include "ProfileManager.h"
+#include "StartupTrace.h"
 #include "ViewSplitter.h"
 #include "Enumeration.h"
 
@@ -52,6 +56,8 @@ int ViewManager::lastManagerId = 0;
 ViewManager::ViewManager(QObject *parent, KActionCollection *collection) :
     QObject(parent),
     _viewSplitter(nullptr),
+    _warmUpTimer(nullptr),
+    _warmUpRestoredSessions(false),
     _actionCollection(collection),
     _navigationMethod(TabbedNavigation),
     _navigationVisibility(ViewContainer::AlwaysShowNavigation),
@@ -78,6 +84,12 @@ ViewManager::ViewManager(QObject *parent, KActionCollection *collection) :
     // setup actions which are related to the views
     setupActions();
 
+    // start the sessions of restored tabs in the background, if enabled
+    _warmUpTimer = new QTimer(this);
+    _warmUpTimer->setInterval(WARM_UP_INTERVAL);
+    connect(_warmUpTimer, &QTimer::timeout, this,
+            &Konsole::ViewManager::warmUpNextPlaceholder);
+
     // emit a signal when all of the views held by this view manager are destroyed
     connect(_viewSplitter.data(), &Konsole::ViewSplitter::allContainersEmpty,
             this, &Konsole::ViewManager::empty);
@@ -98,7 +110,13 @@ ViewManager::ViewManager(QObject *parent, KActionCollection *collection) :
                                                  + QString::number(_managerId), this);
 }
 
-ViewManager::~ViewManager() = default;
+ViewManager::~ViewManager()
+{
+    SessionManager *sessionManager = SessionManager::instance();
+    if (sessionManager != nullptr) {
+        sessionManager->sessionPool()->removeWindow(_managerId);
+    }
+}
 
 int ViewManager::managerId() const
 {
@@ -412,6 +430,13 @@ void ViewManager::sessionFinished()
         }
     }
 
+    // and the placeholder if the session was never shown
+    foreach (QWidget *placeholder, _placeholderMap.keys(session)) {
+        _placeholderMap.remove(placeholder);
+        disconnect(placeholder, &QObject::destroyed, session, &Konsole::Session::close);
+        placeholder->deleteLater();
+    }
+
     // Only remove the controller from factory() if it's actually controlling
     // the session from the sender.
     // This fixes BUG: 348478 - messed up menus after a detached tab is closed
@@ -426,6 +451,25 @@ void ViewManager::viewActivated(QWidget *view)
 {
     Q_ASSERT(view != nullptr);
 
+    // a placeholder is replaced once the container is done switching tabs,
+    // if it is still the active one then; restoring a window activates
+    // several of them in a row
+    if (_placeholderMap.contains(view)) {
+        QPointer<QWidget> placeholder = view;
+        QTimer::singleShot(0, this, [this, placeholder]() {
+            if (placeholder.isNull() || _viewSplitter.isNull()) {
+                return;
+            }
+            foreach (ViewContainer *container, _viewSplitter->containers()) {
+                if (container->activeView() == placeholder) {
+                    materializePlaceholder(placeholder);
+                    break;
+                }
+            }
+        });
+        return;
+    }
+
     // focus the activated view, this will cause the SessionController
     // to notify the world that the view has been focused and the appropriate UI
     // actions will be plugged in.
@@ -444,6 +488,11 @@ void ViewManager::splitTopBottom()
 
 void ViewManager::splitView(Qt::Orientation orientation)
 {
+    // the new container gets a view for every tab
+    foreach (QWidget *placeholder, _placeholderMap.keys()) {
+        materializePlaceholder(placeholder);
+    }
+
     ViewContainer *container = createContainer();
 
     // iterate over each session which has a view in the current active
@@ -479,10 +528,12 @@ void ViewManager::splitView(Qt::Orientation orientation)
 void ViewManager::removeContainer(ViewContainer *container)
 {
     // remove session map entries for views in this container
+    // placeholders close their session when deleted with the container
     foreach (QWidget *view, container->views()) {
         TerminalDisplay *display = qobject_cast<TerminalDisplay *>(view);
-        Q_ASSERT(display);
-        _sessionMap.remove(display);
+        if (display != nullptr) {
+            _sessionMap.remove(display);
+        }
     }
 
     _viewSplitter->removeContainer(container);
@@ -550,6 +601,100 @@ SessionController *ViewManager::createController(Session *session, TerminalDispl
     return controller;
 }
 
+QWidget *ViewManager::createPlaceholder(Session *session, ViewContainer *container)
+{
+    connect(session, &Konsole::Session::finished, this, &Konsole::ViewManager::sessionFinished,
+            Qt::UniqueConnection);
+    connect(session, &Konsole::Session::runRequested, this,
+            &Konsole::ViewManager::sessionRunRequested, Qt::UniqueConnection);
+
+    auto placeholder = new QWidget(nullptr);
+    auto properties = new SessionPlaceholder(session, placeholder);
+
+    // closing the tab before it was shown closes the session
+    connect(placeholder, &QObject::destroyed, session, &Konsole::Session::close);
+
+    _placeholderMap[placeholder] = session;
+    container->addView(placeholder, properties);
+
+    return placeholder;
+}
+
+void ViewManager::materializePlaceholder(QWidget *placeholder)
+{
+    Session *session = _placeholderMap.take(placeholder);
+    if (session == nullptr) {
+        return;
+    }
+
+    disconnect(placeholder, &QObject::destroyed, session, &Konsole::Session::close);
+
+    foreach (ViewContainer *container, _viewSplitter->containers()) {
+        const int index = container->views().indexOf(placeholder);
+        if (index == -1) {
+            continue;
+        }
+
+        // createView() shows the new view, keep showing the current one
+        // if the placeholder was in the background
+        QWidget *active = container->activeView();
+        createView(session, container, index);
+        if (active != nullptr && active != placeholder
+            && container == _viewSplitter->activeContainer()) {
+            container->setActiveView(active);
+        }
+
+        container->removeView(placeholder);
+        break;
+    }
+
+    placeholder->deleteLater();
+
+    if (!session->isRunning()) {
+        session->run();
+    }
+}
+
+void ViewManager::sessionRunRequested()
+{
+    Session *session = qobject_cast<Session *>(sender());
+    Q_ASSERT(session);
+
+    QWidget *placeholder = _placeholderMap.key(session);
+    if (placeholder != nullptr) {
+        materializePlaceholder(placeholder);
+    }
+}
+
+void ViewManager::warmUpNextPlaceholder()
+{
+    if (_placeholderMap.isEmpty() || _viewSplitter == nullptr) {
+        _warmUpTimer->stop();
+        return;
+    }
+
+    // start the sessions from the first tab to the last
+    foreach (ViewContainer *container, _viewSplitter->containers()) {
+        foreach (QWidget *view, container->views()) {
+            if (_placeholderMap.contains(view)) {
+                materializePlaceholder(view);
+                return;
+            }
+        }
+    }
+}
+
+void ViewManager::setWarmUpRestoredSessions(bool warmUp)
+{
+    _warmUpRestoredSessions = warmUp;
+
+    if (!warmUp) {
+        _warmUpTimer->stop();
+    } else if (!_placeholderMap.isEmpty()) {
+        _warmUpTimer->start();
+    }
+}
+
 void ViewManager::controllerChanged(SessionController *controller)
 {
     if (controller == _pluggedController) {
@@ -574,6 +719,8 @@ IncrementalSearchBar *ViewManager::searchBar() const
 
 void ViewManager::createView(Session *session, ViewContainer *container, int index)
 {
+    StartupTrace::Phase phase("ViewManager::createView");
+
     // notify this view manager when the session finishes so that its view
     // can be deleted
     //
@@ -619,12 +766,7 @@ void ViewManager::createView(Session *session, ViewContainer *container, int ind
 
 void ViewManager::createView(Session *session)
 {
-    // create the default container
-    if (_viewSplitter->containers().count() == 0) {
-        ViewContainer *container = createContainer();
-        _viewSplitter->addContainer(container, Qt::Vertical);
-        emit splitViewToggle(false);
-    }
+    defaultContainer();
 
     // new tab will be put at the end by default.
     int index = -1;
@@ -645,6 +787,18 @@ void ViewManager::createView(Session *session)
     }
 }
 
+ViewContainer *ViewManager::defaultContainer()
+{
+    // create the default container
+    if (_viewSplitter->containers().count() == 0) {
+        ViewContainer *container = createContainer();
+        _viewSplitter->addContainer(container, Qt::Vertical);
+        emit splitViewToggle(false);
+    }
+
+    return _viewSplitter->activeContainer();
+}
+
 ViewContainer *ViewManager::createContainer()
 {
     ViewContainer *container = nullptr;
@@ -825,6 +979,7 @@ void ViewManager::viewDestroyed(QWidget *view)
     // 2. if the session has no views left, close it
     Session *session = _sessionMap[ display ];
     _sessionMap.remove(display);
+    _placeholderMap.remove(view);
     if (session != nullptr) {
         if (session->views().count() == 0) {
             session->close();
@@ -842,7 +997,9 @@ void ViewManager::viewDestroyed(QWidget *view)
 
 TerminalDisplay *ViewManager::createTerminalDisplay(Session *session)
 {
+    StartupTrace::beginPhase("TerminalDisplay");
     auto display = new TerminalDisplay(nullptr);
+    StartupTrace::endPhase("TerminalDisplay");
     display->setRandomSeed(session->sessionId() * 31);
 
     return display;
@@ -1022,14 +1179,15 @@ void ViewManager::saveSessions(KConfigGroup &group)
     if (container == nullptr) {
         return;
     }
-    TerminalDisplay *activeview = qobject_cast<TerminalDisplay *>(container->activeView());
+    QWidget *activeview = container->activeView();
 
     QListIterator<QWidget *> viewIter(container->views());
     int tab = 1;
     while (viewIter.hasNext()) {
-        TerminalDisplay *view = qobject_cast<TerminalDisplay *>(viewIter.next());
-        Q_ASSERT(view);
-        Session *session = _sessionMap[view];
+        QWidget *view = viewIter.next();
+        TerminalDisplay *display = qobject_cast<TerminalDisplay *>(view);
+        Session *session = display != nullptr ? _sessionMap[display] : _placeholderMap.value(view);
+        Q_ASSERT(session);
         ids << SessionManager::instance()->getRestoreId(session);
         unique.insert(session);
         if (view == activeview) {
@@ -1054,8 +1212,11 @@ void ViewManager::restoreSessions(const KConfigGroup &group)
 {
     QList<int> ids = group.readEntry("Sessions", QList<int>());
     int activeTab = group.readEntry("Active", 0);
-    TerminalDisplay *display = nullptr;
+    ViewContainer *container = defaultContainer();
+    QWidget *active = nullptr;
 
+    // the tabs are placeholders until they are activated, only the session
+    // of the active tab is started right away
     int tab = 1;
     foreach (int id, ids) {
         Session *session = SessionManager::instance()->idToSession(id);
@@ -1067,18 +1228,22 @@ void ViewManager::restoreSessions(const KConfigGroup &group)
             break;
         }
 
-        createView(session);
-        if (!session->isRunning()) {
-            session->run();
-        }
+        QWidget *placeholder = createPlaceholder(session, container);
         if (tab++ == activeTab) {
-            display = qobject_cast<TerminalDisplay *>(activeView());
+            active = placeholder;
         }
     }
 
-    if (display != nullptr) {
-        _viewSplitter->activeContainer()->setActiveView(display);
-        display->setFocus(Qt::OtherFocusReason);
+    if (active != nullptr) {
+        container->setActiveView(active);
+    }
+    QWidget *view = container->activeView();
+    if (_placeholderMap.contains(view)) {
+        materializePlaceholder(view);
+    }
+
+    if (_warmUpRestoredSessions && !_placeholderMap.isEmpty()) {
+        _warmUpTimer->start();
     }
 
     if (ids.isEmpty()) { // Session file is unusable, start default Profile
@@ -1093,7 +1258,7 @@ void ViewManager::restoreSessions(const KConfigGroup &group)
 
 int ViewManager::sessionCount()
 {
-    return this->_sessionMap.size();
+    return this->_sessionMap.size() + _placeholderMap.size();
 }
 
 QStringList ViewManager::sessionList()
@@ -1104,6 +1269,9 @@ QStringList ViewManager::sessionList()
     for (i = _sessionMap.constBegin(); i != _sessionMap.constEnd(); ++i) {
         ids.append(QString::number(i.value()->sessionId()));
     }
+    foreach (Session *session, _placeholderMap) {
+        ids.append(QString::number(session->sessionId()));
+    }
 
     return ids;
 }
@@ -1130,14 +1298,40 @@ void ViewManager::setCurrentSession(int sessionId)
             }
         }
     }
+
+    QHash<QWidget *, Session *>::const_iterator placeholder;
+    for (placeholder = _placeholderMap.constBegin(); placeholder != _placeholderMap.constEnd(); ++placeholder) {
+        if (placeholder.value()->sessionId() == sessionId) {
+            ViewContainer *container = _viewSplitter->activeContainer();
+            if (container != nullptr) {
+                container->setActiveView(placeholder.key());
+            }
+            break;
+        }
+    }
+}
+
+Session *ViewManager::createSession(const Profile::Ptr &profile, const QString &directory)
+{
+    Session *session = SessionManager::instance()->sessionPool()->takeSession(profile, managerId(), directory);
+
+    if (session == nullptr) {
+        session = SessionManager::instance()->createSession(profile);
+
+        if (!directory.isEmpty()) {
+            session->setInitialWorkingDirectory(directory);
+        }
+
+        session->addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_WINDOW=/Windows/%1").arg(managerId()));
+    }
+
+    return session;
 }
 
 int ViewManager::newSession()
 {
     Profile::Ptr profile = ProfileManager::instance()->defaultProfile();
-    Session *session = SessionManager::instance()->createSession(profile);
-
-    session->addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_WINDOW=/Windows/%1").arg(managerId()));
+    Session *session = createSession(profile, QString());
 
     this->createView(session);
     session->run();
@@ -1157,9 +1351,7 @@ int ViewManager::newSession(const QString &profile)
         }
     }
 
-    Session *session = SessionManager::instance()->createSession(profileptr);
-
-    session->addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_WINDOW=/Windows/%1").arg(managerId()));
+    Session *session = createSession(profileptr, QString());
 
     this->createView(session);
     session->run();
@@ -1179,10 +1371,7 @@ int ViewManager::newSession(const QString &profile, const QString &directory)
         }
     }
 
-    Session *session = SessionManager::instance()->createSession(profileptr);
-    session->setInitialWorkingDirectory(directory);
-
-    session->addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_WINDOW=/Windows/%1").arg(managerId()));
+    Session *session = createSession(profileptr, directory);
 
     this->createView(session);
     session->run();
@@ -1190,6 +1379,44 @@ int ViewManager::newSession(const QString &profile, const QString &directory)
     return session->sessionId();
 }
 
+int ViewManager::newHeadlessSession(const QString &profile, int lines, int columns)
+{
+    const QList<Profile::Ptr> profilelist = ProfileManager::instance()->allProfiles();
+    Profile::Ptr profileptr = ProfileManager::instance()->defaultProfile();
+
+    for (const auto &i : profilelist) {
+        if (i->name() == profile) {
+            profileptr = i;
+            break;
+        }
+    }
+
+    // not from the SessionPool, whose sessions have the profile's size
+    Session *session = SessionManager::instance()->createSession(profileptr);
+    session->addEnvironmentEntry(QStringLiteral("KONSOLE_DBUS_WINDOW=/Windows/%1").arg(managerId()));
+    session->setDarkBackground(colorSchemeForProfile(profileptr)->hasDarkBackground());
+    session->setHeadlessSize(qMax(lines, 1), qMax(columns, 1));
+
+    return session->sessionId();
+}
+
+void ViewManager::attachSession(int sessionId)
+{
+    Session *session = SessionManager::instance()->idToSession(sessionId);
+    if (session == nullptr) {
+        return;
+    }
+
+    // sessions which are shown already, or restored here but not shown yet,
+    // are only switched to
+    if (!session->views().isEmpty() || !_placeholderMap.keys(session).isEmpty()) {
+        setCurrentSession(sessionId);
+        return;
+    }
+
+    createView(session);
+}
+
 QString ViewManager::defaultProfile()
 {
     return ProfileManager::instance()->defaultProfile()->name();
@@ -1229,6 +1456,12 @@ void ViewManager::setTabWidthToText(bool useTextWidth)
 
 void ViewManager::closeTabFromContainer(ViewContainer *container, QWidget *tab)
 {
+    // the session of a placeholder has nothing to confirm
+    if (_placeholderMap.contains(tab)) {
+        _placeholderMap.value(tab)->close();
+        return;
+    }
+
     SessionController *controller = qobject_cast<SessionController *>(container->viewProperties(tab));
     Q_ASSERT(controller);
     if (controller != nullptr) {
@@ -29,6 +29,8 @@
 #include "Profile.h"
 #include "ViewContainer.h"
 
+class QTimer;
+
 class KActionCollection;
 class KConfigGroup;
 
@@ -81,6 +83,16 @@ public:
      */
     void createView(Session *session);
 
+    /**
+     * Creates a new session for this view manager's window using @p profile,
+     * starting in @p directory or the profile's initial directory if
+     * @p directory is empty.  The session has no view yet.
+     *
+     * Takes a session which was started in advance from the SessionManager's
+     * SessionPool if possible, so that its prompt is shown right away.
+     */
+    Session *createSession(const Profile::Ptr &profile, const QString &directory);
+
     /**
      * Applies the view-specific settings associated with specified @p profile
      * to the terminal display @p view.
@@ -160,10 +172,24 @@ public:
 
     /**
      * Session management
+     *
+     * Restored tabs are placeholders until they are first shown or their
+     * session receives input over D-Bus, only then is the session started
+     * and its view created.
      */
     void saveSessions(KConfigGroup &group);
     void restoreSessions(const KConfigGroup &group);
 
+    /**
+     * Sets whether the sessions of restored tabs which have not been shown
+     * yet are started in the background, one every WARM_UP_INTERVAL
+     * milliseconds.
+     */
+    void setWarmUpRestoredSessions(bool warmUp);
+
+    /** The interval, in milliseconds, between starting restored sessions in the background */
+    static const int WARM_UP_INTERVAL = 1000;
+
     void setNavigationVisibility(int visibility);
     void setNavigationPosition(int position);
     void setNavigationBehavior(int behavior);
@@ -264,6 +290,20 @@ public Q_SLOTS:
      */
     Q_SCRIPTABLE int newSession(const QString &profile, const QString &directory);
 
+    /** DBus slot that creates and runs a new session without a view, for
+     * scripts which do not need to show the terminal.  The session's screen
+     * and history can be read over D-Bus, attachSession() shows it.
+     * @param profile the name of the profile to be used
+     * @param lines the number of lines of the terminal
+     * @param columns the number of columns of the terminal
+     */
+    Q_SCRIPTABLE int newHeadlessSession(const QString &profile, int lines, int columns);
+
+    /** DBus slot that shows a session without a view, such as one created
+     * by newHeadlessSession(), in a new tab of this window.
+     */
+    Q_SCRIPTABLE void attachSession(int sessionId);
+
     // TODO: its semantic is application-wide. Move it to more appropriate place
     // DBus slot that returns the name of default profile
     Q_SCRIPTABLE QString defaultProfile();
@@ -367,6 +407,11 @@ private Q_SLOTS:
 
     void closeTabFromContainer(ViewContainer *container, QWidget *tab);
 
+    // called when a session whose tab is a placeholder receives input
+    void sessionRunRequested();
+    // starts the session of the next placeholder in the background
+    void warmUpNextPlaceholder();
+
 private:
     Q_DISABLE_COPY(ViewManager)
 
@@ -383,6 +428,8 @@ private:
 
     // creates a new container which can hold terminal displays
     ViewContainer *createContainer();
+    // returns the active container, creating the default one if there is none
+    ViewContainer *defaultContainer();
     // removes a container and emits appropriate signals
     void removeContainer(ViewContainer *container);
 
@@ -396,11 +443,20 @@ private:
     // about the session ( such as title and associated icon ) to the display.
     SessionController *createController(Session *session, TerminalDisplay *view);
 
+    // adds a placeholder tab for a restored session to the container
+    QWidget *createPlaceholder(Session *session, ViewContainer *container);
+    // replaces a placeholder with a terminal display for its session and
+    // starts the session
+    void materializePlaceholder(QWidget *placeholder);
+
 private:
     QPointer<ViewSplitter> _viewSplitter;
     QPointer<SessionController> _pluggedController;
 
     QHash<TerminalDisplay *, Session *> _sessionMap;
+    QHash<QWidget *, Session *> _placeholderMap;
+    QTimer *_warmUpTimer;
+    bool _warmUpRestoredSessions;
 
     KActionCollection *_actionCollection;
 
@@ -26,6 +26,9 @@
 #include <QList>
 #include <QSplitter>
 
+// Konsole
+#include "konsoleprivate_export.h"
+
 class QFocusEvent;
 
 namespace Konsole {
@@ -43,7 +46,7 @@ class ViewContainer;
  * insert a new view container.
  * Containers can only be removed from the hierarchy by deleting them.
  */
-class ViewSplitter : public QSplitter
+class KONSOLEPRIVATE_EXPORT ViewSplitter : public QSplitter
 {
     Q_OBJECT
 
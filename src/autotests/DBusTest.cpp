@@ -21,6 +21,7 @@
 #include "DBusTest.h"
 #include "../Session.h"
 #include <KProcess>
+#include <QTemporaryFile>
 
 using namespace Konsole;
 
@@ -50,7 +51,7 @@ void DBusTest::initTestCase()
     }
 
     // Create a new Konsole with a separate process id
-    int pid = KProcess::startDetached(QStringLiteral("konsole"),
+    int pid = KProcess::startDetached(QStringLiteral(KONSOLE_BINARY),
                                       QStringList(QStringLiteral("--separate")));
     if (pid == 0) {
         QFAIL(QStringLiteral("Unable to exec a new Konsole").toLatin1().data());
@@ -229,4 +230,55 @@ void DBusTest::testSessions()
     }
 }
 
+void DBusTest::testOutput()
+{
+    QDBusReply<qlonglong> sequenceReply;
+    QDBusReply<QString> stringReply;
+    QDBusReply<void> voidReply;
+
+    QDBusInterface iface(_interfaceName,
+                         QStringLiteral("/Sessions/1"),
+                         QStringLiteral("org.kde.konsole.Session"));
+    QVERIFY(iface.isValid());
+
+    sequenceReply = iface.call(QStringLiteral("outputSequence"));
+    QVERIFY(sequenceReply.isValid());
+    const qlonglong since = sequenceReply.value();
+
+    // the marker is split so that only the output of echo matches
+    voidReply = iface.call(QStringLiteral("runCommand"), QStringLiteral("echo DBUS''TEST"));
+    QVERIFY(voidReply.isValid());
+
+    //****************** Test outputSequence and outputText
+    qlonglong sequence = since;
+    QString text;
+    for (int i = 0; i < 50 && !text.contains(QLatin1String("DBUSTEST")); i++) {
+        QTest::qWait(100);
+
+        sequenceReply = iface.call(QStringLiteral("outputSequence"));
+        QVERIFY(sequenceReply.isValid());
+        QVERIFY(sequenceReply.value() >= sequence);
+        sequence = sequenceReply.value();
+
+        stringReply = iface.call(QStringLiteral("outputText"), since, sequence - 1,
+                                 static_cast<int>(Session::PlainTextOutput));
+        QVERIFY(stringReply.isValid());
+        text = stringReply.value();
+    }
+    QVERIFY(text.contains(QLatin1String("DBUSTEST")));
+
+    //****************** Test writeOutput
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    sequenceReply = iface.call(QStringLiteral("writeOutput"), since,
+                               static_cast<int>(Session::HtmlOutput),
+                               QVariant::fromValue(QDBusUnixFileDescriptor(file.handle())));
+    QVERIFY(sequenceReply.isValid());
+    QVERIFY(sequenceReply.value() >= sequence);
+
+    QVERIFY(file.seek(0));
+    QVERIFY(file.readAll().contains("DBUSTEST"));
+}
+
 QTEST_MAIN(DBusTest)
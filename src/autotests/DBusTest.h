@@ -24,6 +24,7 @@
 #include <QDBusInterface>
 #include <QDBusConnectionInterface>
 #include <QDBusReply>
+#include <QDBusUnixFileDescriptor>
 #include <QTextCodec>
 
 #include <unistd.h>
@@ -40,6 +41,7 @@ private Q_SLOTS:
     void initTestCase();
     void cleanupTestCase();
     void testSessions();
+    void testOutput();
 
 // protected slots are not treated as test cases
 protected Q_SLOTS:
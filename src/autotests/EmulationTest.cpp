@@ -0,0 +1,126 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "EmulationTest.h"
+
+// Qt
+#include <QTextCodec>
+#include <QTextStream>
+#include <qtest.h>
+
+// Konsole
+#include "../Emulation.h"
+#include "../Session.h"
+#include "../TerminalCharacterDecoder.h"
+
+using namespace Konsole;
+
+static Session *createUtf8Session()
+{
+    auto session = new Session();
+    session->setCodec(QTextCodec::codecForName("UTF-8"));
+    return session;
+}
+
+static QString firstLine(Emulation *emulation)
+{
+    QString text;
+    QTextStream stream(&text);
+    PlainTextDecoder decoder;
+    decoder.begin(&stream);
+    emulation->writeToStream(&decoder, 0, 0);
+    decoder.end();
+    return text.trimmed();
+}
+
+void EmulationTest::testUtf8SplitAcrossBlocks_data()
+{
+    QTest::addColumn<int>("blockSize");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("3") << 3;
+    QTest::newRow("whole") << 1024;
+}
+
+void EmulationTest::testUtf8SplitAcrossBlocks()
+{
+    QFETCH(int, blockSize);
+
+    // characters of one to three bytes, split at every possible position
+    const QString expected = QStringLiteral("a") + QChar(0xe9) + QChar(0x20ac) + QStringLiteral("b");
+    const QByteArray data = expected.toUtf8();
+
+    Session *session = createUtf8Session();
+    for (int i = 0; i < data.size(); i += blockSize) {
+        const QByteArray block = data.mid(i, blockSize);
+        session->emulation()->receiveData(block.constData(), block.size());
+    }
+
+    QCOMPARE(firstLine(session->emulation()), expected);
+    delete session;
+}
+
+void EmulationTest::testInvalidUtf8()
+{
+    // each invalid sequence is replaced by one replacement character, and
+    // the valid characters around them are kept
+    const QByteArray data("a\xff" "b\xe2\x82" "c\xc0\x80" "d");
+
+    Session *session = createUtf8Session();
+    session->emulation()->receiveData(data.constData(), data.size());
+
+    const QChar replacement(QChar::ReplacementCharacter);
+    QCOMPARE(firstLine(session->emulation()),
+             QStringLiteral("a") + replacement + QStringLiteral("b") + replacement
+             + QStringLiteral("c") + replacement + QStringLiteral("d"));
+    delete session;
+}
+
+void EmulationTest::benchmarkReceiveData()
+{
+    // a MiB of output, passed on in blocks of the size read from a terminal
+    const int BLOCK_SIZE = 16 * 1024;
+    const int MEGABYTE = 1024 * 1024;
+
+    QByteArray line = QByteArrayLiteral("compiling src/Emulation.cpp ");
+    line += QStringLiteral("é€").toUtf8();
+    line += "\r\n";
+    QByteArray data;
+    while (data.size() < MEGABYTE) {
+        data += line;
+    }
+    data.truncate(MEGABYTE);
+
+    Session *session = createUtf8Session();
+    Emulation *emulation = session->emulation();
+
+    // EmulationAllocationManualTest counts the heap allocations made by this
+    QBENCHMARK {
+        for (int i = 0; i < data.size(); i += BLOCK_SIZE) {
+            emulation->receiveData(data.constData() + i, qMin(BLOCK_SIZE, data.size() - i));
+        }
+    }
+
+    delete session;
+}
+
+QTEST_MAIN(EmulationTest)
@@ -0,0 +1,204 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "FileListCacheTest.h"
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <qtest.h>
+
+// Konsole
+#include "../FileListCache.h"
+
+using namespace Konsole;
+
+static void createFile(const QString &fileName)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+}
+
+void FileListCacheTest::init()
+{
+    _directory = new QTemporaryDir();
+    QVERIFY(_directory->isValid());
+}
+
+void FileListCacheTest::cleanup()
+{
+    delete _directory;
+}
+
+QString FileListCacheTest::createDirectory(const QString &name, const QStringList &files)
+{
+    const QString path = _directory->path() + QLatin1Char('/') + name;
+    if (!QDir().mkdir(path)) {
+        return QString();
+    }
+    foreach (const QString &file, files) {
+        createFile(path + QLatin1Char('/') + file);
+    }
+    return QFileInfo(path).canonicalFilePath();
+}
+
+void FileListCacheTest::testBackgroundListing()
+{
+    const QString path = createDirectory(QStringLiteral("listed"),
+                                         QStringList() << QStringLiteral("a.txt") << QStringLiteral("b.txt"));
+    QVERIFY(!path.isEmpty());
+
+    FileListCache cache;
+    QSignalSpy changed(&cache, &Konsole::FileListCache::listingChanged);
+
+    // nothing is known until the directory was listed in the background
+    FileListCache::Listing listing = cache.listing(path);
+    QVERIFY(listing.canonicalPath.isEmpty());
+    QVERIFY(listing.files.isEmpty());
+    QCOMPARE(listing.revision, 0);
+
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).toString(), path);
+    QCOMPARE(cache.canonicalPath(path), path);
+
+    listing = cache.listing(path);
+    QCOMPARE(listing.canonicalPath, path);
+    QCOMPARE(listing.files, QSet<QString>() << QStringLiteral("a.txt") << QStringLiteral("b.txt"));
+    QVERIFY(listing.revision > 0);
+
+    // other paths of the same directory share its listing
+    const QString link = _directory->path() + QStringLiteral("/link");
+    QVERIFY(QFile::link(path, link));
+    QCOMPARE(cache.listing(link).revision, 0);
+    QTRY_COMPARE(cache.canonicalPath(link), path);
+    QCOMPARE(cache.listing(link).revision, listing.revision);
+    QCOMPARE(changed.count(), 1);
+
+    // directories which do not exist are not kept
+    const QString missing = _directory->path() + QStringLiteral("/missing");
+    QCOMPARE(cache.listing(missing).revision, 0);
+    QTest::qWait(100);
+    QVERIFY(cache.canonicalPath(missing).isEmpty());
+    QCOMPARE(changed.count(), 1);
+}
+
+void FileListCacheTest::testDirectoryChanged()
+{
+    const QString path = createDirectory(QStringLiteral("watched"), QStringList() << QStringLiteral("a.txt"));
+    QVERIFY(!path.isEmpty());
+
+    FileListCache cache;
+    QSignalSpy changed(&cache, &Konsole::FileListCache::listingChanged);
+    cache.listing(path);
+    QTRY_COMPARE(changed.count(), 1);
+    const int revision = cache.listing(path).revision;
+
+    // the directory is watched, and listed again the next time it is
+    // asked for after it changed
+    createFile(path + QStringLiteral("/b.txt"));
+    QTRY_VERIFY(cache.listing(path).files.contains(QStringLiteral("b.txt")));
+    QCOMPARE(changed.count(), 2);
+    QCOMPARE(changed.at(1).at(0).toString(), path);
+    QVERIFY(cache.listing(path).revision > revision);
+
+    QVERIFY(QFile::remove(path + QStringLiteral("/a.txt")));
+    QTRY_VERIFY(!cache.listing(path).files.contains(QStringLiteral("a.txt")));
+    QCOMPARE(changed.count(), 3);
+    QCOMPARE(cache.listing(path).files, QSet<QString>() << QStringLiteral("b.txt"));
+}
+
+void FileListCacheTest::testRevisions()
+{
+    const QStringList files = QStringList() << QStringLiteral("a.txt");
+    const QString first = createDirectory(QStringLiteral("first"), files);
+    const QString second = createDirectory(QStringLiteral("second"), files);
+    QVERIFY(!first.isEmpty() && !second.isEmpty());
+
+    FileListCache cache;
+    QSignalSpy changed(&cache, &Konsole::FileListCache::listingChanged);
+    cache.listing(first);
+    cache.listing(second);
+    QTRY_COMPARE(changed.count(), 2);
+
+    // every listing has a revision of its own, even if the files are the same
+    const int firstRevision = cache.listing(first).revision;
+    const int secondRevision = cache.listing(second).revision;
+    QVERIFY(firstRevision != secondRevision);
+    QCOMPARE(cache.listing(first).files, cache.listing(second).files);
+
+    // changes which leave the names of the files alone keep the revision
+    QFile file(first + QStringLiteral("/a.txt"));
+    QVERIFY(file.open(QIODevice::Append));
+    file.write("changed\n");
+    file.close();
+    for (int i = 0; i < 10; i++) {
+        QCOMPARE(cache.listing(first).revision, firstRevision);
+        QTest::qWait(100);
+    }
+    QCOMPARE(changed.count(), 2);
+
+    // other changes make a new one
+    createFile(first + QStringLiteral("/b.txt"));
+    QTRY_VERIFY(cache.listing(first).revision != firstRevision);
+    QVERIFY(cache.listing(first).revision > qMax(firstRevision, secondRevision));
+    QCOMPARE(cache.listing(second).revision, secondRevision);
+}
+
+void FileListCacheTest::testLeastRecentlyUsedEviction()
+{
+    const int count = FileListCache::MAX_DIRECTORIES;
+
+    QStringList paths;
+    for (int i = 0; i <= count; i++) {
+        paths << createDirectory(QStringLiteral("directory%1").arg(i), QStringList() << QStringLiteral("a.txt"));
+        QVERIFY(!paths.last().isEmpty());
+    }
+
+    FileListCache cache;
+    QSignalSpy changed(&cache, &Konsole::FileListCache::listingChanged);
+    for (int i = 0; i < count; i++) {
+        cache.listing(paths[i]);
+    }
+    QTRY_COMPARE(changed.count(), count);
+
+    // using the first directory again leaves the second one as the least
+    // recently used, which makes room for one more
+    const int firstRevision = cache.listing(paths[0]).revision;
+    cache.listing(paths[count]);
+    QTRY_COMPARE(changed.count(), count + 1);
+
+    QVERIFY(cache.canonicalPath(paths[1]).isEmpty());
+    QCOMPARE(cache.listing(paths[0]).revision, firstRevision);
+    for (int i = 2; i <= count; i++) {
+        QCOMPARE(cache.canonicalPath(paths[i]), paths[i]);
+    }
+
+    // the evicted directory is listed again when it is asked for, at the
+    // expense of the next least recently used one
+    QCOMPARE(cache.listing(paths[1]).revision, 0);
+    QTRY_COMPARE(changed.count(), count + 2);
+    QVERIFY(cache.listing(paths[1]).revision > 0);
+    QVERIFY(cache.canonicalPath(paths[2]).isEmpty());
+    QCOMPARE(cache.listing(paths[0]).revision, firstRevision);
+}
+
+QTEST_GUILESS_MAIN(FileListCacheTest)
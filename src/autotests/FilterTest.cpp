@@ -0,0 +1,274 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "FilterTest.h"
+
+// Qt
+#include <qtest.h>
+
+// Konsole
+#include "../Filter.h"
+
+using namespace Konsole;
+
+static const int COLUMNS = 40;
+
+// creates an image with one line per string, padded with spaces
+static QVector<Character> makeImage(const QStringList &lines)
+{
+    QVector<Character> image(lines.count() * COLUMNS);
+    for (int line = 0; line < lines.count(); line++) {
+        const QString &text = lines.at(line);
+        for (int column = 0; column < text.length() && column < COLUMNS; column++) {
+            image[line * COLUMNS + column] = Character(text.at(column).unicode());
+        }
+    }
+    return image;
+}
+
+static void processImage(TerminalImageFilterChain &chain, const QStringList &lines,
+                         const QVector<LineProperty> &properties = QVector<LineProperty>())
+{
+    const QVector<Character> image = makeImage(lines);
+    chain.setImage(image.constData(), lines.count(), COLUMNS,
+                   properties.isEmpty() ? QVector<LineProperty>(lines.count(), LINE_DEFAULT) : properties);
+    chain.process();
+}
+
+void FilterTest::testUrlHotSpots()
+{
+    TerminalImageFilterChain chain;
+    chain.addFilter(new UrlFilter());
+
+    processImage(chain, QStringList() << QStringLiteral("no links here")
+                                      << QStringLiteral("see https://kde.org for more")
+                                      << QString());
+
+    const QList<Filter::HotSpot *> spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 1);
+    QCOMPARE(spots.at(0)->startLine(), 1);
+    QCOMPARE(spots.at(0)->startColumn(), 4);
+    QCOMPARE(spots.at(0)->endLine(), 1);
+    QCOMPARE(spots.at(0)->endColumn(), 19);
+    QCOMPARE(chain.hotSpotAt(1, 10), spots.at(0));
+    QVERIFY(chain.hotSpotAt(0, 10) == nullptr);
+}
+
+void FilterTest::testScrolledHotSpotsAreKept()
+{
+    TerminalImageFilterChain chain;
+    chain.addFilter(new UrlFilter());
+
+    processImage(chain, QStringList() << QStringLiteral("first")
+                                      << QStringLiteral("https://kde.org")
+                                      << QStringLiteral("www.kde.org"));
+    const QList<Filter::HotSpot *> before = chain.hotSpots();
+    QCOMPARE(before.count(), 2);
+
+    // scroll up by one line, the hotspots of the unchanged lines are
+    // kept and moved along with their text
+    processImage(chain, QStringList() << QStringLiteral("https://kde.org")
+                                      << QStringLiteral("www.kde.org")
+                                      << QStringLiteral("mail@kde.org"));
+    const QList<Filter::HotSpot *> after = chain.hotSpots();
+    QCOMPARE(after.count(), 3);
+    QCOMPARE(after.at(0), before.at(0));
+    QCOMPARE(after.at(0)->startLine(), 0);
+    QCOMPARE(after.at(1), before.at(1));
+    QCOMPARE(after.at(1)->startLine(), 1);
+    QCOMPARE(after.at(2)->startLine(), 2);
+}
+
+void FilterTest::testChangedLineIsProcessedAgain()
+{
+    TerminalImageFilterChain chain;
+    chain.addFilter(new UrlFilter());
+
+    processImage(chain, QStringList() << QStringLiteral("https://kde.org")
+                                      << QStringLiteral("$ "));
+    QCOMPARE(chain.hotSpots().count(), 1);
+
+    processImage(chain, QStringList() << QStringLiteral("https://kde.org")
+                                      << QStringLiteral("$ www.kde.org"));
+    QCOMPARE(chain.hotSpots().count(), 2);
+
+    processImage(chain, QStringList() << QStringLiteral("https://kde.org is gone")
+                                      << QStringLiteral("$ "));
+    const QList<Filter::HotSpot *> spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 1);
+    QCOMPARE(spots.at(0)->startLine(), 0);
+    QCOMPARE(spots.at(0)->endColumn(), 15);
+}
+
+void FilterTest::testChangedRegExp()
+{
+    auto filter = new RegExpFilter();
+    filter->setRegExp(QRegularExpression(QStringLiteral("foo")));
+
+    TerminalImageFilterChain chain;
+    chain.addFilter(filter);
+
+    const QStringList lines = QStringList() << QStringLiteral("foo bar")
+                                            << QStringLiteral("bar baz bar");
+    processImage(chain, lines);
+    QCOMPARE(chain.hotSpots().count(), 1);
+
+    // the same image searched for another pattern, as the search bar does
+    // while typing, must not keep the hotspots of the old pattern
+    filter->setRegExp(QRegularExpression(QStringLiteral("bar")));
+    processImage(chain, lines);
+    QList<Filter::HotSpot *> spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 3);
+    QCOMPARE(spots.at(0)->startLine(), 0);
+    QCOMPARE(spots.at(0)->startColumn(), 4);
+    QCOMPARE(spots.at(1)->startLine(), 1);
+    QCOMPARE(spots.at(1)->startColumn(), 0);
+    QCOMPARE(spots.at(2)->startColumn(), 8);
+
+    filter->setRegExp(QRegularExpression(QStringLiteral("BAZ"),
+                                         QRegularExpression::CaseInsensitiveOption));
+    processImage(chain, lines);
+    spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 1);
+    QCOMPARE(spots.at(0)->startLine(), 1);
+    QCOMPARE(spots.at(0)->startColumn(), 4);
+
+    // setting the same pattern again keeps the hotspots
+    filter->setRegExp(QRegularExpression(QStringLiteral("BAZ"),
+                                         QRegularExpression::CaseInsensitiveOption));
+    processImage(chain, lines);
+    QCOMPARE(chain.hotSpots(), spots);
+}
+
+void FilterTest::testWrappedLines()
+{
+    TerminalImageFilterChain chain;
+    chain.addFilter(new UrlFilter());
+
+    QVector<LineProperty> properties(3, LINE_DEFAULT);
+    properties[0] = LINE_WRAPPED;
+
+    // a url continuing on the next line is matched as a whole
+    const QString url = QStringLiteral("https://kde.org/") + QString(COLUMNS, QLatin1Char('a'));
+    processImage(chain, QStringList() << url.left(COLUMNS) << url.mid(COLUMNS) << QString(),
+                 properties);
+
+    QList<Filter::HotSpot *> spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 1);
+    QCOMPARE(spots.at(0)->startLine(), 0);
+    QCOMPARE(spots.at(0)->endLine(), 1);
+
+    // and moved as a whole
+    properties.prepend(LINE_DEFAULT);
+    properties.removeLast();
+    processImage(chain, QStringList() << QString() << url.left(COLUMNS) << url.mid(COLUMNS),
+                 properties);
+    spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 1);
+    QCOMPARE(spots.at(0)->startLine(), 1);
+    QCOMPARE(spots.at(0)->endLine(), 2);
+}
+
+void FilterTest::testWideCharacterColumns()
+{
+    TerminalImageFilterChain chain;
+    chain.addFilter(new UrlFilter());
+
+    // double width characters take two cells, the second of which is
+    // skipped when the image is decoded
+    const QChar wide(0x4e2d);
+    QString line;
+    line += wide;
+    line += QLatin1Char(' ');
+    line += wide;
+    line += QLatin1Char(' ');
+    line += QStringLiteral(" https://kde.org");
+    processImage(chain, QStringList() << QString() << line);
+
+    const QList<Filter::HotSpot *> spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 1);
+    QCOMPARE(spots.at(0)->startLine(), 1);
+    QCOMPARE(spots.at(0)->startColumn(), 5);
+    QCOMPARE(spots.at(0)->endColumn(), 20);
+}
+
+void FilterTest::testHotSpotAt()
+{
+    TerminalImageFilterChain chain;
+    chain.addFilter(new UrlFilter());
+
+    QVector<LineProperty> properties(4, LINE_DEFAULT);
+    properties[1] = LINE_WRAPPED;
+    properties[2] = LINE_WRAPPED;
+
+    const QString url = QStringLiteral("https://kde.org/") + QString(2 * COLUMNS, QLatin1Char('a'));
+    const QString first = QStringLiteral("www.kde.org and ") + url.left(COLUMNS - 16);
+    const QString rest = url.mid(COLUMNS - 16);
+    processImage(chain, QStringList() << QString() << first << rest.left(COLUMNS)
+                                      << rest.mid(COLUMNS) + QStringLiteral(" end"),
+                 properties);
+
+    const QList<Filter::HotSpot *> spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 2);
+    Filter::HotSpot *www = spots.at(0);
+    Filter::HotSpot *wrapped = spots.at(1);
+    QCOMPARE(wrapped->startLine(), 1);
+    QCOMPARE(wrapped->endLine(), 3);
+
+    QCOMPARE(chain.hotSpotAt(1, 0), www);
+    QCOMPARE(chain.hotSpotAt(1, 11), www);
+    QVERIFY(chain.hotSpotAt(1, 13) == nullptr);
+    QCOMPARE(chain.hotSpotAt(1, 16), wrapped);
+    QCOMPARE(chain.hotSpotAt(2, 0), wrapped);
+    QCOMPARE(chain.hotSpotAt(2, COLUMNS - 1), wrapped);
+    QCOMPARE(chain.hotSpotAt(3, 0), wrapped);
+    QVERIFY(chain.hotSpotAt(3, wrapped->endColumn() + 2) == nullptr);
+    QVERIFY(chain.hotSpotAt(0, 0) == nullptr);
+    QVERIFY(chain.hotSpotAt(4, 0) == nullptr);
+}
+
+void FilterTest::testRequiredLiterals()
+{
+    auto filter = new RegExpFilter();
+    filter->setRegExp(QRegularExpression(QStringLiteral("\\d+ms")));
+    filter->setRequiredLiterals(QStringList() << QStringLiteral("ms"));
+
+    TerminalImageFilterChain chain;
+    chain.addFilter(filter);
+
+    // only the lines with the literal are searched, the matches on them
+    // must still be found at the right positions
+    processImage(chain, QStringList() << QStringLiteral("12 34 56")
+                                      << QStringLiteral("took 12ms and 345ms")
+                                      << QStringLiteral("7 ms")
+                                      << QStringLiteral("done in 8ms"));
+
+    const QList<Filter::HotSpot *> spots = chain.hotSpots();
+    QCOMPARE(spots.count(), 3);
+    QCOMPARE(spots.at(0)->startLine(), 1);
+    QCOMPARE(spots.at(0)->startColumn(), 5);
+    QCOMPARE(spots.at(1)->startLine(), 1);
+    QCOMPARE(spots.at(1)->startColumn(), 14);
+    QCOMPARE(spots.at(1)->endColumn(), 19);
+    QCOMPARE(spots.at(2)->startLine(), 3);
+    QCOMPARE(spots.at(2)->startColumn(), 8);
+}
+
+QTEST_GUILESS_MAIN(FilterTest)
@@ -20,6 +20,11 @@
 // Own
 #include "KeyboardTranslatorTest.h"
 
+// Qt
+#include <QFile>
+#include <QMultiHash>
+#include <QScopedPointer>
+
 // KDE
 #include <qtest.h>
 
@@ -27,6 +32,72 @@ using namespace Konsole;
 
 Q_DECLARE_METATYPE(Qt::KeyboardModifiers)
 
+// the modifiers and states of the key presses compared
+static const Qt::KeyboardModifier MODIFIERS[] = {
+    Qt::ShiftModifier, Qt::ControlModifier, Qt::AltModifier,
+    Qt::MetaModifier, Qt::KeypadModifier, Qt::GroupSwitchModifier
+};
+static const int MODIFIER_COUNT = sizeof(MODIFIERS) / sizeof(MODIFIERS[0]);
+static const int STATE_COMBINATIONS = 64;
+
+// key presses typed in the benchmarks: text, editing and moving around
+struct KeyPress {
+    int keyCode;
+    Qt::KeyboardModifiers modifiers;
+};
+static const KeyPress TYPED_KEYS[] = {
+    { Qt::Key_L, Qt::NoModifier }, { Qt::Key_S, Qt::NoModifier },
+    { Qt::Key_Space, Qt::NoModifier }, { Qt::Key_Minus, Qt::NoModifier },
+    { Qt::Key_A, Qt::ShiftModifier }, { Qt::Key_Tab, Qt::NoModifier },
+    { Qt::Key_Backspace, Qt::NoModifier }, { Qt::Key_Return, Qt::NoModifier },
+    { Qt::Key_Up, Qt::NoModifier }, { Qt::Key_Left, Qt::ControlModifier },
+    { Qt::Key_Home, Qt::NoModifier }, { Qt::Key_PageDown, Qt::ShiftModifier },
+    { Qt::Key_C, Qt::ControlModifier }, { Qt::Key_F5, Qt::NoModifier },
+    { Qt::Key_5, Qt::KeypadModifier }, { Qt::Key_Delete, Qt::NoModifier }
+};
+
+// looks up an entry the way KeyboardTranslator::findEntry() did before
+// its entries were compiled into a table
+static KeyboardTranslator::Entry hashLookup(const QMultiHash<int, KeyboardTranslator::Entry> &entries,
+                                            int keyCode, Qt::KeyboardModifiers modifiers,
+                                            KeyboardTranslator::States states)
+{
+    QHash<int, KeyboardTranslator::Entry>::const_iterator i = entries.find(keyCode);
+    while (i != entries.constEnd() && i.key() == keyCode) {
+        if (i.value().matches(keyCode, modifiers, states)) {
+            return i.value();
+        }
+        ++i;
+    }
+    return KeyboardTranslator::Entry();
+}
+
+// the entries of translator, hashed in the same order
+static QMultiHash<int, KeyboardTranslator::Entry> hashedEntries(const KeyboardTranslator *translator)
+{
+    QMultiHash<int, KeyboardTranslator::Entry> entries;
+    const QList<KeyboardTranslator::Entry> list = translator->entries();
+    for (int i = list.count() - 1; i >= 0; i--) {
+        entries.insert(list.at(i).keyCode(), list.at(i));
+    }
+    return entries;
+}
+
+KeyboardTranslator *KeyboardTranslatorTest::loadDefaultTranslator()
+{
+    QFile source(QFINDTESTDATA("../../data/keyboard-layouts/default.keytab"));
+    if (!source.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return nullptr;
+    }
+
+    auto translator = new KeyboardTranslator(QStringLiteral("default"));
+    KeyboardTranslatorReader reader(&source);
+    while (reader.hasNextEntry()) {
+        translator->addEntry(reader.nextEntry());
+    }
+    return translator;
+}
+
 void KeyboardTranslatorTest::testEntryTextWildcards_data()
 {
     // Shift   = 1 + (1 << 0) = 2
@@ -96,5 +167,92 @@ void KeyboardTranslatorTest::testEntryTextWildcards()
     QCOMPARE(entry.text(wildcards, modifiers), result);
 }
 
+void KeyboardTranslatorTest::testFindEntry()
+{
+    QScopedPointer<KeyboardTranslator> translator(loadDefaultTranslator());
+    QVERIFY(translator);
+
+    const QMultiHash<int, KeyboardTranslator::Entry> entries = hashedEntries(translator.data());
+    QList<int> keyCodes = entries.uniqueKeys();
+    keyCodes << Qt::Key_unknown << Qt::Key_Launch0;
+
+    // every combination of the modifiers and states must find the same
+    // entry as testing the entries one by one
+    foreach (int keyCode, keyCodes) {
+        for (int modifierCombination = 0; modifierCombination < (1 << MODIFIER_COUNT); modifierCombination++) {
+            Qt::KeyboardModifiers modifiers = Qt::NoModifier;
+            for (int i = 0; i < MODIFIER_COUNT; i++) {
+                if ((modifierCombination & (1 << i)) != 0) {
+                    modifiers |= MODIFIERS[i];
+                }
+            }
+
+            for (int stateCombination = 0; stateCombination < STATE_COMBINATIONS; stateCombination++) {
+                const KeyboardTranslator::States states(stateCombination);
+                const KeyboardTranslator::Entry expected = hashLookup(entries, keyCode, modifiers, states);
+                const KeyboardTranslator::Entry entry = translator->findEntry(keyCode, modifiers, states);
+                if (!(entry == expected)) {
+                    QFAIL(qPrintable(QStringLiteral("key %1, modifiers %2, states %3: found %4 instead of %5")
+                                     .arg(keyCode, 0, 16).arg(int(modifiers), 0, 16).arg(stateCombination)
+                                     .arg(entry.conditionToString(), expected.conditionToString())));
+                }
+            }
+        }
+    }
+}
+
+void KeyboardTranslatorTest::testFindChangedEntry()
+{
+    KeyboardTranslator translator(QStringLiteral("test"));
+
+    KeyboardTranslator::Entry entry;
+    entry.setKeyCode(Qt::Key_Up);
+    entry.setText("\033[A");
+    translator.addEntry(entry);
+    QCOMPARE(translator.findEntry(Qt::Key_Up, Qt::ShiftModifier), entry);
+
+    // the table is built again once the entries change
+    KeyboardTranslator::Entry shiftEntry = entry;
+    shiftEntry.setModifiers(Qt::ShiftModifier);
+    shiftEntry.setModifierMask(Qt::ShiftModifier);
+    shiftEntry.setText("\033[1;2A");
+    translator.addEntry(shiftEntry);
+    QCOMPARE(translator.findEntry(Qt::Key_Up, Qt::ShiftModifier), shiftEntry);
+    QCOMPARE(translator.findEntry(Qt::Key_Up, Qt::NoModifier), entry);
+
+    translator.removeEntry(entry);
+    QVERIFY(translator.findEntry(Qt::Key_Up, Qt::NoModifier).isNull());
+    QCOMPARE(translator.findEntry(Qt::Key_Up, Qt::ShiftModifier), shiftEntry);
+}
+
+void KeyboardTranslatorTest::benchmarkFindEntry()
+{
+    QScopedPointer<KeyboardTranslator> translator(loadDefaultTranslator());
+    QVERIFY(translator);
+    translator->compile();
+
+    const KeyboardTranslator::States states = KeyboardTranslator::AnsiState;
+    QBENCHMARK {
+        for (const KeyPress &key : TYPED_KEYS) {
+            translator->findEntry(key.keyCode, key.modifiers, states);
+        }
+    }
+}
+
+// the way entries were looked up before, for comparison
+void KeyboardTranslatorTest::benchmarkHashLookup()
+{
+    QScopedPointer<KeyboardTranslator> translator(loadDefaultTranslator());
+    QVERIFY(translator);
+    const QMultiHash<int, KeyboardTranslator::Entry> entries = hashedEntries(translator.data());
+
+    const KeyboardTranslator::States states = KeyboardTranslator::AnsiState;
+    QBENCHMARK {
+        for (const KeyPress &key : TYPED_KEYS) {
+            hashLookup(entries, key.keyCode, key.modifiers, states);
+        }
+    }
+}
+
 QTEST_GUILESS_MAIN(KeyboardTranslatorTest)
 
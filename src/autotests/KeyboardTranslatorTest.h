@@ -33,6 +33,13 @@ class KeyboardTranslatorTest : public QObject
 private Q_SLOTS:
     void testEntryTextWildcards();
     void testEntryTextWildcards_data();
+    void testFindEntry();
+    void testFindChangedEntry();
+    void benchmarkFindEntry();
+    void benchmarkHashLookup();
+
+private:
+    KeyboardTranslator *loadDefaultTranslator();
 };
 
 }
@@ -0,0 +1,196 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "LineCharRendererTest.h"
+
+// Qt
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <qtest.h>
+
+// Konsole
+#include "../LineCharRenderer.h"
+
+using namespace Konsole;
+
+static const QSize CELL_SIZE(8, 16);
+
+// draws str with one character per cell into an image of the cells' size
+static QImage drawString(const QString &str, qreal devicePixelRatio = 1)
+{
+    const QSize size(CELL_SIZE.width() * str.length(), CELL_SIZE.height());
+    QImage image(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    LineCharRenderer::drawString(painter, 0, 0, CELL_SIZE, str, Qt::white, false, devicePixelRatio);
+    painter.end();
+
+    return image;
+}
+
+// returns the number of pixels which are drawn but not covered by the
+// rectangles, given in cell coordinates, or covered but not fully drawn
+static int wrongPixels(const QImage &image, const QList<QRect> &expected, qreal devicePixelRatio = 1)
+{
+    int wrong = 0;
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            const QPoint cellPoint(int(x / devicePixelRatio), int(y / devicePixelRatio));
+            bool covered = false;
+            foreach (const QRect &rect, expected) {
+                covered = covered || rect.contains(cellPoint);
+            }
+            const int alpha = qAlpha(image.pixel(x, y));
+            if ((covered && alpha != 255) || (!covered && alpha != 0)) {
+                wrong++;
+            }
+        }
+    }
+    return wrong;
+}
+
+void LineCharRendererTest::init()
+{
+    LineCharRenderer::clearCache();
+}
+
+void LineCharRendererTest::testBlocks_data()
+{
+    QTest::addColumn<int>("code");
+    QTest::addColumn<qreal>("devicePixelRatio");
+    QTest::addColumn<QList<QRect> >("expected");
+
+    const QRect full(QPoint(0, 0), CELL_SIZE);
+    const QList<QRect> nothing;
+
+    QTest::newRow("full block") << 0x2588 << qreal(1) << (QList<QRect>() << full);
+    QTest::newRow("full block, 2x") << 0x2588 << qreal(2) << (QList<QRect>() << full);
+    QTest::newRow("upper half") << 0x2580 << qreal(1) << (QList<QRect>() << QRect(0, 0, 8, 8));
+    QTest::newRow("lower half") << 0x2584 << qreal(1) << (QList<QRect>() << QRect(0, 8, 8, 8));
+    QTest::newRow("lower half, 2x") << 0x2584 << qreal(2) << (QList<QRect>() << QRect(0, 8, 8, 8));
+    QTest::newRow("lower one eighth") << 0x2581 << qreal(1) << (QList<QRect>() << QRect(0, 14, 8, 2));
+    QTest::newRow("left half") << 0x258C << qreal(1) << (QList<QRect>() << QRect(0, 0, 4, 16));
+    QTest::newRow("right half") << 0x2590 << qreal(1) << (QList<QRect>() << QRect(4, 0, 4, 16));
+    QTest::newRow("upper left quadrant") << 0x2598 << qreal(1) << (QList<QRect>() << QRect(0, 0, 4, 8));
+    QTest::newRow("upper left and lower right quadrants") << 0x259A << qreal(1)
+                                                           << (QList<QRect>() << QRect(0, 0, 4, 8)
+                                                                              << QRect(4, 8, 4, 8));
+    QTest::newRow("blank braille") << 0x2800 << qreal(1) << nothing;
+}
+
+void LineCharRendererTest::testBlocks()
+{
+    QFETCH(int, code);
+    QFETCH(qreal, devicePixelRatio);
+    QFETCH(QList<QRect>, expected);
+
+    const QImage image = drawString(QString(QChar(code)), devicePixelRatio);
+    QCOMPARE(image.size(), CELL_SIZE * devicePixelRatio);
+    QCOMPARE(wrongPixels(image, expected, devicePixelRatio), 0);
+}
+
+void LineCharRendererTest::testShades_data()
+{
+    QTest::addColumn<int>("code");
+    QTest::addColumn<int>("alpha");
+
+    QTest::newRow("light") << 0x2591 << 64;
+    QTest::newRow("medium") << 0x2592 << 128;
+    QTest::newRow("dark") << 0x2593 << 192;
+}
+
+void LineCharRendererTest::testShades()
+{
+    QFETCH(int, code);
+    QFETCH(int, alpha);
+
+    // the whole cell is covered with the partly transparent color
+    const QImage image = drawString(QString(QChar(code)));
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            QCOMPARE(qAlpha(image.pixel(x, y)), alpha);
+        }
+    }
+}
+
+void LineCharRendererTest::testBraille()
+{
+    // dots 1 and 8: the dots are 2x2 pixels, centered in the 4x4 pixel
+    // sub-cells of the upper left and lower right corners
+    const QImage image = drawString(QString(QChar(0x2881)));
+    QCOMPARE(wrongPixels(image, QList<QRect>() << QRect(1, 1, 2, 2) << QRect(5, 13, 2, 2)), 0);
+
+    // all eight dots
+    const QImage allDots = drawString(QString(QChar(0x28FF)));
+    QList<QRect> dots;
+    for (int column = 0; column < 2; column++) {
+        for (int row = 0; row < 4; row++) {
+            dots << QRect(column * 4 + 1, row * 4 + 1, 2, 2);
+        }
+    }
+    QCOMPARE(wrongPixels(allDots, dots), 0);
+}
+
+void LineCharRendererTest::testRuns()
+{
+    // runs of the same glyph are tiled, and cells of different glyphs
+    // join without gaps or overlaps
+    const QImage image = drawString(QString(QChar(0x2584)) + QChar(0x2584) + QChar(0x2584)
+                                    + QChar(0x2580) + QChar(0x2588));
+    QCOMPARE(wrongPixels(image, QList<QRect>() << QRect(0, 8, 24, 8) << QRect(24, 0, 8, 8)
+                                                << QRect(32, 0, 8, 16)), 0);
+}
+
+void LineCharRendererTest::testGlyphCache()
+{
+    const QPixmap glyph = LineCharRenderer::glyph(0x2588, CELL_SIZE, Qt::white, false, 1);
+    QCOMPARE(glyph.size(), CELL_SIZE);
+
+    // the same pixmap is returned for the same glyph
+    QCOMPARE(LineCharRenderer::glyph(0x2588, CELL_SIZE, Qt::white, false, 1).cacheKey(),
+             glyph.cacheKey());
+
+    // and another one for another cell size, device pixel ratio, color
+    // or weight
+    const QPixmap larger = LineCharRenderer::glyph(0x2588, QSize(9, 18), Qt::white, false, 1);
+    QVERIFY(larger.cacheKey() != glyph.cacheKey());
+    QCOMPARE(larger.size(), QSize(9, 18));
+
+    const QPixmap scaled = LineCharRenderer::glyph(0x2588, CELL_SIZE, Qt::white, false, 2);
+    QVERIFY(scaled.cacheKey() != glyph.cacheKey());
+    QCOMPARE(scaled.size(), CELL_SIZE * 2);
+    QCOMPARE(scaled.devicePixelRatio(), qreal(2));
+
+    QVERIFY(LineCharRenderer::glyph(0x2588, CELL_SIZE, Qt::red, false, 1).cacheKey() != glyph.cacheKey());
+    QVERIFY(LineCharRenderer::glyph(0x2588, CELL_SIZE, Qt::white, true, 1).cacheKey() != glyph.cacheKey());
+
+    // each of them is kept
+    QCOMPARE(LineCharRenderer::glyph(0x2588, CELL_SIZE, Qt::white, false, 2).cacheKey(),
+             scaled.cacheKey());
+
+    LineCharRenderer::clearCache();
+    QVERIFY(LineCharRenderer::glyph(0x2588, CELL_SIZE, Qt::white, false, 1).cacheKey() != glyph.cacheKey());
+}
+
+QTEST_MAIN(LineCharRendererTest)
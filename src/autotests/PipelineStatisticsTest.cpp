@@ -0,0 +1,102 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "PipelineStatisticsTest.h"
+
+// Qt
+#include <QTest>
+
+// Konsole
+#include "../PipelineStatistics.h"
+
+using namespace Konsole;
+
+void PipelineStatisticsTest::testDisabledByDefault()
+{
+    qunsetenv("KONSOLE_PIPELINE_STATISTICS");
+
+    PipelineStatistics statistics;
+    QVERIFY(!statistics.isEnabled());
+
+    statistics.setOverlayVisible(true);
+    QVERIFY(!statistics.isOverlayVisible());
+
+    statistics.add(PipelineStatistics::BytesIn, 100);
+    statistics.addSample(PipelineStatistics::Paint, 1000);
+    statistics.setEnabled(true);
+    QVERIFY(statistics.isOverlayVisible());
+    QVERIFY(statistics.report().contains(QLatin1String("bytes in: 0 ")));
+    QVERIFY(statistics.report().contains(QLatin1String("paint: n=0 ")));
+}
+
+void PipelineStatisticsTest::testCounters()
+{
+    PipelineStatistics statistics;
+    statistics.setEnabled(true);
+
+    statistics.add(PipelineStatistics::BytesIn, 100);
+    statistics.add(PipelineStatistics::BytesIn, 23);
+    statistics.add(PipelineStatistics::DirtyLines, 7);
+    QVERIFY(statistics.report().contains(QLatin1String("bytes in: 123 ")));
+    QVERIFY(statistics.report().contains(QLatin1String("dirty lines: 7 ")));
+    QCOMPARE(statistics.counter(PipelineStatistics::BytesIn), qint64(123));
+
+    statistics.reset();
+    QVERIFY(statistics.report().contains(QLatin1String("bytes in: 0 ")));
+}
+
+void PipelineStatisticsTest::testStageTimer()
+{
+    PipelineStatistics statistics;
+
+    {
+        PipelineStatistics::StageTimer timer(&statistics, PipelineStatistics::Parse);
+    }
+    {
+        PipelineStatistics::StageTimer timer(nullptr, PipelineStatistics::Parse);
+    }
+
+    statistics.setEnabled(true);
+    {
+        PipelineStatistics::StageTimer timer(&statistics, PipelineStatistics::Parse);
+    }
+    QVERIFY(statistics.report().contains(QLatin1String("parse: n=1 ")));
+}
+
+void PipelineStatisticsTest::testSampleRingBuffer()
+{
+    PipelineStatistics statistics;
+    statistics.setEnabled(true);
+
+    // fill the ring with slow samples, then overwrite all of them with fast ones
+    for (int i = 0; i < PipelineStatistics::SAMPLE_COUNT; i++) {
+        statistics.addSample(PipelineStatistics::Paint, 100 * 1000 * 1000);
+    }
+    for (int i = 0; i < PipelineStatistics::SAMPLE_COUNT; i++) {
+        statistics.addSample(PipelineStatistics::Paint, 1000 * 1000);
+    }
+
+    const QString report = statistics.report();
+    QVERIFY(report.contains(QStringLiteral("paint: n=%1 mean=1.00 p50=1.00 p95=1.00 max=1.00")
+                            .arg(PipelineStatistics::SAMPLE_COUNT)));
+    QVERIFY(report.contains(QStringLiteral("<4000:%1 ").arg(PipelineStatistics::SAMPLE_COUNT)));
+}
+
+QTEST_GUILESS_MAIN(PipelineStatisticsTest)
@@ -0,0 +1,220 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "ProcParserTest.h"
+
+// Standard
+#include <errno.h>
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTest>
+#include <QTextStream>
+
+// Konsole
+#include "../ProcParser.h"
+
+using namespace Konsole;
+
+// the number of processes in the synthetic /proc tree
+static const int PROCESS_COUNT = 200;
+static const int FIRST_PID = 1000;
+
+static void writeFile(const QString &path, const QByteArray &contents)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+}
+
+void ProcParserTest::initTestCase()
+{
+    QVERIFY(_procDir.isValid());
+    _procPath = QFile::encodeName(_procDir.path());
+
+    // a status file of realistic size, with the uid in the middle
+    QByteArray statusPadding;
+    for (int i = 0; i < 40; i++) {
+        statusPadding += "VmField" + QByteArray::number(i) + ":\t  123456 kB\n";
+    }
+
+    QDir root(_procDir.path());
+    for (int pid = FIRST_PID; pid < FIRST_PID + PROCESS_COUNT; pid++) {
+        const QString name = QString::number(pid);
+        QVERIFY(root.mkdir(name));
+        const QString dir = root.filePath(name);
+
+        writeFile(dir + QStringLiteral("/stat"),
+                  QByteArray::number(pid) + " (bash) S " + QByteArray::number(pid - 1)
+                  + " " + QByteArray::number(pid) + " " + QByteArray::number(pid)
+                  + " 34817 " + QByteArray::number(pid + 1)
+                  + " 4194304 13716 2216213 0 13 25 2262 1174 20 0 1 0 2577 23949312 1392\n");
+        writeFile(dir + QStringLiteral("/status"),
+                  "Name:\tbash\nUmask:\t0022\nState:\tS (sleeping)\nTgid:\t" + QByteArray::number(pid)
+                  + "\nPPid:\t" + QByteArray::number(pid - 1)
+                  + "\nUid:\t1000\t1000\t1000\t1000\nGid:\t100\t100\t100\t100\n" + statusPadding);
+        writeFile(dir + QStringLiteral("/cmdline"), QByteArray("/bin/bash\0--login\0-i\0", 22));
+        QVERIFY(QFile::link(QDir::tempPath(), dir + QStringLiteral("/cwd")));
+    }
+}
+
+void ProcParserTest::testParseStat()
+{
+    const QByteArray data("4242 (vim) S 4200 4242 4200 34818 4242 4194304 1 2 3\n");
+
+    ProcParser::ProcessStatus status;
+    QVERIFY(ProcParser::parseStat(data.constData(), data.size(), status));
+    QCOMPARE(QByteArray(status.name), QByteArray("vim"));
+    QCOMPARE(status.parentPid, 4200);
+    QCOMPARE(status.foregroundPid, 4242);
+}
+
+void ProcParserTest::testParseStatNameWithParentheses()
+{
+    // the name ends at the last closing parenthesis, and a process
+    // without a terminal has a foreground process group of -1
+    const QByteArray data("17 (a) b (c)) R 1 17 17 0 -1 4194560 0\n");
+
+    ProcParser::ProcessStatus status;
+    QVERIFY(ProcParser::parseStat(data.constData(), data.size(), status));
+    QCOMPARE(QByteArray(status.name), QByteArray("a) b (c)"));
+    QCOMPARE(status.parentPid, 1);
+    QCOMPARE(status.foregroundPid, -1);
+}
+
+void ProcParserTest::testParseStatInvalid()
+{
+    ProcParser::ProcessStatus status;
+
+    const QByteArray noName("17 bash S 1 17 17 0 -1\n");
+    QVERIFY(!ProcParser::parseStat(noName.constData(), noName.size(), status));
+
+    const QByteArray truncated("17 (bash) S 1 17");
+    QVERIFY(!ProcParser::parseStat(truncated.constData(), truncated.size(), status));
+
+    const QByteArray notANumber("17 (bash) S x 17 17 0 -1\n");
+    QVERIFY(!ProcParser::parseStat(notANumber.constData(), notANumber.size(), status));
+}
+
+void ProcParserTest::testParseUserId()
+{
+    const QByteArray data("Name:\tsu\nUid:\t0\t1000\t0\t0\nGid:\t0\t0\t0\t0\n");
+    int userId = -1;
+    QVERIFY(ProcParser::parseUserId(data.constData(), data.size(), userId));
+    QCOMPARE(userId, 0);
+
+    // user ids of more than five digits are valid
+    const QByteArray large("Uid:\t1234567\t1234567\t1234567\t1234567");
+    QVERIFY(ProcParser::parseUserId(large.constData(), large.size(), userId));
+    QCOMPARE(userId, 1234567);
+
+    const QByteArray missing("Name:\tbash\nGid:\t0\t0\t0\t0\n");
+    QVERIFY(!ProcParser::parseUserId(missing.constData(), missing.size(), userId));
+}
+
+void ProcParserTest::testReadProcess()
+{
+    const ProcParser parser(_procPath.constData());
+
+    ProcParser::ProcessStatus status;
+    QVERIFY(parser.readStatus(FIRST_PID, status));
+    QCOMPARE(QByteArray(status.name), QByteArray("bash"));
+    QCOMPARE(status.parentPid, FIRST_PID - 1);
+    QCOMPARE(status.foregroundPid, FIRST_PID + 1);
+    QCOMPARE(status.userId, 1000);
+
+    char arguments[256];
+    const int length = parser.readArguments(FIRST_PID, arguments, sizeof(arguments));
+    QCOMPARE(QByteArray(arguments, length), QByteArray("/bin/bash\0--login\0-i\0", 22));
+
+    char dir[256];
+    QVERIFY(parser.readCurrentDir(FIRST_PID, dir, sizeof(dir)) > 0);
+    QCOMPARE(QFile::decodeName(dir), QDir::tempPath());
+}
+
+void ProcParserTest::testMissingProcess()
+{
+    const ProcParser parser(_procPath.constData());
+
+    ProcParser::ProcessStatus status;
+    int error = 0;
+    QVERIFY(!parser.readStatus(FIRST_PID - 1, status, &error));
+    QCOMPARE(error, ENOENT);
+
+    char buffer[16];
+    QCOMPARE(parser.readArguments(FIRST_PID - 1, buffer, sizeof(buffer)), -1);
+    QCOMPARE(parser.readCurrentDir(FIRST_PID - 1, buffer, sizeof(buffer)), -1);
+}
+
+void ProcParserTest::benchmarkProcParser()
+{
+    const ProcParser parser(_procPath.constData());
+
+    QBENCHMARK {
+        for (int pid = FIRST_PID; pid < FIRST_PID + PROCESS_COUNT; pid++) {
+            ProcParser::ProcessStatus status;
+            char arguments[4096];
+            char dir[4096];
+            QVERIFY(parser.readStatus(pid, status));
+            QVERIFY(parser.readArguments(pid, arguments, sizeof(arguments)) > 0);
+            QVERIFY(parser.readCurrentDir(pid, dir, sizeof(dir)) > 0);
+        }
+    }
+}
+
+// the way the files were read before, for comparison
+void ProcParserTest::benchmarkQTextStream()
+{
+    QBENCHMARK {
+        for (int pid = FIRST_PID; pid < FIRST_PID + PROCESS_COUNT; pid++) {
+            const QString dir = QFile::decodeName(_procPath) + QLatin1Char('/') + QString::number(pid);
+
+            QFile statusFile(dir + QStringLiteral("/status"));
+            QVERIFY(statusFile.open(QIODevice::ReadOnly));
+            QTextStream statusStream(&statusFile);
+            QString uidLine;
+            QString line;
+            do {
+                line = statusStream.readLine();
+                if (line.startsWith(QLatin1String("Uid:"))) {
+                    uidLine = line;
+                }
+            } while (!line.isNull() && uidLine.isNull());
+            QCOMPARE(uidLine.split(QLatin1Char('\t'), QString::SkipEmptyParts).size(), 5);
+
+            QFile statFile(dir + QStringLiteral("/stat"));
+            QVERIFY(statFile.open(QIODevice::ReadOnly));
+            QTextStream statStream(&statFile);
+            QVERIFY(!statStream.readAll().isEmpty());
+
+            QFile argumentsFile(dir + QStringLiteral("/cmdline"));
+            QVERIFY(argumentsFile.open(QIODevice::ReadOnly));
+            QTextStream argumentsStream(&argumentsFile);
+            QCOMPARE(argumentsStream.readAll().split(QLatin1Char('\0')).size(), 4);
+
+            QVERIFY(!QFileInfo(dir + QStringLiteral("/cwd")).symLinkTarget().isEmpty());
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(ProcParserTest)
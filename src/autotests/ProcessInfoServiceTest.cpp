@@ -0,0 +1,218 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+// Own
+#include "ProcessInfoServiceTest.h"
+
+// Qt
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <qtest.h>
+
+// Konsole
+#include "../Emulation.h"
+#include "../PipelineStatistics.h"
+#include "../ProcessInfoService.h"
+#include "../ProfileManager.h"
+#include "../Session.h"
+#include "../SessionManager.h"
+
+using namespace Konsole;
+
+static const int SESSIONS = 2;
+
+static QString sessionDirectory(const QTemporaryDir &directory, int session)
+{
+    return QFileInfo(directory.path() + QStringLiteral("/session%1").arg(session)).canonicalFilePath();
+}
+
+static qint64 processInfoReads(Session *session)
+{
+    return session->emulation()->statistics()->counter(PipelineStatistics::ProcessInfoReads);
+}
+
+void ProcessInfoServiceTest::initTestCase()
+{
+    QVERIFY(_directory.isValid());
+    for (int session = 0; session < SESSIONS; session++) {
+        QVERIFY(QDir().mkdir(_directory.path() + QStringLiteral("/session%1").arg(session)));
+    }
+
+    // an interactive shell, which runs the commands it is sent as the
+    // foreground process of its terminal
+    _profile = Profile::Ptr(new Profile(ProfileManager::instance()->fallbackProfile()));
+    _profile->setProperty(Profile::Command, QStringLiteral("/bin/sh"));
+    _profile->setProperty(Profile::Arguments, QStringList() << QStringLiteral("sh"));
+}
+
+void ProcessInfoServiceTest::init()
+{
+    _service = new ProcessInfoService(this);
+
+    for (int i = 0; i < SESSIONS; i++) {
+        Session *session = SessionManager::instance()->createSession(_profile);
+        // only the service under test updates the session
+        SessionManager::instance()->processInfoService()->removeSession(session);
+        _service->addSession(session);
+
+        session->setInitialWorkingDirectory(sessionDirectory(_directory, i));
+        session->setPipelineStatisticsEnabled(true);
+        session->setHeadlessSize(24, 80);
+        _sessions << session;
+    }
+
+    // wait for the prompts, the shells are ready to read commands then
+    foreach (const QPointer<Session> &session, _sessions) {
+        QTRY_VERIFY(session->isRunning());
+        QTRY_VERIFY(!session->screenText().trimmed().isEmpty());
+    }
+}
+
+void ProcessInfoServiceTest::cleanup()
+{
+    delete _service;
+
+    foreach (const QPointer<Session> &session, _sessions) {
+        if (session != nullptr) {
+            session->close();
+        }
+    }
+    foreach (const QPointer<Session> &session, _sessions) {
+        QTRY_VERIFY(session.isNull());
+    }
+    _sessions.clear();
+}
+
+void ProcessInfoServiceTest::poll()
+{
+    // instead of waiting for the next POLL_INTERVAL
+    QVERIFY(QMetaObject::invokeMethod(_service, "poll"));
+}
+
+void ProcessInfoServiceTest::testPollUpdatesAllSessions()
+{
+    QList<QSignalSpy *> spies;
+    QList<qint64> reads;
+    foreach (const QPointer<Session> &session, _sessions) {
+        QVERIFY(session->processInfoMayHaveChanged());
+        spies << new QSignalSpy(session.data(), &Konsole::Session::processInfoChanged);
+        reads << processInfoReads(session);
+    }
+
+    // the first update of a session always reports its state
+    poll();
+    for (int i = 0; i < SESSIONS; i++) {
+        QCOMPARE(spies[i]->count(), 1);
+        QVERIFY(processInfoReads(_sessions[i]) > reads[i]);
+        QVERIFY(!_sessions[i]->processInfoMayHaveChanged());
+        QCOMPARE(_sessions[i]->currentWorkingDirectory(), sessionDirectory(_directory, i));
+    }
+
+    // idle sessions are not read again
+    for (int i = 0; i < SESSIONS; i++) {
+        reads[i] = processInfoReads(_sessions[i]);
+    }
+    poll();
+    for (int i = 0; i < SESSIONS; i++) {
+        QCOMPARE(spies[i]->count(), 1);
+        QCOMPARE(processInfoReads(_sessions[i]), reads[i]);
+    }
+
+    qDeleteAll(spies);
+}
+
+void ProcessInfoServiceTest::testRequestsWithinCacheTtl()
+{
+    Session *session = _sessions[0];
+    poll();
+
+    // what a single update reads
+    QElapsedTimer timer;
+    timer.start();
+    qint64 reads = processInfoReads(session);
+    session->refreshProcessInfo();
+    const qint64 updateReads = processInfoReads(session) - reads;
+    QVERIFY(updateReads > 0);
+
+    // everything asking again in the meantime shares what was read
+    session->foregroundProcessName();
+    reads = processInfoReads(session);
+    session->getDynamicTitle();
+    session->foregroundProcessName();
+    session->getUrl();
+    session->getDynamicTitle();
+    if (timer.hasExpired(ProcessInfoService::CACHE_TTL)) {
+        QSKIP("The cached process information expired before it was used");
+    }
+    QCOMPARE(processInfoReads(session), reads);
+
+    // requests made before the delay runs out are handled by one update
+    _service->requestUpdate(session, ProcessInfoService::PROCESS_CHANGE_DELAY);
+    _service->requestUpdate(session, ProcessInfoService::PROCESS_CHANGE_DELAY);
+    QTRY_VERIFY(processInfoReads(session) > reads);
+    QTest::qWait(ProcessInfoService::PROCESS_CHANGE_DELAY * 2);
+    QCOMPARE(processInfoReads(session) - reads, updateReads);
+
+    // once the cache expired the processes are read again
+    QTest::qWait(ProcessInfoService::CACHE_TTL + 100);
+    reads = processInfoReads(session);
+    session->getDynamicTitle();
+    QVERIFY(processInfoReads(session) > reads);
+}
+
+void ProcessInfoServiceTest::testProcessInfoChanged()
+{
+    poll();
+
+    QSignalSpy changed0(_sessions[0].data(), &Konsole::Session::processInfoChanged);
+    QSignalSpy changed1(_sessions[1].data(), &Konsole::Session::processInfoChanged);
+
+    // reading an unchanged state again reports nothing
+    _sessions[0]->refreshProcessInfo();
+    _sessions[1]->refreshProcessInfo();
+    QCOMPARE(changed0.count(), 0);
+    QCOMPARE(changed1.count(), 0);
+
+    // a new foreground process is reported once
+    _sessions[0]->sendText(QStringLiteral("sleep 30\n"));
+    QTRY_COMPARE(_sessions[0]->foregroundProcessName(), QStringLiteral("sleep"));
+    poll();
+    QTRY_COMPARE(changed0.count(), 1);
+    QTest::qWait(ProcessInfoService::PROCESS_CHANGE_DELAY * 2);
+    poll();
+    _sessions[0]->refreshProcessInfo();
+    QCOMPARE(changed0.count(), 1);
+    QCOMPARE(changed1.count(), 0);
+
+    // as is a new working directory
+    const QString directory = sessionDirectory(_directory, 0);
+    _sessions[1]->sendText(QStringLiteral("cd %1\n").arg(directory));
+    QTRY_COMPARE(_sessions[1]->getUrl().toLocalFile(), directory);
+    poll();
+    QTRY_COMPARE(changed1.count(), 1);
+    QCOMPARE(_sessions[1]->currentWorkingDirectory(), directory);
+    poll();
+    _sessions[1]->refreshProcessInfo();
+    QCOMPARE(changed0.count(), 1);
+    QCOMPARE(changed1.count(), 1);
+}
+
+QTEST_GUILESS_MAIN(ProcessInfoServiceTest)
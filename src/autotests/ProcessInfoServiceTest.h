@@ -0,0 +1,60 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+#ifndef PROCESSINFOSERVICETEST_H
+#define PROCESSINFOSERVICETEST_H
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTemporaryDir>
+
+// Konsole
+#include "../Profile.h"
+
+namespace Konsole
+{
+class ProcessInfoService;
+class Session;
+
+class ProcessInfoServiceTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testPollUpdatesAllSessions();
+    void testRequestsWithinCacheTtl();
+    void testProcessInfoChanged();
+
+private:
+    void poll();
+
+    Profile::Ptr _profile;
+    QTemporaryDir _directory;
+    ProcessInfoService *_service;
+    QList<QPointer<Session> > _sessions;
+};
+
+}
+
+#endif // PROCESSINFOSERVICETEST_H
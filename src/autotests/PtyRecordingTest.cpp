@@ -0,0 +1,182 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "PtyRecordingTest.h"
+
+// Qt
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Konsole
+#include "../PtyRecording.h"
+
+using namespace Konsole;
+
+// replays fileName as fast as possible and returns the output replayed
+static QList<QByteArray> replayOutput(const QString &fileName, QList<QVariantList> *resizes = nullptr)
+{
+    PtyReplay replay;
+    if (!replay.load(fileName)) {
+        return QList<QByteArray>();
+    }
+
+    QList<QByteArray> output;
+    QObject::connect(&replay, &PtyReplay::outputReplayed, [&output](const char *data, int length) {
+        output << QByteArray(data, length);
+    });
+    QSignalSpy resizeSpy(&replay, &PtyReplay::resizeReplayed);
+    QSignalSpy finishedSpy(&replay, &PtyReplay::finished);
+
+    replay.start(0);
+    if (!finishedSpy.wait(5000)) {
+        return QList<QByteArray>();
+    }
+
+    if (resizes != nullptr) {
+        *resizes = resizeSpy;
+    }
+    return output;
+}
+
+void PtyRecordingTest::testReplay()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + QStringLiteral("/recording");
+
+    {
+        PtyRecorder recorder;
+        QVERIFY(recorder.open(fileName, 80, 24));
+        recorder.recordOutput("hello", 5);
+        recorder.recordInput(QByteArray("ls\r"));
+        recorder.recordResize(100, 30);
+        recorder.recordOutput("world", 5);
+    }
+
+    QList<QVariantList> resizes;
+    const QList<QByteArray> output = replayOutput(fileName, &resizes);
+    QCOMPARE(output, QList<QByteArray>() << "hello" << "world");
+    QCOMPARE(resizes.count(), 2);
+    QCOMPARE(resizes[0], QVariantList() << 80 << 24);
+    QCOMPARE(resizes[1], QVariantList() << 100 << 30);
+}
+
+void PtyRecordingTest::testReplaySpeed()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + QStringLiteral("/recording");
+
+    {
+        PtyRecorder recorder;
+        QVERIFY(recorder.open(fileName, 80, 24));
+        recorder.recordOutput("before", 6);
+        QTest::qSleep(200);
+        recorder.recordOutput("after", 5);
+    }
+
+    PtyReplay replay;
+    QVERIFY(replay.load(fileName));
+    QCOMPARE(replay.duration(), qint64(-1));
+
+    QSignalSpy finishedSpy(&replay, &PtyReplay::finished);
+
+    replay.start(1);
+    QVERIFY(replay.isActive());
+    QVERIFY(finishedSpy.wait(5000));
+    QVERIFY(!replay.isActive());
+    QVERIFY(replay.duration() >= 200);
+
+    replay.start(4);
+    QVERIFY(finishedSpy.wait(5000));
+    QVERIFY(replay.duration() >= 50);
+}
+
+void PtyRecordingTest::testTruncatedRecording()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + QStringLiteral("/recording");
+
+    {
+        PtyRecorder recorder;
+        QVERIFY(recorder.open(fileName, 80, 24));
+        recorder.recordOutput("complete", 8);
+        recorder.recordOutput("cut short", 9);
+    }
+
+    QFile file(fileName);
+    QVERIFY(file.resize(file.size() - 4));
+
+    QCOMPARE(replayOutput(fileName), QList<QByteArray>() << "complete");
+}
+
+void PtyRecordingTest::testInvalidSize()
+{
+    QTemporaryDir dir;
+
+    const QList<QPair<int, int> > sizes = QList<QPair<int, int> >()
+                                          << qMakePair(PtyReplay::MAX_COLUMNS + 1, 24)
+                                          << qMakePair(80, PtyReplay::MAX_LINES + 1)
+                                          << qMakePair(-1, 24)
+                                          << qMakePair(80, 0);
+    for (int i = 0; i < sizes.count(); i++) {
+        const QString fileName = dir.path() + QStringLiteral("/recording%1").arg(i);
+        {
+            PtyRecorder recorder;
+            QVERIFY(recorder.open(fileName, 80, 24));
+            recorder.recordOutput("before", 6);
+            recorder.recordResize(sizes[i].first, sizes[i].second);
+            recorder.recordOutput("after", 5);
+        }
+
+        // replayed up to the invalid size
+        QList<QVariantList> resizes;
+        QCOMPARE(replayOutput(fileName, &resizes), QList<QByteArray>() << "before");
+        QCOMPARE(resizes.count(), 1);
+        QCOMPARE(resizes[0], QVariantList() << 80 << 24);
+    }
+
+    const QString fileName = dir.path() + QStringLiteral("/largest");
+    {
+        PtyRecorder recorder;
+        QVERIFY(recorder.open(fileName, PtyReplay::MAX_COLUMNS, PtyReplay::MAX_LINES));
+    }
+    QList<QVariantList> resizes;
+    replayOutput(fileName, &resizes);
+    QCOMPARE(resizes.count(), 1);
+    QCOMPARE(resizes[0], QVariantList() << PtyReplay::MAX_COLUMNS << PtyReplay::MAX_LINES);
+}
+
+void PtyRecordingTest::testInvalidRecording()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.path() + QStringLiteral("/recording");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a recording");
+    file.close();
+
+    PtyReplay replay;
+    QVERIFY(!replay.load(fileName));
+    QVERIFY(!replay.load(dir.path() + QStringLiteral("/missing")));
+}
+
+QTEST_GUILESS_MAIN(PtyRecordingTest)
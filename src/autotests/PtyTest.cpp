@@ -89,4 +89,79 @@ void PtyTest::testRunProgram()
     QCOMPARE(pty.foregroundProcessGroup(), pty.pid());
 }
 
+void PtyTest::testReceiveAllOutput()
+{
+    // two terminals flooded at the same time both receive all of their
+    // output, including what is left when the program finishes
+    const QString script = QStringLiteral("i=0; while [ $i -lt 5000 ]; do echo line$i; i=$((i+1)); done");
+    const QStringList arguments = QStringList() << QStringLiteral("sh") << QStringLiteral("-c") << script;
+
+    Pty first;
+    Pty second;
+    QByteArray firstOutput;
+    QByteArray secondOutput;
+    int finishedCount = 0;
+
+    connect(&first, &Konsole::Pty::receivedData, [&firstOutput](const char *buffer, int length) {
+        firstOutput.append(buffer, length);
+    });
+    connect(&second, &Konsole::Pty::receivedData, [&secondOutput](const char *buffer, int length) {
+        secondOutput.append(buffer, length);
+    });
+    connect(&first, static_cast<void(Pty::*)(int,QProcess::ExitStatus)>(&Konsole::Pty::finished),
+            [&finishedCount]() { finishedCount++; });
+    connect(&second, static_cast<void(Pty::*)(int,QProcess::ExitStatus)>(&Konsole::Pty::finished),
+            [&finishedCount]() { finishedCount++; });
+
+    QCOMPARE(first.start(QStringLiteral("sh"), arguments, QStringList()), 0);
+    QCOMPARE(second.start(QStringLiteral("sh"), arguments, QStringList()), 0);
+
+    QTRY_COMPARE_WITH_TIMEOUT(finishedCount, 2, 30000);
+
+    QVERIFY(firstOutput.contains("line0\r\n"));
+    QVERIFY(firstOutput.endsWith("line4999\r\n"));
+    QVERIFY(secondOutput.contains("line0\r\n"));
+    QVERIFY(secondOutput.endsWith("line4999\r\n"));
+}
+
+void PtyTest::testSendLargeInput()
+{
+    // input much larger than the teletype's buffers is written in chunks,
+    // while its echo continues to be read, and keeps its order with input
+    // sent afterwards
+    const int LINES = 20000;
+    QByteArray input;
+    for (int i = 0; i < LINES; i++) {
+        input += "input" + QByteArray::number(i) + '\n';
+    }
+
+    const QStringList arguments = QStringList() << QStringLiteral("wc") << QStringLiteral("-l");
+
+    Pty pty;
+    QByteArray output;
+    qint64 lastWritten = 0;
+    bool finished = false;
+
+    connect(&pty, &Konsole::Pty::receivedData, [&output](const char *buffer, int length) {
+        output.append(buffer, length);
+    });
+    connect(&pty, &Konsole::Pty::inputProgress, [&lastWritten](qint64 written, qint64) {
+        lastWritten = written;
+    });
+    connect(&pty, static_cast<void(Pty::*)(int,QProcess::ExitStatus)>(&Konsole::Pty::finished),
+            [&finished]() { finished = true; });
+
+    QCOMPARE(pty.start(QStringLiteral("wc"), arguments, QStringList()), 0);
+    pty.sendData(input);
+    QVERIFY(pty.pendingInputSize() > 0);
+    pty.sendEof();
+
+    QTRY_VERIFY_WITH_TIMEOUT(finished, 30000);
+
+    QCOMPARE(pty.pendingInputSize(), qint64(0));
+    QCOMPARE(lastWritten, qint64(input.size() + 1));
+    QVERIFY(output.contains("input19999\r\n"));
+    QVERIFY(output.endsWith(QByteArray::number(LINES) + "\r\n"));
+}
+
 QTEST_GUILESS_MAIN(PtyTest)
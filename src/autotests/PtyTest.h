@@ -39,6 +39,8 @@ private Q_SLOTS:
     void testWindowSize();
 
     void testRunProgram();
+    void testReceiveAllOutput();
+    void testSendLargeInput();
 };
 
 }
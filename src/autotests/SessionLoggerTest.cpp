@@ -0,0 +1,163 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "SessionLoggerTest.h"
+
+// System
+#include <sys/stat.h>
+
+// Qt
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTextCodec>
+
+// KDE
+#if HAVE_KARCHIVE
+#include <KCompressionDevice>
+#endif
+
+// Konsole
+#include "../SessionLogger.h"
+
+using namespace Konsole;
+
+static QByteArray readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+// returns the log without the line telling when it was started
+static QByteArray logText(const QByteArray &log)
+{
+    return log.mid(log.indexOf('\n') + 1);
+}
+
+void SessionLoggerTest::testRawOutput()
+{
+    QTemporaryDir dir;
+    const QString prefix = dir.path() + QStringLiteral("/konsole/logs/session");
+
+    // the usual umask, which leaves new files readable by everybody
+    const mode_t previousUmask = ::umask(022);
+    auto logger = new SessionLogger(prefix);
+    logger->start();
+    logger->log("hello\r\n", 7);
+    logger->log("\033[1mworld\033[0m", 13);
+    delete logger;
+    ::umask(previousUmask);
+
+    const QByteArray log = readFile(prefix + QStringLiteral(".001.log"));
+    QVERIFY(log.startsWith("Konsole output log started on "));
+    QCOMPARE(logText(log), QByteArray("hello\r\n\033[1mworld\033[0m"));
+
+    const QList<QByteArray> timing = readFile(prefix + QStringLiteral(".001.timing")).split('\n');
+    QCOMPARE(timing.count(), 3);
+    QVERIFY(timing[0].endsWith(" 7"));
+    QVERIFY(timing[1].endsWith(" 13"));
+    QVERIFY(timing[2].isEmpty());
+
+    const QFile::Permissions permissions = QFile::permissions(prefix + QStringLiteral(".001.log"));
+    QCOMPARE(permissions & (QFile::ReadGroup | QFile::ReadOther), QFile::Permissions());
+
+    // whatever the umask, only the log directory itself is private
+    const QFile::Permissions directoryPermissions = QFile::permissions(dir.path() + QStringLiteral("/konsole/logs"));
+    QCOMPARE(directoryPermissions & (QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner),
+             QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+    QCOMPARE(directoryPermissions & (QFile::ReadGroup | QFile::WriteGroup | QFile::ExeGroup
+                                     | QFile::ReadOther | QFile::WriteOther | QFile::ExeOther),
+             QFile::Permissions());
+    QVERIFY(QFileInfo(dir.path() + QStringLiteral("/konsole")).isDir());
+}
+
+void SessionLoggerTest::testTextOutput()
+{
+    QTemporaryDir dir;
+    const QString prefix = dir.path() + QStringLiteral("/session");
+
+    auto logger = new SessionLogger(prefix);
+    logger->setTextCodec(QTextCodec::codecForName("UTF-8"));
+    logger->start();
+    logger->log("\033]0;title\007a\033[3", 14);
+    // the escape sequence and the character continue in the next chunk
+    logger->log("1mb\xc3", 4);
+    logger->log("\xa4\r\n\033(Bc\t\033[K", 11);
+    delete logger;
+
+    QCOMPARE(logText(readFile(prefix + QStringLiteral(".001.log"))),
+             QByteArray("ab\xc3\xa4\nc\t"));
+}
+
+void SessionLoggerTest::testRotation()
+{
+    QTemporaryDir dir;
+    const QString prefix = dir.path() + QStringLiteral("/session");
+
+    auto logger = new SessionLogger(prefix);
+    logger->setMaxFileSize(10);
+    logger->start();
+    logger->log("first\n", 6);
+    logger->log("second\n", 7);
+    logger->log("third\n", 6);
+    delete logger;
+
+    QCOMPARE(logText(readFile(prefix + QStringLiteral(".001.log"))), QByteArray("first\n"));
+    QCOMPARE(logText(readFile(prefix + QStringLiteral(".002.log"))), QByteArray("second\n"));
+    QCOMPARE(logText(readFile(prefix + QStringLiteral(".003.log"))), QByteArray("third\n"));
+    QVERIFY(QFile::exists(prefix + QStringLiteral(".003.timing")));
+    QVERIFY(!QFile::exists(prefix + QStringLiteral(".004.log")));
+}
+
+void SessionLoggerTest::testCompression()
+{
+#if HAVE_KARCHIVE
+    QVERIFY(SessionLogger::compressionSupported());
+
+    QTemporaryDir dir;
+    const QString prefix = dir.path() + QStringLiteral("/session");
+
+    auto logger = new SessionLogger(prefix);
+    logger->setCompressed(true);
+    logger->start();
+    logger->log("compressed\n", 11);
+    delete logger;
+
+    QVERIFY(!QFile::exists(prefix + QStringLiteral(".001.log")));
+
+    KCompressionDevice log(prefix + QStringLiteral(".001.log.gz"), KCompressionDevice::GZip);
+    QVERIFY(log.open(QIODevice::ReadOnly));
+    QCOMPARE(logText(log.readAll()), QByteArray("compressed\n"));
+
+    KCompressionDevice timing(prefix + QStringLiteral(".001.timing.gz"), KCompressionDevice::GZip);
+    QVERIFY(timing.open(QIODevice::ReadOnly));
+    QVERIFY(timing.readAll().endsWith(" 11\n"));
+#else
+    QVERIFY(!SessionLogger::compressionSupported());
+    QSKIP("Built without KArchive");
+#endif
+}
+
+QTEST_GUILESS_MAIN(SessionLoggerTest)
@@ -0,0 +1,160 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "SessionPoolTest.h"
+
+// Qt
+#include <QDir>
+#include <QPointer>
+#include <qtest.h>
+
+// Konsole
+#include "../ProfileManager.h"
+#include "../Session.h"
+#include "../SessionPool.h"
+
+using namespace Konsole;
+
+// takeSession() restarts the delay, so wait instead of trying repeatedly
+static void waitForReplenish()
+{
+    QTest::qWait(SessionPool::REPLENISH_DELAY + 500);
+}
+
+void SessionPoolTest::initTestCase()
+{
+    _profile = Profile::Ptr(new Profile(ProfileManager::instance()->fallbackProfile()));
+    _profile->setProperty(Profile::Command, QStringLiteral("cat"));
+    _profile->setProperty(Profile::Arguments, QStringList() << QStringLiteral("cat"));
+    _profile->setProperty(Profile::Directory, QDir::homePath());
+}
+
+void SessionPoolTest::testTakeSession()
+{
+    SessionPool pool;
+
+    // nothing is started while the pool is disabled
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    waitForReplenish();
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+
+    pool.setEnabled(true);
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    waitForReplenish();
+
+    // the pooled session is only taken for the window it was started for,
+    // an empty directory stands for the profile's initial directory
+    QVERIFY(pool.takeSession(_profile, 2, QString()) == nullptr);
+    QPointer<Session> session = pool.takeSession(_profile, 1, QDir::homePath());
+    QVERIFY(session != nullptr);
+    QTRY_VERIFY(session->isRunning());
+    QCOMPARE(session->initialWorkingDirectory(), QDir::homePath());
+    QVERIFY(session->views().isEmpty());
+
+    session->close();
+    QTRY_VERIFY(session.isNull());
+}
+
+void SessionPoolTest::testReplenish()
+{
+    SessionPool pool;
+    pool.setEnabled(true);
+
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    waitForReplenish();
+
+    // taking a session starts the next one after a delay
+    QPointer<Session> first = pool.takeSession(_profile, 1, QString());
+    QVERIFY(first != nullptr);
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    waitForReplenish();
+
+    QPointer<Session> second = pool.takeSession(_profile, 1, QString());
+    QVERIFY(second != nullptr);
+    QVERIFY(second != first);
+    QTRY_VERIFY(second->isRunning());
+
+    first->close();
+    second->close();
+    QTRY_VERIFY(first.isNull() && second.isNull());
+}
+
+void SessionPoolTest::testDirectory()
+{
+    SessionPool pool;
+    pool.setEnabled(true);
+
+    const QString tempPath = QDir::cleanPath(QDir::tempPath());
+
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    waitForReplenish();
+
+    // the session started in the initial directory is not taken for a tab
+    // starting elsewhere, and is started again in that directory
+    QVERIFY(pool.takeSession(_profile, 1, tempPath) == nullptr);
+    waitForReplenish();
+
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    QPointer<Session> session = pool.takeSession(_profile, 1, tempPath + QLatin1Char('/'));
+    QVERIFY(session != nullptr);
+    QCOMPARE(session->initialWorkingDirectory(), tempPath);
+
+    session->close();
+    QTRY_VERIFY(session.isNull());
+}
+
+void SessionPoolTest::testRemoveWindow()
+{
+    SessionPool pool;
+    pool.setEnabled(true);
+
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    QVERIFY(pool.takeSession(_profile, 2, QString()) == nullptr);
+    waitForReplenish();
+
+    // the session kept for the window is closed along with it
+    pool.removeWindow(1);
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+
+    QPointer<Session> session = pool.takeSession(_profile, 2, QString());
+    QVERIFY(session != nullptr);
+
+    session->close();
+    QTRY_VERIFY(session.isNull());
+}
+
+void SessionPoolTest::testDisable()
+{
+    SessionPool pool;
+    pool.setEnabled(true);
+
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+    waitForReplenish();
+
+    // disabling the pool closes its sessions
+    pool.setEnabled(false);
+    QVERIFY(!pool.isEnabled());
+
+    pool.setEnabled(true);
+    QVERIFY(pool.takeSession(_profile, 1, QString()) == nullptr);
+}
+
+QTEST_GUILESS_MAIN(SessionPoolTest)
@@ -22,6 +22,10 @@
 
 #include "qtest.h"
 
+// Qt
+#include <QSignalSpy>
+#include <QTemporaryFile>
+
 // Konsole
 #include "../Session.h"
 #include "../Emulation.h"
@@ -56,4 +60,85 @@ void SessionTest::testEmulation()
     delete session;
 }
 
+void SessionTest::testHeadless()
+{
+    auto session = new Session();
+    session->setProgram(QStringLiteral("cat"));
+    session->setHistoryType(HistoryTypeBuffer(100));
+
+    // without a view, setting the size runs the session
+    session->setHeadlessSize(5, 20);
+    QCOMPARE(session->size(), QSize(20, 5));
+    QVERIFY(session->isRunning());
+
+    const QByteArray output("1\r\n2\r\n3\r\n4\r\n5\r\n6\r\n7");
+    session->emulation()->receiveData(output.constData(), output.length());
+
+    QCOMPARE(session->historyLineCount(), 2);
+    QCOMPARE(session->historyText(0, 1), QStringLiteral("1\n2\n"));
+    QCOMPARE(session->historyText(1, 10), QStringLiteral("2\n"));
+    QCOMPARE(session->screenText().trimmed(), QStringLiteral("3\n4\n5\n6\n7"));
+
+    delete session;
+}
+
+void SessionTest::testOutput()
+{
+    auto session = new Session();
+    session->setProgram(QStringLiteral("cat"));
+    session->setHistoryType(HistoryTypeBuffer(3));
+    session->setHeadlessSize(5, 20);
+
+    QStringList lines;
+    QByteArray output;
+    for (int i = 0; i < 10; i++) {
+        lines << QString::number(i);
+        output += QByteArray::number(i) + "\r\n";
+    }
+    session->emulation()->receiveData(output.constData(), output.length());
+
+    // lines 0 to 5 scrolled off the screen, the history kept 3 of them
+    QCOMPARE(session->outputSequence(), 10LL);
+    QCOMPARE(session->outputText(0, 9, Session::PlainTextOutput),
+             QStringList(lines.mid(3)).join(QLatin1Char('\n')) + QLatin1Char('\n'));
+    QCOMPARE(session->outputText(8, 8, Session::PlainTextOutput), QStringLiteral("8\n"));
+
+    // the sequence does not decrease when the cursor moves up
+    session->emulation()->receiveData("\x1b[H", 3);
+    QCOMPARE(session->outputSequence(), 10LL);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QDBusUnixFileDescriptor fd(file.handle());
+    QCOMPARE(session->writeOutput(7, Session::PlainTextOutput, fd), 10LL);
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.readAll(), QByteArray("7\n8\n9\n"));
+
+    delete session;
+}
+
+void SessionTest::testSessionGroup()
+{
+    auto master = new Session();
+    auto other = new Session();
+    auto group = new SessionGroup(nullptr);
+    group->addSession(master);
+    group->addSession(other);
+    group->setMasterStatus(master, true);
+    group->setMasterMode(SessionGroup::CopyInputToAll);
+
+    QSignalSpy sendDataSpy(other->emulation(), &Emulation::sendData);
+
+    // input is copied once per pass of the event loop
+    master->emulation()->sendString("a");
+    master->emulation()->sendString("b");
+    QCOMPARE(sendDataSpy.count(), 0);
+    QTRY_COMPARE(sendDataSpy.count(), 1);
+    QCOMPARE(sendDataSpy.first().first().toByteArray(), QByteArray("ab"));
+
+    delete group;
+    delete other;
+    delete master;
+}
+
 QTEST_MAIN(SessionTest)
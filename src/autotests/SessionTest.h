@@ -32,6 +32,9 @@ class SessionTest : public QObject
 private Q_SLOTS:
     void testNoProfile();
     void testEmulation();
+    void testHeadless();
+    void testOutput();
+    void testSessionGroup();
 
 private:
 };
@@ -0,0 +1,155 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "StartupCacheTest.h"
+
+// Unix
+#include <utime.h>
+
+// Qt
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Konsole
+#include "../StartupCache.h"
+
+using namespace Konsole;
+
+// files are only cached once they were not modified for a moment
+static const time_t OLD_TIME = 1500000000;
+
+static void writeFile(const QString &path, const QByteArray &contents)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+}
+
+static void setModificationTime(const QString &path, time_t time)
+{
+    struct utimbuf times;
+    times.actime = time;
+    times.modtime = time;
+    QCOMPARE(utime(QFile::encodeName(path).constData(), &times), 0);
+}
+
+void StartupCacheTest::testDirectoryListing()
+{
+    QTemporaryDir dataDir;
+    QTemporaryDir cacheDir;
+    const QString dir = dataDir.path();
+    const QString cacheFile = cacheDir.path() + QStringLiteral("/startup.cache");
+
+    writeFile(dir + QStringLiteral("/a.profile"), "[General]\n");
+    writeFile(dir + QStringLiteral("/a.keytab"), "keyboard \"a\"\n");
+    setModificationTime(dir, OLD_TIME);
+
+    {
+        StartupCache cache(cacheFile);
+        QCOMPARE(cache.entryList(dir, QStringLiteral("*.profile")), QStringList() << QStringLiteral("a.profile"));
+        QVERIFY(cache.save());
+    }
+
+    // an unchanged directory is not listed again
+    writeFile(dir + QStringLiteral("/b.profile"), "[General]\n");
+    setModificationTime(dir, OLD_TIME);
+    {
+        StartupCache cache(cacheFile);
+        QCOMPARE(cache.entryList(dir, QStringLiteral("*.profile")), QStringList() << QStringLiteral("a.profile"));
+        QCOMPARE(cache.entryList(dir, QStringLiteral("*.keytab")), QStringList() << QStringLiteral("a.keytab"));
+    }
+
+    // a changed one is
+    setModificationTime(dir, OLD_TIME + 1);
+    {
+        StartupCache cache(cacheFile);
+        QCOMPARE(cache.entryList(dir, QStringLiteral("*.profile")),
+                 QStringList() << QStringLiteral("a.profile") << QStringLiteral("b.profile"));
+    }
+}
+
+void StartupCacheTest::testFileData()
+{
+    QTemporaryDir dataDir;
+    QTemporaryDir cacheDir;
+    const QString path = dataDir.path() + QStringLiteral("/a.colorscheme");
+    const QString cacheFile = cacheDir.path() + QStringLiteral("/startup.cache");
+
+    writeFile(path, "[General]\nDescription=A\n");
+    setModificationTime(path, OLD_TIME);
+
+    {
+        StartupCache cache(cacheFile);
+        QVERIFY(cache.data(path).isEmpty());
+        cache.setData(path, QByteArrayLiteral("parsed"));
+        QCOMPARE(cache.data(path), QByteArrayLiteral("parsed"));
+    }
+
+    // the cache is saved when destroyed
+    {
+        StartupCache cache(cacheFile);
+        QCOMPARE(cache.data(path), QByteArrayLiteral("parsed"));
+    }
+
+    // a file with the same time but a different size changed
+    writeFile(path, "[General]\nDescription=AB\n");
+    setModificationTime(path, OLD_TIME);
+    {
+        StartupCache cache(cacheFile);
+        QVERIFY(cache.data(path).isEmpty());
+    }
+
+    // recently modified files are not cached
+    writeFile(path, "[General]\nDescription=A\n");
+    {
+        StartupCache cache(cacheFile);
+        cache.setData(path, QByteArrayLiteral("parsed"));
+        QVERIFY(cache.data(path).isEmpty());
+    }
+}
+
+void StartupCacheTest::testDamagedCacheFile()
+{
+    QTemporaryDir dataDir;
+    QTemporaryDir cacheDir;
+    const QString path = dataDir.path() + QStringLiteral("/a.keytab");
+    const QString cacheFile = cacheDir.path() + QStringLiteral("/startup.cache");
+
+    writeFile(path, "keyboard \"a\"\n");
+    setModificationTime(path, OLD_TIME);
+
+    {
+        StartupCache cache(cacheFile);
+        cache.setData(path, QByteArray(1000, 'x'));
+    }
+
+    // a truncated cache file is ignored
+    QFile file(cacheFile);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 10));
+    file.close();
+
+    StartupCache cache(cacheFile);
+    QVERIFY(cache.data(path).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(StartupCacheTest)
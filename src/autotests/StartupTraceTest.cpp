@@ -0,0 +1,157 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "StartupTraceTest.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTest>
+
+// Konsole
+#include "../StartupTrace.h"
+
+using namespace Konsole;
+
+static QString tracePath(const QTemporaryDir &dir)
+{
+    return dir.path() + QStringLiteral("/trace.json");
+}
+
+static QJsonArray readTraceEvents(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonArray();
+    }
+
+    return QJsonDocument::fromJson(file.readAll()).object()[QStringLiteral("traceEvents")].toArray();
+}
+
+void StartupTraceTest::initTestCase()
+{
+    // before the trace is used for the first time
+    QVERIFY(_traceDir.isValid());
+    qputenv("KONSOLE_STARTUP_TRACE", QFile::encodeName(tracePath(_traceDir)));
+}
+
+void StartupTraceTest::testWriteTrace()
+{
+    QVERIFY(StartupTrace::isEnabled());
+
+    // the shells started by Konsole must not trace their own Konsole
+    QVERIFY(!qEnvironmentVariableIsSet("KONSOLE_STARTUP_TRACE"));
+
+    StartupTrace::start();
+    {
+        StartupTrace::Phase outer("outer");
+        StartupTrace::Phase inner("inner");
+        StartupTrace::mark("event");
+    }
+    StartupTrace::finish("done");
+
+    // the trace is written once
+    QVERIFY(!StartupTrace::isEnabled());
+    StartupTrace::mark("later");
+    StartupTrace::finish("done again");
+
+    const QJsonArray events = readTraceEvents(tracePath(_traceDir));
+    QCOMPARE(events.count(), 7);
+
+    const char *names[] = { "start", "outer", "inner", "event", "inner", "outer", "done" };
+    const char *types[] = { "i", "B", "B", "i", "E", "E", "i" };
+    double lastTimestamp = 0;
+    for (int i = 0; i < events.count(); i++) {
+        const QJsonObject event = events[i].toObject();
+        QCOMPARE(event[QStringLiteral("name")].toString(), QLatin1String(names[i]));
+        QCOMPARE(event[QStringLiteral("ph")].toString(), QLatin1String(types[i]));
+        QCOMPARE(event[QStringLiteral("pid")].toDouble(), static_cast<double>(QCoreApplication::applicationPid()));
+
+        const double timestamp = event[QStringLiteral("ts")].toDouble();
+        QVERIFY(timestamp >= lastTimestamp);
+        lastTimestamp = timestamp;
+    }
+}
+
+void StartupTraceTest::benchmarkStartup()
+{
+    // starts Konsole without a display until its first prompt appeared,
+    // and reports how long the phases of the last start took
+    const QString konsole = QStringLiteral(KONSOLE_BINARY);
+    if (!QFileInfo(konsole).isExecutable()) {
+        QSKIP("The konsole executable is not available.");
+    }
+
+    QTemporaryDir homeDir;
+    QVERIFY(homeDir.isValid());
+    const QString path = tracePath(homeDir);
+
+    // with settings and caches of its own, kept between the starts
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("QT_QPA_PLATFORM"), QStringLiteral("offscreen"));
+    environment.insert(QStringLiteral("KONSOLE_STARTUP_TRACE"), path);
+    environment.insert(QStringLiteral("XDG_CONFIG_HOME"), homeDir.path() + QStringLiteral("/config"));
+    environment.insert(QStringLiteral("XDG_DATA_HOME"), homeDir.path() + QStringLiteral("/data"));
+    environment.insert(QStringLiteral("XDG_CACHE_HOME"), homeDir.path() + QStringLiteral("/cache"));
+
+    QJsonArray events;
+    QBENCHMARK {
+        QFile::remove(path);
+
+        QProcess process;
+        process.setProcessEnvironment(environment);
+        process.start(konsole, QStringList() << QStringLiteral("--separate"));
+        QVERIFY(process.waitForStarted());
+
+        QTRY_VERIFY_WITH_TIMEOUT(QFile::exists(path), 30000);
+
+        process.kill();
+        process.waitForFinished();
+
+        events = readTraceEvents(path);
+    }
+
+    QVERIFY(!events.isEmpty());
+
+    QHash<QString, double> beginnings;
+    foreach (const QJsonValue &value, events) {
+        const QJsonObject event = value.toObject();
+        const QString name = event[QStringLiteral("name")].toString();
+        const QString type = event[QStringLiteral("ph")].toString();
+        const double milliseconds = event[QStringLiteral("ts")].toDouble() / 1000;
+
+        if (type == QLatin1String("B")) {
+            beginnings[name] = milliseconds;
+        } else if (type == QLatin1String("E")) {
+            qDebug() << qPrintable(name) << "took" << milliseconds - beginnings.value(name) << "ms";
+        } else {
+            qDebug() << qPrintable(name) << "at" << milliseconds << "ms";
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(StartupTraceTest)
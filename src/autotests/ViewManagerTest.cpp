@@ -0,0 +1,207 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "ViewManagerTest.h"
+
+// Qt
+#include <QDir>
+#include <qtest.h>
+
+// KDE
+#include <KActionCollection>
+#include <KConfig>
+#include <KConfigGroup>
+
+// Konsole
+#include "../ProfileManager.h"
+#include "../Session.h"
+#include "../SessionManager.h"
+#include "../TerminalDisplay.h"
+#include "../ViewContainer.h"
+#include "../ViewManager.h"
+#include "../ViewSplitter.h"
+
+using namespace Konsole;
+
+// the number of restored tabs, of which the second one is active
+static const int TABS = 3;
+static const int ACTIVE_TAB = 1;
+
+static QString tabDirectory(const QTemporaryDir &directory, int tab)
+{
+    return directory.path() + QStringLiteral("/tab%1").arg(tab);
+}
+
+void ViewManagerTest::initTestCase()
+{
+    QVERIFY(_directory.isValid());
+    for (int tab = 0; tab < TABS; tab++) {
+        QVERIFY(QDir().mkdir(tabDirectory(_directory, tab)));
+    }
+
+    _profile = Profile::Ptr(new Profile(ProfileManager::instance()->fallbackProfile()));
+    _profile->setProperty(Profile::Command, QStringLiteral("cat"));
+    _profile->setProperty(Profile::Arguments, QStringList() << QStringLiteral("cat"));
+}
+
+void ViewManagerTest::init()
+{
+    _actionCollection = new KActionCollection(this);
+    _viewManager = new ViewManager(this, _actionCollection);
+
+    // as restored by the SessionManager
+    QList<int> ids;
+    for (int tab = 0; tab < TABS; tab++) {
+        Session *session = SessionManager::instance()->createSession(_profile);
+        session->setInitialWorkingDirectory(tabDirectory(_directory, tab));
+        _sessions << session;
+        ids << session->sessionId();
+    }
+
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup group(&config, "Window");
+    group.writeEntry("Sessions", ids);
+    group.writeEntry("Active", ACTIVE_TAB + 1);
+    _viewManager->restoreSessions(group);
+}
+
+void ViewManagerTest::cleanup()
+{
+    delete _viewManager->widget();
+    delete _viewManager;
+    delete _actionCollection;
+
+    foreach (const QPointer<Session> &session, _sessions) {
+        if (session != nullptr) {
+            session->close();
+        }
+    }
+    foreach (const QPointer<Session> &session, _sessions) {
+        QTRY_VERIFY(session.isNull());
+    }
+    _sessions.clear();
+}
+
+ViewContainer *ViewManagerTest::container() const
+{
+    return qobject_cast<ViewSplitter *>(_viewManager->widget())->activeContainer();
+}
+
+int ViewManagerTest::displayCount() const
+{
+    return _viewManager->widget()->findChildren<TerminalDisplay *>().count();
+}
+
+void ViewManagerTest::testRestoreStartsActiveTabOnly()
+{
+    QCOMPARE(container()->views().count(), TABS);
+    QCOMPARE(_viewManager->sessionCount(), TABS);
+    QCOMPARE(_viewManager->sessionList().count(), TABS);
+
+    // only the active tab gets a view and its session is started, also
+    // after the tabs which were active while restoring had their turn
+    QTest::qWait(100);
+    QCOMPARE(displayCount(), 1);
+    QCOMPARE(container()->views().indexOf(container()->activeView()), ACTIVE_TAB);
+    QVERIFY(qobject_cast<TerminalDisplay *>(container()->activeView()) != nullptr);
+
+    for (int tab = 0; tab < TABS; tab++) {
+        if (tab == ACTIVE_TAB) {
+            QTRY_VERIFY(_sessions[tab]->isRunning());
+        } else {
+            QVERIFY(!_sessions[tab]->isRunning());
+            QVERIFY(_sessions[tab]->views().isEmpty());
+        }
+    }
+}
+
+void ViewManagerTest::testActivateRestoredTab()
+{
+    const int tab = TABS - 1;
+    container()->setActiveView(container()->views().at(tab));
+
+    QTRY_VERIFY(qobject_cast<TerminalDisplay *>(container()->views().at(tab)) != nullptr);
+    QCOMPARE(container()->views().count(), TABS);
+    QCOMPARE(container()->activeView(), container()->views().at(tab));
+    QCOMPARE(_sessions[tab]->views().count(), 1);
+    QTRY_VERIFY(_sessions[tab]->isRunning());
+
+    QCOMPARE(displayCount(), 2);
+    QVERIFY(!_sessions[0]->isRunning());
+}
+
+void ViewManagerTest::testSendTextToRestoredTab()
+{
+    QWidget *active = container()->activeView();
+
+    // as sent over D-Bus, which starts the session in the background
+    _sessions[0]->sendText(QStringLiteral("input"));
+
+    QTRY_VERIFY(_sessions[0]->isRunning());
+    QVERIFY(qobject_cast<TerminalDisplay *>(container()->views().at(0)) != nullptr);
+    QCOMPARE(_sessions[0]->views().count(), 1);
+    QCOMPARE(container()->activeView(), active);
+    QVERIFY(!_sessions[TABS - 1]->isRunning());
+}
+
+void ViewManagerTest::testCloseRestoredTab()
+{
+    QWidget *placeholder = container()->views().at(0);
+    QVERIFY(qobject_cast<TerminalDisplay *>(placeholder) == nullptr);
+
+    auto tabbedContainer = qobject_cast<TabbedViewContainer *>(container());
+    QVERIFY(tabbedContainer != nullptr);
+    emit tabbedContainer->closeTab(tabbedContainer, placeholder);
+
+    // the session is closed without being started, and its tab removed
+    QTRY_VERIFY(_sessions[0].isNull());
+    QTRY_COMPARE(container()->views().count(), TABS - 1);
+    QCOMPARE(_viewManager->sessionList().count(), TABS - 1);
+    QCOMPARE(displayCount(), 1);
+}
+
+void ViewManagerTest::testSaveRestoredTabs()
+{
+    KConfig config(QString(), KConfig::SimpleConfig);
+    SessionManager::instance()->saveSessions(&config);
+
+    KConfigGroup windowGroup(&config, "Window");
+    _viewManager->saveSessions(windowGroup);
+
+    QList<int> ids;
+    foreach (Session *session, _sessions) {
+        ids << SessionManager::instance()->getRestoreId(session);
+    }
+    QCOMPARE(windowGroup.readEntry("Sessions", QList<int>()), ids);
+    QCOMPARE(windowGroup.readEntry("Active", 0), ACTIVE_TAB + 1);
+
+    // the tabs which were never shown keep the directory they were
+    // restored with
+    for (int tab = 0; tab < TABS; tab++) {
+        if (tab == ACTIVE_TAB) {
+            continue;
+        }
+        const KConfigGroup group(&config, QStringLiteral("Session%1").arg(ids[tab]));
+        QCOMPARE(group.readPathEntry("WorkingDir", QString()), tabDirectory(_directory, tab));
+    }
+}
+
+QTEST_MAIN(ViewManagerTest)
@@ -0,0 +1,68 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef VIEWMANAGERTEST_H
+#define VIEWMANAGERTEST_H
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTemporaryDir>
+
+// Konsole
+#include "../Profile.h"
+
+class KActionCollection;
+
+namespace Konsole
+{
+class Session;
+class ViewContainer;
+class ViewManager;
+
+class ViewManagerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testRestoreStartsActiveTabOnly();
+    void testActivateRestoredTab();
+    void testSendTextToRestoredTab();
+    void testCloseRestoredTab();
+    void testSaveRestoredTabs();
+
+private:
+    ViewContainer *container() const;
+    int displayCount() const;
+
+    Profile::Ptr _profile;
+    QTemporaryDir _directory;
+    KActionCollection *_actionCollection;
+    ViewManager *_viewManager;
+    QList<QPointer<Session> > _sessions;
+};
+
+}
+
+#endif // VIEWMANAGERTEST_H
@@ -8,5 +8,8 @@
 
 #cmakedefine01 HAVE_X11
 
+/* Defined if KArchive is available to compress output logs */
+#cmakedefine01 HAVE_KARCHIVE
+
 /* If defined, remove public access to dbus sendInput/runCommand */
 #cmakedefine REMOVE_SENDTEXT_RUNCOMMAND_DBUS_METHODS
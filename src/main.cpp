@@ -22,6 +22,7 @@
 #include "MainWindow.h"
 #include "config-konsole.h" //krazy:exclude=includes
 #include "KonsoleSettings.h"
+#include "StartupTrace.h"
 
 // OS specific
 #include <qplatformdefs.h>
@@ -38,6 +39,7 @@
 #include <kdbusservice.h>
 
 using Konsole::Application;
+using Konsole::StartupTrace;
 
 // fill the KAboutData structure with information about contributors to Konsole.
 void fillAboutData(KAboutData &aboutData);
@@ -65,6 +67,8 @@ void deleteQApplication()
 // ***
 extern "C" int Q_DECL_EXPORT kdemain(int argc, char *argv[])
 {
+    StartupTrace::start();
+
     // Check if any of the arguments makes it impossible to re-use an existing process.
     // We need to do this manually and before creating a QApplication, because
     // QApplication takes/removes the Qt specific arguments that are incompatible.
@@ -75,7 +79,9 @@ extern "C" int Q_DECL_EXPORT kdemain(int argc, char *argv[])
         needToDeleteQApplication = true;
     }
 
+    StartupTrace::beginPhase("QApplication");
     auto app = new QApplication(argc, argv);
+    StartupTrace::endPhase("QApplication");
 
     // enable high dpi support
     app->setAttribute(Qt::AA_UseHighDpiPixmaps, true);
@@ -130,7 +136,9 @@ extern "C" int Q_DECL_EXPORT kdemain(int argc, char *argv[])
     atexit(deleteQApplication);
     // Ensure that we only launch a new instance if we need to
     // If there is already an instance running, we will quit here
+    StartupTrace::beginPhase("KDBusService");
     KDBusService dbusService(startupOption | KDBusService::NoExitOnFailure);
+    StartupTrace::endPhase("KDBusService");
 
     needToDeleteQApplication = false;
 
@@ -165,7 +173,9 @@ extern "C" int Q_DECL_EXPORT kdemain(int argc, char *argv[])
 
     // If we reach this location, there was no existing copy of Konsole
     // running, so create a new instance.
+    StartupTrace::beginPhase("Application");
     Application konsoleApp(parser, customCommand);
+    StartupTrace::endPhase("Application");
 
     // The activateRequested() signal is emitted when a second instance
     // of Konsole is started.
@@ -178,7 +188,9 @@ extern "C" int Q_DECL_EXPORT kdemain(int argc, char *argv[])
         // Do not finish starting Konsole due to:
         // 1. An argument was given to just printed info
         // 2. An invalid situation ocurred
+        StartupTrace::beginPhase("Application::newInstance");
         const bool continueStarting = (konsoleApp.newInstance() != 0);
+        StartupTrace::endPhase("Application::newInstance");
         if (!continueStarting) {
             delete app;
             return 0;
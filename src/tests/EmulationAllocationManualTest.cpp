@@ -0,0 +1,115 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+// Own
+#include "EmulationAllocationManualTest.h"
+
+// Standard
+#include <atomic>
+#include <stdlib.h>
+
+// Qt
+#include <QTextCodec>
+#include <qtest.h>
+
+// Konsole
+#include "../Emulation.h"
+#include "../Session.h"
+
+using namespace Konsole;
+
+// counts the heap allocations made by the whole process while enabled,
+// by interposing glibc's allocation functions
+static std::atomic<bool> countAllocations(false);
+static std::atomic<qint64> allocationCount(0);
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size) __THROW
+{
+    if (countAllocations) {
+        allocationCount++;
+    }
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) __THROW
+{
+    if (countAllocations) {
+        allocationCount++;
+    }
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) __THROW
+{
+    if (countAllocations) {
+        allocationCount++;
+    }
+    return __libc_realloc(pointer, size);
+}
+}
+#endif
+
+void EmulationAllocationManualTest::testReceiveDataAllocations()
+{
+#if !defined(__GLIBC__)
+    QSKIP("Counting allocations needs glibc");
+#endif
+
+    // the output of EmulationTest::benchmarkReceiveData()
+    const int BLOCK_SIZE = 16 * 1024;
+    const int MEGABYTE = 1024 * 1024;
+
+    QByteArray line = QByteArrayLiteral("compiling src/Emulation.cpp ");
+    line += QStringLiteral("é€").toUtf8();
+    line += "\r\n";
+    QByteArray data;
+    while (data.size() < MEGABYTE) {
+        data += line;
+    }
+    data.truncate(MEGABYTE);
+
+    auto session = new Session();
+    session->setCodec(QTextCodec::codecForName("UTF-8"));
+    Emulation *emulation = session->emulation();
+
+    // once to fill the screen and history
+    for (int i = 0; i < data.size(); i += BLOCK_SIZE) {
+        emulation->receiveData(data.constData() + i, qMin(BLOCK_SIZE, data.size() - i));
+    }
+
+    allocationCount = 0;
+    countAllocations = true;
+    for (int i = 0; i < data.size(); i += BLOCK_SIZE) {
+        emulation->receiveData(data.constData() + i, qMin(BLOCK_SIZE, data.size() - i));
+    }
+    countAllocations = false;
+
+    qDebug() << "heap allocations per MiB of output:" << qint64(allocationCount);
+
+    delete session;
+}
+
+QTEST_MAIN(EmulationAllocationManualTest)
@@ -0,0 +1,46 @@
+/*
+    Copyright 2018 by The Konsole Developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301  USA.
+*/
+
+
+#ifndef EMULATIONALLOCATIONMANUALTEST_H
+#define EMULATIONALLOCATIONMANUALTEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+
+/**
+ * Counts the heap allocations made while decoding terminal output.
+ *
+ * This replaces the allocation functions of the C library for the whole
+ * process, which clashes with sanitizers and valgrind, so it is not run
+ * with the other tests and only built on request.
+ */
+class EmulationAllocationManualTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testReceiveDataAllocations();
+};
+
+}
+
+#endif // EMULATIONALLOCATIONMANUALTEST_H